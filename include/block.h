@@ -0,0 +1,112 @@
+#ifndef _BLOCK_H
+#define _BLOCK_H
+
+// Estado do bloco do jogador: a célula do nível (veja "level.h") onde está e
+// a sua orientação. Deitado, o bloco ocupa duas células, e (x, z) é a de
+// menor coordenada. Cada movimento é uma consulta à tabela
+// g_BlockTransitions, sem desvios, e o estado cabe em 32 bits
+// (Block_Pack()), de forma que um resolvedor ou simulador pode aplicar
+// milhões de movimentos por segundo. A posição e a rotação usadas para
+// desenhar o bloco são derivadas do estado (Block_GetCenter()).
+
+#include <cstdint>
+
+enum BlockOrientation
+{
+    BLOCK_STANDING = 0, // De pé, em (x, z)
+    BLOCK_LYING_Z  = 1, // Deitado paralelo ao eixo Z, em (x, z) e (x, z + 1)
+    BLOCK_LYING_X  = 2  // Deitado paralelo ao eixo X, em (x, z) e (x + 1, z)
+};
+
+// Direções de movimento, como vistas pela câmera inicial (setas do teclado).
+enum BlockDirection
+{
+    BLOCK_LEFT  = 0, // -X
+    BLOCK_RIGHT = 1, // +X
+    BLOCK_UP    = 2, // -Z
+    BLOCK_DOWN  = 3  // +Z
+};
+
+#define BLOCK_NUM_ORIENTATIONS 3
+#define BLOCK_NUM_DIRECTIONS   4
+
+struct BlockState
+{
+    int              x;
+    int              z;
+    BlockOrientation orientation;
+};
+
+// Resultado de um movimento: nova orientação e deslocamento da célula (x, z).
+struct BlockTransition
+{
+    BlockOrientation orientation;
+    int              dx;
+    int              dz;
+};
+
+// Tabela de movimentos, indexada por [orientação][direção]. Por exemplo, de
+// pé em (x, z), rolar para a direita deita o bloco sobre (x + 1, z) e
+// (x + 2, z).
+static constexpr BlockTransition g_BlockTransitions[BLOCK_NUM_ORIENTATIONS][BLOCK_NUM_DIRECTIONS] =
+{
+    // Esquerda                Direita                   Cima                      Baixo
+    { { BLOCK_LYING_X, -2, 0 }, { BLOCK_LYING_X, 1, 0 }, { BLOCK_LYING_Z, 0, -2 }, { BLOCK_LYING_Z, 0, 1 } }, // BLOCK_STANDING
+    { { BLOCK_LYING_Z, -1, 0 }, { BLOCK_LYING_Z, 1, 0 }, { BLOCK_STANDING, 0, -1 }, { BLOCK_STANDING, 0, 2 } }, // BLOCK_LYING_Z
+    { { BLOCK_STANDING, -1, 0 }, { BLOCK_STANDING, 2, 0 }, { BLOCK_LYING_X, 0, -1 }, { BLOCK_LYING_X, 0, 1 } }, // BLOCK_LYING_X
+};
+
+constexpr BlockState Block_Move(BlockState state, BlockDirection direction)
+{
+    return BlockState{ state.x + g_BlockTransitions[state.orientation][direction].dx,
+                       state.z + g_BlockTransitions[state.orientation][direction].dz,
+                       g_BlockTransitions[state.orientation][direction].orientation };
+}
+
+// Estado compactado: x e z com 15 bits cada (com sinal, para as posições
+// fora do nível de onde o bloco cai), e a orientação nos 2 bits mais altos.
+typedef uint32_t BlockPacked;
+
+constexpr BlockPacked Block_Pack(BlockState state)
+{
+    return ((uint32_t)state.x & 0x7FFFu) | (((uint32_t)state.z & 0x7FFFu) << 15) | ((uint32_t)state.orientation << 30);
+}
+
+constexpr BlockState Block_Unpack(BlockPacked packed)
+{
+    // Os deslocamentos aritméticos estendem o sinal dos campos de 15 bits.
+    return BlockState{ (int32_t)(packed << 17) >> 17,
+                       (int32_t)(packed << 2) >> 17,
+                       (BlockOrientation)(packed >> 30) };
+}
+
+static_assert(Block_Unpack(Block_Pack(BlockState{ -2, 4095, BLOCK_LYING_X })).x == -2 &&
+              Block_Unpack(Block_Pack(BlockState{ -2, 4095, BLOCK_LYING_X })).z == 4095,
+              "Block_Pack() must round-trip the cells of a 4096x4096 level");
+
+constexpr BlockPacked Block_MovePacked(BlockPacked packed, BlockDirection direction)
+{
+    return Block_Pack(Block_Move(Block_Unpack(packed), direction));
+}
+
+// Células sob o bloco. Retorna o número de células (1 ou 2).
+inline int Block_GetCells(BlockState state, int cells_x[2], int cells_z[2])
+{
+    cells_x[0] = state.x;
+    cells_z[0] = state.z;
+    cells_x[1] = state.x + (state.orientation == BLOCK_LYING_X);
+    cells_z[1] = state.z + (state.orientation == BLOCK_LYING_Z);
+    return state.orientation == BLOCK_STANDING ? 1 : 2;
+}
+
+// Translação que leva o bloco de pé na célula (0, 0) até o estado "state",
+// usada para desenhá-lo: o centro das células ocupadas em X e Z, e y = -0.5
+// deitado (o centro do bloco desce meia unidade).
+inline void Block_GetCenter(BlockState state, float* x, float* y, float* z)
+{
+    *x = (float)state.x + (state.orientation == BLOCK_LYING_X ? 0.5f : 0.0f);
+    *y = state.orientation == BLOCK_STANDING ? 0.0f : -0.5f;
+    *z = (float)state.z + (state.orientation == BLOCK_LYING_Z ? 0.5f : 0.0f);
+}
+
+#endif // _BLOCK_H
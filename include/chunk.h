@@ -0,0 +1,70 @@
+#ifndef _CHUNK_H
+#define _CHUNK_H
+
+// Pedaços ("chunks") de um nível: quadrados de CHUNK_SIZE x CHUNK_SIZE
+// células, com o chão em um mapa de bits próprio e a lista dos perigos que
+// passam por eles. O chunk (cx, cz) contém as células (x, z) com
+// x >> CHUNK_SHIFT == cx e z >> CHUNK_SHIFT == cz. São a unidade carregada e
+// descarregada pelo jogo conforme o jogador anda (veja "chunk_stream.h"), de
+// forma que níveis enormes não precisam ficar inteiros na GPU.
+//
+// Não dependem de OpenGL: fazem parte da biblioteca bode_core (veja
+// "world.h"). Veja "chunk.cpp".
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "hazard.h"
+#include "level.h"
+
+#define CHUNK_SHIFT 5
+#define CHUNK_SIZE  (1 << CHUNK_SHIFT) // Células por lado
+
+struct ChunkData
+{
+    int cx, cz;
+
+    // Bit x da linha z: célula (cx * CHUNK_SIZE + x, cz * CHUNK_SIZE + z).
+    // O chão fixo e as células dinâmicas (veja "level.h"), que não estão em
+    // "rows": o estado delas muda depois que o chunk é carregado.
+    uint32_t rows[CHUNK_SIZE];
+    uint32_t dynamic_rows[CHUNK_SIZE];
+    int      solid_count;
+    int      dynamic_count;
+
+    // Célula da saída, relativa ao chunk, ou -1 se a saída não está nele.
+    int exit_x, exit_z;
+
+    // Perigos (índices da HazardTable) que atingem alguma célula do chunk.
+    std::vector<int> hazards;
+};
+
+// Preenche "data" com o chunk (cx, cz). Chamada pelas threads de
+// carregamento, possivelmente ao mesmo tempo para chunks diferentes.
+typedef std::function<void(int cx, int cz, ChunkData* data)> ChunkSource;
+
+// Chunk (cx, cz) do nível "level". Os perigos de "hazards" (que pode ser NULL)
+// entram na lista se algum retângulo da tabela, em qualquer tick, encostar no
+// chunk. Chunks fora do nível ficam vazios. Lê só o chão fixo e a máscara das
+// células dinâmicas, que não mudam: pode ser chamada enquanto a thread
+// principal chama Level_SetTile().
+void Chunk_FromLevel(const Level* level, const HazardTable* hazards, int cx, int cz, ChunkData* data);
+
+// Retorna true se a célula (x, z), relativa ao chunk, tem chão fixo.
+inline bool Chunk_IsSolid(const ChunkData* data, int x, int z)
+{
+    if ((unsigned int)x >= CHUNK_SIZE || (unsigned int)z >= CHUNK_SIZE)
+        return false;
+    return (data->rows[z] >> x) & 1;
+}
+
+// Retorna true se a célula (x, z), relativa ao chunk, é dinâmica.
+inline bool Chunk_IsDynamic(const ChunkData* data, int x, int z)
+{
+    if ((unsigned int)x >= CHUNK_SIZE || (unsigned int)z >= CHUNK_SIZE)
+        return false;
+    return (data->dynamic_rows[z] >> x) & 1;
+}
+
+#endif // _CHUNK_H
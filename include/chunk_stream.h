@@ -0,0 +1,81 @@
+#ifndef _CHUNK_STREAM_H
+#define _CHUNK_STREAM_H
+
+// Carregamento contínuo ("streaming") do chão em chunks (veja "chunk.h").
+//
+// A cada quadro, ChunkStream_Update() recebe a célula do jogador e pede os
+// chunks a até "load_radius" chunks de distância, do mais próximo para o
+// mais distante. Threads de carregamento próprias obtêm os dados de cada
+// chunk da fonte (ChunkSource) e montam a sua malha: uma única malha por
+// chunk, com uma caixa por célula com chão e sem as faces laterais escondidas
+// entre células vizinhas. A thread principal só envia as malhas prontas para
+// a GPU (no máximo CHUNK_STREAM_UPLOADS_PER_FRAME por quadro) e descarta os
+// chunks mais distantes quando a memória passa do limite. Assim a memória e
+// o custo por quadro dependem do raio e do limite, e não do tamanho do
+// nível.
+//
+// As células dinâmicas (veja "level.h") mudam pela ChunkStream_SetTile(), que
+// só reescreve na GPU as posições da caixa da célula, sem remontar a malha do
+// chunk. Veja "chunk_stream.cpp".
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "chunk.h"
+#include "renderer.h"
+
+// Malhas enviadas para a GPU por quadro, no máximo.
+#define CHUNK_STREAM_UPLOADS_PER_FRAME 4
+
+// Threads de carregamento.
+#define CHUNK_STREAM_LOADER_THREADS 2
+
+// Retorna true se a célula dinâmica (x, z), em coordenadas globais, tem chão
+// agora. Chamada na thread principal, quando um chunk é enviado para a GPU.
+typedef std::function<bool(int x, int z)> ChunkTileState;
+
+struct ChunkStreamStats
+{
+    unsigned int resident_chunks; // Chunks carregados
+    unsigned int pending_chunks;  // Chunks pedidos e ainda não carregados
+    size_t       resident_bytes;  // Memória dos chunks carregados (malhas e dados)
+};
+
+// Começa a carregar chunks de "source", com até "memory_budget" bytes de
+// chunks carregados, e o estado das células dinâmicas de "tile_state". Cria
+// as threads de carregamento.
+void ChunkStream_Init(const ChunkSource& source, const ChunkTileState& tile_state, size_t memory_budget, int load_radius);
+
+// Termina as threads de carregamento e libera todos os chunks. Deve ser
+// chamada antes de destruir o contexto OpenGL e a fonte.
+void ChunkStream_Terminate();
+
+// Atualiza os chunks carregados para o jogador na célula (x, z). Chamada uma
+// vez por quadro, na thread do contexto OpenGL.
+void ChunkStream_Update(int x, int z);
+
+// Coloca ou retira o chão da célula dinâmica (x, z). A malha do chunk é
+// atualizada no próximo ChunkStream_Update(), com uma escrita por grupo de
+// células vizinhas na malha. Chunks não carregados são ignorados: consultam
+// o estado atual quando carregam.
+void ChunkStream_SetTile(int x, int z, bool solid);
+
+// Adiciona à lista um pedido de desenho (opaco e estático) para cada chunk
+// carregado com chão, com a textura "texture".
+void ChunkStream_AppendDrawItems(std::vector<DrawItem>* items, GLuint texture);
+
+// Retorna true se a célula (x, z) tem chão e o seu chunk está carregado.
+bool ChunkStream_IsSolid(int x, int z);
+
+// Retorna true se o perigo "hazard" passa por algum chunk carregado (veja
+// ChunkData::hazards); perigos longe do jogador não precisam ser desenhados.
+bool ChunkStream_IsHazardResident(int hazard);
+
+// Retorna true se há chunks pedidos ainda não carregados: a tela pode mudar
+// sem que nada mais mude (veja "idle.h").
+bool ChunkStream_IsLoading();
+
+ChunkStreamStats ChunkStream_GetStats();
+
+#endif // _CHUNK_STREAM_H
@@ -2,15 +2,29 @@
 #define COLLISIONS_H
 #include <cstdlib>
 
-extern int block_position;
-extern float g_PositionX;
-extern float g_PositionZ;
-extern float g_PositionY;
-extern float g_sphere_position_x;
-extern float g_sphere_position_z;
-
-bool plane_collision();
-bool sphere_collision();
-bool victory_cube_collision();
+#include "block.h"
+#include "level.h"
+
+// Regras de colisão do jogo. Não dependem de estado global: fazem parte da
+// biblioteca bode_core (veja "world.h").
+
+// O bloco "block" caiu do nível (alguma célula sob ele não tem chão).
+bool plane_collision(const Level* level, BlockState block);
+
+// Raio da esfera vermelha, para o qual as margens de sphere_collision()
+// foram ajustadas.
+#define COLLISION_SPHERE_RADIUS 0.38f
+
+// O bloco "block" encostou na esfera, cujo centro está em (sphere_x, *, sphere_z).
+bool sphere_collision(BlockState block, float sphere_x, float sphere_z);
+
+// O bloco "block" encostou em um perigo de raio "radius" com centro em
+// (x, *, z): as margens de sphere_collision(), aumentadas (ou diminuídas) em
+// radius - COLLISION_SPHERE_RADIUS. Com o raio da esfera, é a própria
+// sphere_collision().
+bool hazard_collision(BlockState block, float x, float z, float radius);
+
+// O bloco "block" está de pé sobre a saída.
+bool victory_cube_collision(const Level* level, BlockState block);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef _CULLING_H
+#define _CULLING_H
+
+#include <cstddef>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+// Descarte (culling) de objetos fora do campo de visão da câmera. Veja
+// "culling.cpp".
+
+// Os seis planos que delimitam o volume de visualização (frustum), em
+// coordenadas globais. Cada plano (a, b, c, d) é normalizado, com a normal
+// (a, b, c) apontando para DENTRO do frustum: um ponto p está do lado de
+// dentro se a*p.x + b*p.y + c*p.z + d >= 0.
+struct Frustum
+{
+    glm::vec4 planes[6]; // left, right, bottom, top, near, far
+};
+
+// Extrai os planos do frustum da matriz projection * view.
+Frustum Culling_ExtractFrustum(const glm::mat4& projection_view);
+
+// Transforma os planos do frustum para o sistema de coordenadas local de um
+// objeto com matriz de modelagem "model". Como a transformação é afim, testar
+// uma esfera em coordenadas locais contra o frustum transformado é
+// equivalente a testar a sua imagem em coordenadas globais, mesmo com escalas
+// não uniformes.
+Frustum Culling_TransformFrustum(const Frustum& frustum, const glm::mat4& model);
+
+// Testa "count" esferas contra o frustum, quatro por vez com instruções SIMD
+// (SSE2) quando disponíveis. As esferas são dadas como estrutura de arrays
+// (centros x, y, z e raios). Escreve visible[i] = 1 se a esfera i intercepta o
+// frustum, e 0 caso contrário. Retorna o número de esferas visíveis.
+size_t Culling_TestSpheres(const Frustum& frustum,
+                           const float* x, const float* y, const float* z, const float* radius,
+                           size_t count, unsigned char* visible);
+
+// Descarte por cone de normais ("backface culling" de grupos de triângulos).
+// Cada grupo é descrito por uma esfera envolvente (x, y, z, radius) e por um
+// cone que contém as normais de todos os seus triângulos: eixo (axis_x,
+// axis_y, axis_z) e "cutoff" = seno do semiângulo de abertura do cone (1.0 se
+// o cone for degenerado, o que nunca descarta). Se nenhum triângulo do grupo
+// pode estar de frente para a câmera em "camera_position", visible[i] recebe
+// 0; caso contrário, visible[i] não é alterado. Todos os dados devem estar no
+// mesmo sistema de coordenadas. Retorna o número de visible[i] != 0.
+size_t Culling_TestCones(const glm::vec3& camera_position,
+                         const float* x, const float* y, const float* z, const float* radius,
+                         const float* axis_x, const float* axis_y, const float* axis_z, const float* cutoff,
+                         size_t count, unsigned char* visible);
+
+#endif // _CULLING_H
@@ -0,0 +1,41 @@
+#ifndef _DYNAMIC_RESOLUTION_H
+#define _DYNAMIC_RESOLUTION_H
+
+// Resolução dinâmica: a cena 3D é renderizada em texturas fora da tela, com
+// uma fração da resolução da janela ajustada automaticamente a partir do
+// tempo de GPU medido, e depois ampliada para a janela. As texturas, com o
+// tamanho da janela, são do grafo de renderização. Veja
+// "dynamic_resolution.cpp".
+
+// Cria as consultas (queries) de tempo de GPU. Deve ser chamada após a
+// criação do contexto OpenGL.
+void DynamicResolution_Init();
+
+// Informa o novo tamanho da janela, em pixels. Pode ser chamada de
+// FramebufferSizeCallback() a qualquer momento.
+void DynamicResolution_Resize(int width, int height);
+
+// Ajusta o viewport do framebuffer atual (fora da tela, com o tamanho da
+// janela) para a resolução atual, e inicia a medição do tempo de GPU. Deve
+// ser chamada antes de limpar o framebuffer e desenhar a cena.
+void DynamicResolution_BeginScene();
+
+// Ajusta o viewport do framebuffer atual para a região da cena definida pelo
+// último DynamicResolution_BeginScene(), para passos que desenham sobre a
+// cena.
+void DynamicResolution_SetViewport();
+
+// Termina a medição. Atualiza a escala de resolução a cada poucos quadros.
+void DynamicResolution_EndScene();
+
+// Amplia a cena do último DynamicResolution_BeginScene(), no
+// GL_READ_FRAMEBUFFER atual, para todo o GL_DRAW_FRAMEBUFFER atual.
+void DynamicResolution_Upscale();
+
+// Escala atual da resolução (fração da largura e da altura da janela).
+float DynamicResolution_GetScale();
+
+// Tempo médio de GPU da cena, em milissegundos, das últimas medições.
+float DynamicResolution_GetGpuMilliseconds();
+
+#endif // _DYNAMIC_RESOLUTION_H
@@ -0,0 +1,59 @@
+#ifndef _GENERATOR_H
+#define _GENERATOR_H
+
+// Gerador de níveis: sorteia, a partir de uma semente, o chão, o início e a
+// saída de um nível; resolve cada candidato (veja "solver.h") e lhe dá uma
+// nota. Os candidatos são independentes, então são gerados e avaliados em
+// paralelo pelas threads de "thread_pool.h", um por tarefa. Faz parte da
+// biblioteca bode_core (veja "world.h"); o alvo "bode_generator" do projeto
+// grava os níveis aceitos em arquivos (veja "generator_tool.cpp"). Veja
+// "generator.cpp".
+
+#include <vector>
+
+#include "level.h"
+
+struct GeneratorParams
+{
+    int   width, depth;        // Tamanho do nível, em células (no mínimo 4 por 4)
+    int   walk_length;         // Movimentos do passeio aleatório que abre o caminho
+    float extra_floor;         // Fração das células restantes com chão extra (becos e atalhos)
+    int   min_solution_length; // Candidatos com solução mais curta são descartados
+};
+
+struct GeneratorScore
+{
+    int   solution_length;  // Movimentos da menor solução
+    int   reachable_states; // Estados do bloco alcançáveis a partir do início
+    float branching_factor; // Média de movimentos válidos por estado alcançável
+    int   dead_ends;        // Estados alcançáveis com um único movimento válido
+    float difficulty;       // Nota final; veja Generator_Score()
+};
+
+struct GeneratedLevel
+{
+    unsigned int   seed;
+    Level          level;
+    GeneratorScore score;
+};
+
+// Parâmetros usados pelo gerador do jogo.
+GeneratorParams Generator_DefaultParams();
+
+// Sorteia em "level" um nível a partir da semente "seed". O mesmo par
+// (params, seed) sempre gera o mesmo nível. Retorna false se o nível não
+// pode ser carregado (veja Level_Load()).
+bool Generator_Sample(Level* level, const GeneratorParams& params, unsigned int seed);
+
+// Resolve "level" e calcula a sua nota. Retorna false se o nível não tem
+// solução. Roda na thread atual.
+bool Generator_Score(const Level* level, GeneratorScore* score);
+
+// Gera e avalia os candidatos de sementes first_seed, first_seed + 1, ...,
+// first_seed + count - 1 em paralelo, e guarda em "accepted" os que têm
+// solução com pelo menos params.min_solution_length movimentos, em ordem de
+// semente. Candidatos que não podem ser carregados são descartados. O
+// conjunto de threads não pode estar em uso.
+void Generator_Run(const GeneratorParams& params, unsigned int first_seed, size_t count, std::vector<GeneratedLevel>* accepted);
+
+#endif // _GENERATOR_H
@@ -0,0 +1,40 @@
+#ifndef _GL_DEBUG_H
+#define _GL_DEBUG_H
+
+// Mensagens de depuração OpenGL (GL_KHR_debug, OpenGL 4.3): em vez de
+// consultar glGetError() após cada chamada, o que obriga o driver a
+// sincronizar, o driver nos entrega os erros e avisos através de uma função
+// de callback, que pode ser chamada de outras threads. As mensagens são
+// guardadas em um anel sem travas e impressas no terminal por
+// GLDebug_Flush(), uma vez por quadro, junto com o nome do passo de
+// renderização (grupo de depuração) em que ocorreram. Veja "gl_debug.cpp".
+//
+// Nomes de objetos (GLDebug_Label()) e grupos (GLDebug_PushGroup()) também
+// aparecem em ferramentas de captura, como o RenderDoc.
+//
+// Sem GL_KHR_debug, todas as funções abaixo não fazem nada.
+
+#include "gl_extensions.h" // GL_PROGRAM, GL_BUFFER, ...
+
+// Ativa as mensagens de depuração, se disponíveis. Compilado com NDEBUG, só
+// os nomes e grupos são ativados: o driver não valida nada por nós. Deve ser
+// chamada após GLExtensions_Load().
+void GLDebug_Init();
+
+// Retorna true se GL_KHR_debug está disponível.
+bool GLDebug_IsSupported();
+
+// Imprime no terminal as mensagens recebidas desde a última chamada. Deve
+// ser chamada pela thread principal.
+void GLDebug_Flush();
+
+// Dá o nome "label" ao objeto "name" do tipo "identifier" (GL_TEXTURE,
+// GL_FRAMEBUFFER, GL_PROGRAM, GL_BUFFER, ...).
+void GLDebug_Label(GLenum identifier, GLuint name, const char* label);
+
+// Abre e fecha um grupo de depuração. "name" deve ser uma cadeia constante,
+// pois é guardada para identificar as mensagens recebidas dentro do grupo.
+void GLDebug_PushGroup(const char* name);
+void GLDebug_PopGroup();
+
+#endif // _GL_DEBUG_H
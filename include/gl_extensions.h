@@ -0,0 +1,82 @@
+#ifndef _GL_EXTENSIONS_H
+#define _GL_EXTENSIONS_H
+
+// A biblioteca GLAD incluída em "include/glad/" foi gerada somente para
+// OpenGL 3.3. Aqui declaramos as constantes e funções de versões posteriores
+// (ou de extensões) que são usadas opcionalmente pelo programa. Os ponteiros
+// de função são carregados por GLExtensions_Load(), após a criação do
+// contexto, e ficam NULL caso o driver não os ofereça.
+
+#include <glad/glad.h>
+
+// GL_ARB_multi_draw_indirect / GL_ARB_shader_storage_buffer_object (OpenGL 4.3)
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+
+typedef void (APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void *indirect, GLsizei drawcount, GLsizei stride);
+extern PFNGLMULTIDRAWELEMENTSINDIRECTPROC glad_glMultiDrawElementsIndirect;
+#define glMultiDrawElementsIndirect glad_glMultiDrawElementsIndirect
+
+// GL_KHR_debug (OpenGL 4.3). Veja "gl_debug.h".
+#ifndef GL_DEBUG_OUTPUT
+#define GL_DEBUG_OUTPUT                 0x92E0
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS     0x8242
+#define GL_CONTEXT_FLAG_DEBUG_BIT       0x00000002
+#define GL_MAX_LABEL_LENGTH             0x82E8
+#define GL_DEBUG_SOURCE_API             0x8246
+#define GL_DEBUG_SOURCE_WINDOW_SYSTEM   0x8247
+#define GL_DEBUG_SOURCE_SHADER_COMPILER 0x8248
+#define GL_DEBUG_SOURCE_THIRD_PARTY     0x8249
+#define GL_DEBUG_SOURCE_APPLICATION     0x824A
+#define GL_DEBUG_SOURCE_OTHER           0x824B
+#define GL_DEBUG_TYPE_ERROR             0x824C
+#define GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR 0x824D
+#define GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR  0x824E
+#define GL_DEBUG_TYPE_PORTABILITY       0x824F
+#define GL_DEBUG_TYPE_PERFORMANCE       0x8250
+#define GL_DEBUG_TYPE_OTHER             0x8251
+#define GL_DEBUG_TYPE_MARKER            0x8268
+#define GL_DEBUG_TYPE_PUSH_GROUP        0x8269
+#define GL_DEBUG_TYPE_POP_GROUP         0x826A
+#define GL_DEBUG_SEVERITY_HIGH          0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM        0x9147
+#define GL_DEBUG_SEVERITY_LOW           0x9148
+#define GL_DEBUG_SEVERITY_NOTIFICATION  0x826B
+#define GL_BUFFER                       0x82E0
+#define GL_SHADER                       0x82E1
+#define GL_PROGRAM                      0x82E2
+#define GL_QUERY                        0x82E3
+#define GL_SAMPLER                      0x82E6
+#endif
+
+typedef void (APIENTRYP PFNGLDEBUGMESSAGECALLBACKPROC)(GLDEBUGPROC callback, const void *userParam);
+typedef void (APIENTRYP PFNGLDEBUGMESSAGECONTROLPROC)(GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint *ids, GLboolean enabled);
+typedef void (APIENTRYP PFNGLOBJECTLABELPROC)(GLenum identifier, GLuint name, GLsizei length, const GLchar *label);
+typedef void (APIENTRYP PFNGLPUSHDEBUGGROUPPROC)(GLenum source, GLuint id, GLsizei length, const GLchar *message);
+typedef void (APIENTRYP PFNGLPOPDEBUGGROUPPROC)(void);
+extern PFNGLDEBUGMESSAGECALLBACKPROC glad_glDebugMessageCallback;
+extern PFNGLDEBUGMESSAGECONTROLPROC  glad_glDebugMessageControl;
+extern PFNGLOBJECTLABELPROC          glad_glObjectLabel;
+extern PFNGLPUSHDEBUGGROUPPROC       glad_glPushDebugGroup;
+extern PFNGLPOPDEBUGGROUPPROC        glad_glPopDebugGroup;
+#define glDebugMessageCallback glad_glDebugMessageCallback
+#define glDebugMessageControl  glad_glDebugMessageControl
+#define glObjectLabel          glad_glObjectLabel
+#define glPushDebugGroup       glad_glPushDebugGroup
+#define glPopDebugGroup        glad_glPopDebugGroup
+
+// Carrega as funções acima. Deve ser chamada após gladLoadGLLoader().
+void GLExtensions_Load();
+
+// Retorna true se o contexto atual oferece a extensão "name" (por exemplo
+// "GL_ARB_multi_draw_indirect").
+bool GLExtensions_IsSupported(const char* name);
+
+// Retorna true se a versão do contexto atual é no mínimo major.minor.
+bool GLExtensions_VersionAtLeast(int major, int minor);
+
+#endif // _GL_EXTENSIONS_H
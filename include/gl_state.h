@@ -0,0 +1,91 @@
+#ifndef _GL_STATE_H
+#define _GL_STATE_H
+
+// Cache do estado OpenGL: guarda uma cópia do programa, do VAO, das texturas
+// de cada unidade, dos buffers, do blending e do teste de profundidade
+// atuais, e descarta as chamadas que não mudariam nada (por exemplo,
+// glBindTexture() da mesma textura para blocos consecutivos). Veja
+// "gl_state.cpp".
+//
+// As funções abaixo substituem, através das macros ao final deste arquivo,
+// as funções OpenGL de mesmo nome em todo arquivo que inclui este cabeçalho.
+// Todo arquivo que altera este estado deve incluí-lo; caso contrário, a
+// cópia fica desatualizada (veja GLState_Invalidate()).
+
+#include <glad/glad.h>
+
+void GLState_UseProgram(GLuint program);
+void GLState_BindVertexArray(GLuint array);
+void GLState_ActiveTexture(GLenum texture);
+void GLState_BindTexture(GLenum target, GLuint texture);
+void GLState_BindBuffer(GLenum target, GLuint buffer);
+void GLState_BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+void GLState_Enable(GLenum cap);
+void GLState_Disable(GLenum cap);
+void GLState_BlendFunc(GLenum sfactor, GLenum dfactor);
+void GLState_BlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha);
+void GLState_DepthFunc(GLenum func);
+void GLState_DepthMask(GLboolean flag);
+
+// Objetos apagados deixam de estar ligados; seus nomes podem ser reutilizados
+// por novos objetos, que então precisam ser ligados de fato.
+void GLState_DeleteTextures(GLsizei n, const GLuint* textures);
+void GLState_DeleteBuffers(GLsizei n, const GLuint* buffers);
+void GLState_DeleteVertexArrays(GLsizei n, const GLuint* arrays);
+
+// Esquece o estado guardado: a próxima chamada de cada tipo é sempre
+// executada. Para quando o estado é alterado por código que não passa por
+// este cache.
+void GLState_Invalidate();
+
+// Número de chamadas executadas e descartadas pelo cache.
+struct GLStateStats
+{
+    unsigned long issued;
+    unsigned long elided;
+};
+
+// Termina a contagem do quadro atual, que passa a ser retornada por
+// GLState_GetFrameStats(), e começa a do próximo.
+void GLState_EndFrame();
+
+// Contagem do último quadro terminado por GLState_EndFrame().
+GLStateStats GLState_GetFrameStats();
+
+// "gl_state.cpp" chama as funções originais.
+#ifndef GL_STATE_IMPLEMENTATION
+
+#undef  glUseProgram
+#define glUseProgram GLState_UseProgram
+#undef  glBindVertexArray
+#define glBindVertexArray GLState_BindVertexArray
+#undef  glActiveTexture
+#define glActiveTexture GLState_ActiveTexture
+#undef  glBindTexture
+#define glBindTexture GLState_BindTexture
+#undef  glBindBuffer
+#define glBindBuffer GLState_BindBuffer
+#undef  glBindBufferBase
+#define glBindBufferBase GLState_BindBufferBase
+#undef  glEnable
+#define glEnable GLState_Enable
+#undef  glDisable
+#define glDisable GLState_Disable
+#undef  glBlendFunc
+#define glBlendFunc GLState_BlendFunc
+#undef  glBlendFuncSeparate
+#define glBlendFuncSeparate GLState_BlendFuncSeparate
+#undef  glDepthFunc
+#define glDepthFunc GLState_DepthFunc
+#undef  glDepthMask
+#define glDepthMask GLState_DepthMask
+#undef  glDeleteTextures
+#define glDeleteTextures GLState_DeleteTextures
+#undef  glDeleteBuffers
+#define glDeleteBuffers GLState_DeleteBuffers
+#undef  glDeleteVertexArrays
+#define glDeleteVertexArrays GLState_DeleteVertexArrays
+
+#endif // GL_STATE_IMPLEMENTATION
+
+#endif // _GL_STATE_H
@@ -0,0 +1,157 @@
+#ifndef _HAZARD_H
+#define _HAZARD_H
+
+// Perigos: objetos que se movem sozinhos, em um caminho periódico, e
+// derrubam o jogador se encostarem nele (no nível do jogo, só a esfera
+// vermelha).
+//
+// Os perigos de um mundo formam um HazardSet, guardado como estrutura de
+// arrays (centros, raios, caminhos e movimento de cada um). A posição de um
+// perigo é função só do tempo, de forma que HazardSet_Update() calcula todas
+// de uma vez, com Path_EvaluateMany() (veja "path.h"). Um hash espacial
+// uniforme das células dos centros, atualizado só para os perigos que trocam
+// de célula, permite testar o bloco contra os perigos próximos a ele, com
+// custo que não depende do número de perigos.
+//
+// Como o movimento é determinístico e periódico, ele é pré-calculado em uma
+// tabela de ocupação: o período é dividido em "ticks" de mesma duração e,
+// para cada tick e cada perigo, a tabela guarda os estados do bloco (veja
+// "block.h") atingidos em algum instante do tick. Um resolvedor (veja
+// Solver_SolveTimed() em "solver.h") pode então buscar sobre pares
+// (estado, tick) sem simular quadro a quadro, e validar níveis com muitos
+// perigos ou dar dicas que levam o tempo em conta.
+//
+// O jogo em si (World::step()) continua testando a posição exata dos perigos
+// a cada passo; a tabela é conservadora (um estado atingido em qualquer
+// amostra do tick é atingido no tick inteiro). Faz parte da biblioteca
+// bode_core (veja "world.h"). Veja "hazard.cpp".
+
+#include <functional>
+#include <vector>
+
+#include "block.h"
+#include "path.h"
+
+// Período do movimento da esfera, em segundos de jogo. Veja
+// HazardSet_LoadDefault().
+#define HAZARD_SPHERE_PERIOD 6.283185307179586
+
+// Buckets do hash espacial de um HazardSet (potência de 2).
+#define HAZARD_HASH_BUCKETS 4096
+
+// Ticks em um período da tabela do jogo. Veja HazardTable_BuildDefault().
+#define HAZARD_DEFAULT_TICKS 64
+
+// Posições amostradas em cada tick ao montar a tabela.
+#define HAZARD_SAMPLES_PER_TICK 8
+
+// Movimento de um perigo ao longo do seu caminho.
+enum HazardMotion
+{
+    HAZARD_MOTION_PATROL = 0, // Velocidade constante: dá a volta nos caminhos fechados e volta nas pontas dos abertos
+    HAZARD_MOTION_SWING  = 1  // Vai e volta entre os parâmetros 0 e 1 das curvas, com velocidade senoidal, como a esfera
+};
+
+struct HazardSet
+{
+    std::vector<Path> paths; // Caminhos, compartilhados pelos perigos
+
+    // Um elemento por perigo. "offset" e "speed" são a distância no
+    // instante zero e as unidades por segundo (PATROL), ou a fase e os
+    // radianos por segundo do seno (SWING).
+    std::vector<float> x, y, z; // Centro no instante da última HazardSet_Update()
+    std::vector<float> radius;
+    std::vector<int>   path;
+    std::vector<float> offset;
+    std::vector<float> speed;
+    std::vector<int>   motion;   // HazardMotion
+    std::vector<float> distance; // Distância no caminho na última HazardSet_Update()
+    float              max_radius;
+
+    // Hash espacial: cada perigo está no bucket da célula (cell_x, cell_z)
+    // do seu centro. Células diferentes podem cair no mesmo bucket.
+    std::vector<int>              cell_x, cell_z;
+    std::vector<std::vector<int>> buckets;
+};
+
+// Retângulo [x0, x1] x [z0, z1] de células (x, z) do bloco, com uma única
+// orientação, atingidas por um perigo. Vazio se x0 > x1.
+struct HazardRect
+{
+    int x0, z0;
+    int x1, z1;
+};
+
+struct HazardTable
+{
+    int    num_ticks;
+    int    num_hazards;
+    double tick_length; // Segundos de jogo por tick
+
+    // Retângulo do perigo h, no tick k, para a orientação o, no índice
+    // (k * num_hazards + h) * BLOCK_NUM_ORIENTATIONS + o.
+    std::vector<HazardRect> rects;
+};
+
+// Esvazia "set". Deve ser chamada antes de usar um HazardSet novo.
+void HazardSet_Clear(HazardSet* set);
+
+// Acrescenta um caminho a "set". Retorna o seu índice.
+int HazardSet_AddPath(HazardSet* set, const Path& path);
+
+// Acrescenta um perigo de raio "radius" que percorre o caminho "path" com o
+// movimento "motion" (veja HazardSet). Retorna o seu índice. A posição só é
+// calculada na próxima HazardSet_Update().
+int HazardSet_Add(HazardSet* set, int path, HazardMotion motion, float offset, float speed, float radius);
+
+// Carrega os perigos do jogo: a esfera, que vai e volta com período
+// HAZARD_SPHERE_PERIOD.
+void HazardSet_LoadDefault(HazardSet* set);
+
+// Calcula o centro de todos os perigos no instante "time" (segundos de jogo)
+// e atualiza o hash espacial.
+void HazardSet_Update(HazardSet* set, double time);
+
+// Centro do perigo "hazard" no instante "time", sem alterar "set". Dá os
+// mesmos valores que HazardSet_Update().
+void HazardSet_Position(const HazardSet* set, int hazard, double time, float* x, float* y, float* z);
+
+// Retorna true se algum perigo, nas posições da última HazardSet_Update(),
+// atinge o bloco "block" (veja hazard_collision() em "collisions.h"). Só
+// visita os buckets das células próximas do bloco.
+bool HazardSet_Hits(const HazardSet* set, BlockState block);
+
+// Monta a tabela de "num_hazards" perigos, com "num_ticks" ticks de
+// "tick_length" segundos. position(h, time, &x, &z) deve dar o centro do
+// perigo h no instante "time", e repetir-se a cada num_ticks * tick_length
+// segundos. Um perigo atinge um estado do bloco quando hazard_collision()
+// (veja "collisions.h"), com o raio radius[h], diz que sim; sem "radius"
+// (NULL), todos têm o raio da esfera.
+void HazardTable_Build(HazardTable* table, int num_ticks, double tick_length, int num_hazards, const float* radius,
+                       const std::function<void(int hazard, double time, float* x, float* z)>& position);
+
+// Monta a tabela dos perigos de "set", que devem repetir o movimento a cada
+// num_ticks * tick_length segundos.
+void HazardTable_BuildSet(HazardTable* table, const HazardSet* set, int num_ticks, double tick_length);
+
+// Monta a tabela dos perigos do jogo: a esfera, em HAZARD_DEFAULT_TICKS ticks
+// por período.
+void HazardTable_BuildDefault(HazardTable* table);
+
+// Tick da tabela que contém o instante "time" (segundos de jogo, >= 0).
+int HazardTable_Tick(const HazardTable* table, double time);
+
+// Retorna true se algum perigo atinge o estado "state" no tick "tick".
+// Definida aqui porque os resolvedores a chamam para cada estado visitado.
+inline bool HazardTable_Hits(const HazardTable* table, int tick, BlockState state)
+{
+    const HazardRect* rect = &table->rects[(size_t)tick * table->num_hazards * BLOCK_NUM_ORIENTATIONS + state.orientation];
+    for (int h = 0; h < table->num_hazards; ++h, rect += BLOCK_NUM_ORIENTATIONS)
+    {
+        if (state.x >= rect->x0 && state.x <= rect->x1 && state.z >= rect->z0 && state.z <= rect->z1)
+            return true;
+    }
+    return false;
+}
+
+#endif // _HAZARD_H
@@ -0,0 +1,50 @@
+#ifndef _IDLE_H
+#define _IDLE_H
+
+// Modo ocioso: quando nada muda na tela, o laço principal deixa de
+// renderizar e fica bloqueado esperando eventos, sem ocupar o processador.
+// Só as animações decorativas (os gatos) param no modo ocioso; as regras do
+// jogo, como os perigos em movimento, seguem o relógio real. Veja
+// "idle.cpp".
+
+// Segundos sem interação do usuário até as animações decorativas (gatos)
+// pararem e o programa poder entrar no modo ocioso.
+#define IDLE_TIMEOUT 15.0
+
+// Inicia a contagem. Deve ser chamada antes do laço principal.
+void Idle_Init();
+
+// Registra uma interação do usuário (teclado, mouse, ou uma tecla de
+// movimento mantida pressionada): pede um novo quadro e, se o programa
+// estava ocioso, retoma as animações.
+void Idle_NotifyInput();
+
+// Pede um novo quadro sem retomar as animações (por exemplo, quando a janela
+// muda de tamanho ou precisa ser repintada).
+void Idle_Invalidate();
+
+// Informa se o mundo muda sozinho com o tempo (por exemplo, perigos em
+// movimento). Enquanto "simulating" for true, todos os quadros são
+// renderizados, mesmo sem interação: o programa nunca fica ocioso.
+void Idle_SetSimulating(bool simulating);
+
+// Agenda um novo quadro para o instante "time" (em segundos, no relógio de
+// glfwGetTime()), para mudanças no texto da tela que dependem do tempo.
+void Idle_RedrawAt(double time);
+
+// Retorna true se o quadro atual deve ser renderizado: o mundo está sendo
+// simulado, as animações estão ativas, ou houve alguma mudança desde o
+// último quadro.
+bool Idle_BeginFrame();
+
+// Bloqueia, com glfwWaitEventsTimeout(), até o próximo evento do sistema
+// operacional ou o próximo quadro agendado. Chamada quando
+// Idle_BeginFrame() retorna false.
+void Idle_WaitEvents();
+
+// Relógio das animações decorativas, em segundos: igual a glfwGetTime(),
+// exceto que não avança enquanto elas estão paradas. Assim as animações
+// continuam de onde pararam. Não deve ser usado pelas regras do jogo.
+double Idle_DecorationTime();
+
+#endif // _IDLE_H
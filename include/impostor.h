@@ -0,0 +1,53 @@
+#ifndef _IMPOSTOR_H
+#define _IMPOSTOR_H
+
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include "scene.h"
+
+// Impostores: objetos distantes são substituídos por um retângulo voltado
+// para a câmera, texturizado com uma imagem do objeto pré-renderizada. Veja
+// "impostor.cpp".
+
+// Imagens de um objeto, vistas de várias direções, em uma única textura
+// ("atlas"). Criado por Impostor_Create().
+struct Impostor
+{
+    GLuint    atlas;  // Textura com uma imagem do objeto por direção de visão
+    glm::vec3 center; // Esfera envolvente do objeto, em coordenadas locais
+    float     radius;
+};
+
+// Um impostor a ser desenhado no quadro atual.
+struct ImpostorInstance
+{
+    const Impostor* impostor;
+    glm::mat4       model; // Matriz de modelagem do objeto substituído
+    float           fade;  // Fração dos pixels desenhada (veja Impostor_Fade())
+};
+
+// Inicializa os impostores. "program_id" é o programa de GPU usado para
+// renderizar os objetos nas texturas dos impostores (o mesmo do caminho
+// OpenGL 3.3 do renderizador).
+void Impostor_Init(GLuint program_id);
+
+// Renderiza "object" (nível de detalhe 0), com a textura "texture", de várias
+// direções, em uma nova textura, usando um framebuffer fora da tela. Deve ser
+// chamada durante o carregamento da cena, pois altera o framebuffer, o
+// viewport e a cor de limpeza.
+Impostor Impostor_Create(const SceneObject& object, GLuint texture);
+
+// Fração dos pixels de um objeto que deve ser desenhada pelo seu impostor,
+// dado o raio projetado da sua esfera envolvente (em NDC). 0.0: somente o
+// objeto; 1.0: somente o impostor; entre os dois, transição (veja
+// "shader_fragment_impostor.glsl").
+float Impostor_Fade(float projected_radius);
+
+// Desenha os impostores. Deve ser chamada no passo opaco (sem blending).
+void Impostor_Draw(const std::vector<ImpostorInstance>& instances, const glm::mat4& view, const glm::mat4& projection);
+
+#endif // _IMPOSTOR_H
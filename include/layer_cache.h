@@ -0,0 +1,35 @@
+#ifndef _LAYER_CACHE_H
+#define _LAYER_CACHE_H
+
+// Cache da camada estática da cena: os objetos que não se movem, e o céu,
+// são renderizados uma vez em um framebuffer próprio (cor e profundidade),
+// que é copiado para a tela a cada quadro enquanto a câmera e os objetos
+// estáticos não mudam. Somente os objetos dinâmicos são desenhados por cima.
+// Veja "layer_cache.cpp".
+
+// O que fazer com a camada estática no quadro atual.
+enum LayerCacheState
+{
+    LAYER_CACHE_DISABLED, // Desenhar tudo normalmente, sem cache
+    LAYER_CACHE_REBUILD,  // Desenhar a camada estática no cache, e então copiá-la
+    LAYER_CACHE_REUSE     // Somente copiar a camada do cache
+};
+
+// Decide o estado do quadro atual. "key" identifica o conteúdo da camada
+// estática (câmera e objetos estáticos): se for igual à do quadro em que o
+// cache foi construído, o cache é reutilizado. A camada só é construída
+// quando a chave se repete em dois quadros seguidos, pois enquanto a câmera
+// se move o cache custaria uma cópia a mais por quadro sem nunca ser
+// reutilizado. O framebuffer e o viewport atuais são os de destino.
+LayerCacheState LayerCache_Begin(unsigned long long key);
+
+// Liga o framebuffer do cache, limpo, para desenhar a camada estática.
+// Somente no estado LAYER_CACHE_REBUILD.
+void LayerCache_BeginRebuild();
+
+// Copia a cor e a profundidade do cache para o framebuffer de destino, e o
+// deixa ligado. Nos estados LAYER_CACHE_REBUILD (após desenhar a camada) e
+// LAYER_CACHE_REUSE.
+void LayerCache_Blit();
+
+#endif // _LAYER_CACHE_H
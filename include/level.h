@@ -0,0 +1,105 @@
+#ifndef _LEVEL_H
+#define _LEVEL_H
+
+// Nível: grade de células quadradas de lado 1, no plano XZ, onde a célula
+// (x, z) ocupa o quadrado centrado em (x, 0, z). Cada célula é vazia ou tem
+// um bloco de chão. A ocupação é guardada em um mapa de bits, uma linha de
+// palavras de 64 bits por valor de z, de forma que verificar uma célula é
+// O(1) para qualquer tamanho de nível. O mesmo mapa decide onde desenhar os
+// blocos de chão e se o jogador está apoiado (veja "collisions.cpp").
+// Veja "level.cpp".
+//
+// Algumas células podem ser dinâmicas (pontes, por exemplo): aparecem e somem
+// durante o jogo, pela Level_SetTile(). O estado atual delas fica no próprio
+// mapa "bits", de forma que Level_IsSolid() não muda; as células alteradas
+// ficam marcadas em um mapa de bits de "sujas", consumido pela
+// Level_ConsumeDirty(), para quem guarda cópias do chão (a malha dos chunks,
+// por exemplo) atualizar só o que mudou.
+//
+// Um nível não depende de OpenGL nem da GLFW: faz parte da biblioteca
+// bode_core (veja "world.h").
+
+#include <functional>
+#include <vector>
+
+// Maior largura e profundidade (em células) de um nível.
+#define LEVEL_MAX_SIZE 4096
+
+// Células guardadas em cada palavra do mapa de bits.
+#define LEVEL_WORD_BITS 64
+
+struct Level
+{
+    int width;  // Tamanho em células, em X e em Z
+    int depth;
+    int stride; // Palavras de "bits" por linha
+    int start_x, start_z; // Célula inicial do jogador
+    int exit_x, exit_z;   // Célula da saída
+    int solid_count;      // Número de células com chão
+
+    // A célula (x, z) está no bit x % 64 da palavra z * stride + x / 64.
+    std::vector<unsigned long long> bits;
+
+    // Células dinâmicas, no mesmo formato. Os três mapas ficam vazios se o
+    // nível não tem células dinâmicas.
+    std::vector<unsigned long long> dynamic;
+    std::vector<unsigned long long> fixed; // "bits" sem as células dinâmicas; nunca muda
+    std::vector<unsigned long long> dirty; // Células dinâmicas alteradas e ainda não consumidas
+    std::vector<int> dirty_words;          // Palavras de "dirty" diferentes de zero
+    int dynamic_count;                     // Número de células dinâmicas
+};
+
+// Carrega em "level" um nível descrito por "num_rows" linhas de texto, uma
+// por valor de z (a primeira é z = 0), com um caractere por célula: '#' para
+// chão, 'S' para a célula inicial e 'E' para a saída (ambas também são chão),
+// 'B' e 'b' para células dinâmicas que começam com e sem chão e '.' ou ' '
+// para vazio. As linhas podem ter comprimentos diferentes. Sem 'S', o
+// jogador começa em (0, 0). Retorna false, deixando "level" vazio, se o
+// nível passa de LEVEL_MAX_SIZE células em alguma direção.
+bool Level_Load(Level* level, const char* const* rows, int num_rows);
+
+// Carrega o nível do jogo. Retorna false como Level_Load().
+bool Level_LoadDefault(Level* level);
+
+// Carrega em "level" o nível do arquivo texto "filename", com uma linha por
+// valor de z, no formato de Level_Load(). Retorna false se o arquivo não
+// pode ser lido ou se o nível é grande demais.
+bool Level_LoadFile(Level* level, const char* filename);
+
+// Grava "level" no arquivo texto "filename", no formato de Level_LoadFile().
+// Retorna false se o arquivo não pode ser escrito.
+bool Level_Save(const Level* level, const char* filename);
+
+// Retorna true se a célula (x, z) tem chão. Células fora do nível são vazias.
+// Definida aqui para que resolvedores possam chamá-la milhões de vezes por
+// segundo.
+inline bool Level_IsSolid(const Level* level, int x, int z)
+{
+    // Coordenadas negativas viram valores sem sinal enormes, e também ficam
+    // fora do nível.
+    if ((unsigned int)x >= (unsigned int)level->width || (unsigned int)z >= (unsigned int)level->depth)
+        return false;
+
+    return (level->bits[(size_t)z * level->stride + x / LEVEL_WORD_BITS] >> (x % LEVEL_WORD_BITS)) & 1;
+}
+
+// Retorna true se a célula (x, z) é dinâmica.
+inline bool Level_IsDynamic(const Level* level, int x, int z)
+{
+    if (level->dynamic.empty() || (unsigned int)x >= (unsigned int)level->width || (unsigned int)z >= (unsigned int)level->depth)
+        return false;
+
+    return (level->dynamic[(size_t)z * level->stride + x / LEVEL_WORD_BITS] >> (x % LEVEL_WORD_BITS)) & 1;
+}
+
+// Coloca ou retira o chão da célula dinâmica (x, z), marcando-a como suja se
+// o estado mudou. Células que não são dinâmicas não mudam. Só deve ser
+// chamada entre passos dos mundos que usam o nível, na thread deles.
+void Level_SetTile(Level* level, int x, int z, bool solid);
+
+// Chama "callback" para cada célula suja, em ordem de z e depois de x, e
+// limpa as marcas. O custo é proporcional às palavras sujas, e não ao
+// tamanho do nível.
+void Level_ConsumeDirty(Level* level, const std::function<void(int x, int z)>& callback);
+
+#endif // _LEVEL_H
@@ -0,0 +1,37 @@
+#ifndef _LOD_H
+#define _LOD_H
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "scene.h"
+
+// Níveis de detalhe (LOD, "level of detail") dos objetos da cena. Veja
+// "lod.cpp".
+
+// Simplifica uma malha de triângulos (GL_TRIANGLES) até no máximo
+// "target_num_indices" índices, através de colapsos de arestas guiados por
+// quádricas de erro (Garland e Heckbert). Os vértices da malha simplificada
+// são um subconjunto dos vértices originais, de forma que o mesmo VBO serve
+// para todos os níveis. "model_coefficients" contém 4 floats (X, Y, Z, W) por
+// vértice. Escreve os novos índices em "result" e retorna o erro geométrico
+// aproximado (distância) introduzido.
+float Lod_SimplifyMesh(const std::vector<float>& model_coefficients,
+                       const GLuint* indices, size_t num_indices,
+                       size_t target_num_indices, std::vector<GLuint>& result);
+
+// Gera os níveis de detalhe de "object" a partir do nível 0 (first_index e
+// num_indices). Os índices de cada nível são adicionados ao final de
+// "indices", que deve ser o vetor de índices do modelo ao qual "object"
+// pertence. Objetos pequenos recebem somente o nível 0.
+void Lod_BuildLevels(SceneObject* object, const std::vector<float>& model_coefficients, std::vector<GLuint>& indices);
+
+// Escolhe o nível de detalhe de "object" a partir do raio projetado da sua
+// esfera envolvente ("projected_radius", em unidades de NDC: 1.0 é metade da
+// altura da tela) e do nível escolhido no quadro anterior ("previous"). Um
+// nível só é trocado quando o raio ultrapassa o limiar com uma margem
+// (histerese), evitando que o objeto alterne entre dois níveis a cada quadro.
+unsigned int Lod_Select(const SceneObject& object, float projected_radius, unsigned int previous);
+
+#endif // _LOD_H
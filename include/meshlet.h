@@ -0,0 +1,21 @@
+#ifndef _MESHLET_H
+#define _MESHLET_H
+
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "scene.h"
+
+// Divisão dos objetos em meshlets (grupos de triângulos vizinhos). Veja
+// "meshlet.cpp".
+
+// Divide cada nível de detalhe de "object" em meshlets de até 128
+// triângulos. Os triângulos de cada nível são reordenados dentro do seu
+// trecho de "indices" (o vetor de índices do modelo), de forma que cada
+// meshlet ocupe um trecho contíguo; os meshlets são adicionados a
+// g_SceneMeshlets. Deve ser chamada após Lod_BuildLevels(). Objetos pequenos
+// não são divididos.
+void Meshlet_Build(SceneObject* object, const std::vector<float>& model_coefficients, std::vector<GLuint>& indices);
+
+#endif // _MESHLET_H
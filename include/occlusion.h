@@ -0,0 +1,44 @@
+#ifndef _OCCLUSION_H
+#define _OCCLUSION_H
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+
+#include "scene.h"
+
+// Descarte por oclusão (occlusion culling) em software: os objetos marcados
+// como oclusores são rasterizados pela CPU em um buffer de profundidade de
+// baixa resolução, e os demais objetos são testados contra ele antes de serem
+// enviados à GPU. Veja "occlusion.cpp".
+
+// Resolução do buffer de profundidade. Cobre toda a tela, independentemente
+// da sua proporção.
+#define OCCLUSION_WIDTH  256
+#define OCCLUSION_HEIGHT 128
+
+// Inicia um novo quadro: limpa o buffer de profundidade e a lista de
+// oclusores. "projection_view" é a matriz projection * view da câmera.
+void Occlusion_Begin(const glm::mat4& projection_view);
+
+// Adiciona os triângulos do nível de detalhe 0 de "object", com matriz de
+// modelagem "model", à lista de oclusores. O objeto deve ser opaco e sólido:
+// tudo que estiver atrás dele será considerado invisível. Os triângulos são
+// lidos de g_SceneGeometry ou, para objetos fora dela, da cópia em
+// SceneObject::cpu_positions; objetos sem nenhuma das duas são ignorados.
+void Occlusion_AddOccluder(const SceneObject& object, const glm::mat4& model);
+
+// Adiciona à lista de oclusores os triângulos de "num_indices" índices
+// "indices", sobre as posições (X, Y, Z, W) "positions", com matriz de
+// modelagem "model". Cada índice é somado a "base_vertex".
+void Occlusion_AddTriangles(const float* positions, const GLuint* indices, size_t num_indices, GLint base_vertex, const glm::mat4& model);
+
+// Rasteriza todos os oclusores adicionados desde Occlusion_Begin(), em
+// paralelo (veja "thread_pool.h").
+void Occlusion_Rasterize();
+
+// Retorna false se a caixa (bbox_min, bbox_max), em coordenadas locais de um
+// objeto com matriz de modelagem "model", está totalmente escondida pelos
+// oclusores rasterizados. O teste é conservador: na dúvida, retorna true.
+bool Occlusion_TestBox(const glm::vec3& bbox_min, const glm::vec3& bbox_max, const glm::mat4& model);
+
+#endif // _OCCLUSION_H
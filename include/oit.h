@@ -0,0 +1,34 @@
+#ifndef _OIT_H
+#define _OIT_H
+
+#include <glad/glad.h>
+
+// Transparência independente de ordem ("weighted blended order-independent
+// transparency", McGuire e Bavoil, 2013). Os objetos transparentes são
+// desenhados uma única vez, em qualquer ordem, acumulando em duas texturas
+// uma média das suas cores ponderada pela opacidade e pela profundidade, e a
+// fração do fundo que continua visível; a composição então mistura esta
+// média sobre a cena opaca. O resultado não depende da ordem de desenho, e
+// os objetos não precisam ser ordenados. Veja "oit.cpp".
+
+// Carrega os shaders da composição. Deve ser chamada após a criação do
+// contexto OpenGL.
+void Oit_Init();
+
+// Prepara o framebuffer atual para a acumulação: a textura de cor 0 (formato
+// RGBA16F) recebe a soma das cores e a fração visível do fundo, a textura 1
+// (R16F) a soma dos pesos; a profundidade deve ser a da cena opaca, que
+// continua escondendo os transparentes mas não é alterada. Limpa as duas
+// texturas e liga o blending da acumulação.
+void Oit_BeginAccumulation();
+
+// Restaura o estado alterado por Oit_BeginAccumulation().
+void Oit_EndAccumulation();
+
+// Mistura o resultado da acumulação, lido das texturas "accum_texture" e
+// "weight_texture", sobre a cor do framebuffer atual. Deixa o blending ligado
+// com glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA), estado esperado pela
+// renderização de texto.
+void Oit_Composite(GLuint accum_texture, GLuint weight_texture);
+
+#endif // _OIT_H
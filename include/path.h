@@ -0,0 +1,128 @@
+#ifndef _PATH_H
+#define _PATH_H
+
+// Caminhos: curvas no espaço, definidas por pontos de controle, seguidas por
+// perigos, câmeras e objetos decorativos. Um caminho é uma sequência de
+// curvas de Bézier cúbicas encadeadas (o último ponto de uma é o primeiro da
+// seguinte), dadas diretamente ou calculadas de pontos de passagem
+// (Catmull-Rom).
+//
+// O parâmetro das curvas não anda com velocidade constante: pontos de
+// controle próximos concentram parâmetro em pouco espaço. Por isso, ao
+// carregar o caminho, montamos uma tabela de posições igualmente espaçadas
+// no comprimento de arco. Avaliar o caminho a uma distância do início é
+// então uma consulta à tabela e uma interpolação linear, sem resolver nada
+// por quadro, e muitos seguidores (PathFollowers) são avançados de uma vez
+// com instruções SIMD.
+//
+// Não depende de OpenGL: faz parte da biblioteca bode_core (veja "world.h").
+// Veja "path.cpp".
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+// Amostras por curva usadas para medir o comprimento de arco, e também
+// entradas da tabela por curva.
+#define PATH_SAMPLES_PER_SEGMENT 64
+
+struct Path
+{
+    // Curva k: pontos de controle 3k a 3k + 3, percorrida quando o
+    // parâmetro vai de knots[k] a knots[k + 1].
+    std::vector<glm::vec3> points;
+    std::vector<float>     knots;
+    int                    num_segments;
+    bool                   closed; // O fim coincide com o início (seguidores dão a volta)
+
+    // Comprimento total e tabela de posições nas distâncias i * step do
+    // início, como estrutura de arrays. A última entrada é o fim.
+    float              length;
+    float              step;
+    float              inverse_step;
+    std::vector<float> table_x, table_y, table_z;
+
+    // Distância do início até a amostra i do parâmetro (parâmetro local
+    // i % PATH_SAMPLES_PER_SEGMENT / PATH_SAMPLES_PER_SEGMENT da curva
+    // i / PATH_SAMPLES_PER_SEGMENT). Veja Path_ParameterDistance().
+    std::vector<float> arc;
+};
+
+// Seguidores de um caminho, como estrutura de arrays: distância do início e
+// velocidade (unidades por segundo; negativa anda para o início) de cada um,
+// e a posição calculada por PathFollowers_Advance().
+struct PathFollowers
+{
+    std::vector<float> distance;
+    std::vector<float> speed;
+    std::vector<float> x, y, z;
+};
+
+// Caminho com as curvas de Bézier dos "num_points" = 3n + 1 pontos de
+// controle "points". Se "knots" não for NULL, a curva k é percorrida quando o
+// parâmetro vai de knots[k] a knots[k + 1] (n + 1 valores crescentes); senão,
+// de k a k + 1.
+void Path_InitBezier(Path* path, const glm::vec3* points, int num_points, const float* knots);
+
+// Caminho que passa por todos os "num_points" pontos "points", com tangente
+// em cada ponto paralela à reta entre o anterior e o seguinte (Catmull-Rom
+// uniforme). Se "closed", volta do último ao primeiro. Com menos de dois
+// pontos, o caminho tem comprimento zero, no primeiro ponto (ou na origem).
+void Path_InitCatmullRom(Path* path, const glm::vec3* points, int num_points, bool closed);
+
+// Carrega o caminho do jogo: as duas curvas seguidas pela esfera e pelos
+// gatos, com o parâmetro de 0 a 1.2 (a esfera só usa até 1). Veja
+// HazardSet_LoadDefault().
+void Path_LoadDefault(Path* path);
+
+// Ponto exato do caminho no parâmetro "u" (veja Path::knots), limitado ao
+// início e ao fim. Para quem depende da velocidade variável das curvas.
+glm::vec3 Path_EvaluateParameter(const Path* path, float u);
+
+// Distância do início até o ponto do parâmetro "u" (veja Path::knots),
+// limitado ao início e ao fim. Path_Evaluate() nessa distância dá
+// aproximadamente Path_EvaluateParameter(): quem anda pelo parâmetro pode
+// converter o seu movimento uma vez, ao carregar, e depois só consultar a
+// tabela.
+float Path_ParameterDistance(const Path* path, float u);
+
+// Ponto do caminho a uma distância "distance" do início, medida ao longo da
+// curva e limitada ao início e ao fim. Andar distâncias iguais em tempos
+// iguais dá velocidade constante.
+glm::vec3 Path_Evaluate(const Path* path, float distance);
+
+// Path_Evaluate() para "count" pontos de uma vez, quatro por vez com
+// instruções SIMD (SSE2) quando disponíveis: o ponto i está no caminho
+// paths[path_index[i]] (ou paths[0], se "path_index" for NULL), à distância
+// distance[i], e vai para (x[i], y[i], z[i]). Dá os mesmos valores que
+// Path_Evaluate().
+void Path_EvaluateMany(const Path* paths, const int* path_index, const float* distance, size_t count,
+                       float* x, float* y, float* z);
+
+// Distância "distance", que pode passar das pontas, levada para dentro do
+// caminho como uma onda periódica: nos caminhos fechados, dá a volta (módulo
+// o comprimento); nos abertos, vai e volta (módulo o dobro do comprimento,
+// refletida na volta). Andar com velocidade constante por essa distância
+// percorre o caminho para sempre.
+float Path_Wrap(const Path* path, float distance);
+
+// Path_Wrap() para "count" distâncias de uma vez, quatro por vez com
+// instruções SIMD (SSE2) quando disponíveis: distance[i] é levada para
+// dentro do caminho paths[path_index[i]] (ou paths[0], se "path_index" for
+// NULL). Dá os mesmos valores que Path_Wrap().
+void Path_WrapMany(const Path* paths, const int* path_index, float* distance, size_t count);
+
+// Avança os seguidores por "dt" segundos e calcula as suas posições, quatro
+// por vez com instruções SIMD (SSE2) quando disponíveis. Em caminhos
+// fechados, quem passa do fim continua do início (e vice-versa); nos
+// abertos, quem chega a uma ponta volta, com a velocidade invertida. O
+// passo pode dar várias voltas: a distância é levada para dentro do caminho
+// como em Path_Wrap().
+void PathFollowers_Advance(const Path* path, PathFollowers* followers, float dt);
+
+// Acrescenta um seguidor, a uma distância do início e com velocidade dadas.
+// Retorna o seu índice.
+size_t PathFollowers_Add(PathFollowers* followers, float distance, float speed);
+
+#endif // _PATH_H
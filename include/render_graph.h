@@ -0,0 +1,97 @@
+#ifndef _RENDER_GRAPH_H
+#define _RENDER_GRAPH_H
+
+#include <functional>
+
+#include <glad/glad.h>
+
+// Grafo de renderização: a cada quadro, os passos de renderização (cena,
+// ampliação, texto, ...) são declarados junto com os recursos que leem e
+// escrevem. O grafo descarta os passos cujo resultado não chega à janela,
+// ordena os restantes, cria as texturas temporárias (e os framebuffers) a
+// partir de um conjunto reutilizado entre quadros, reaproveitando a mesma
+// textura para recursos cujos tempos de vida não se sobrepõem, e mede o
+// tempo de GPU de cada passo. Veja "render_graph.cpp".
+
+// Formatos das texturas temporárias.
+enum RenderGraphFormat
+{
+    RENDER_GRAPH_RGBA8,   // Cor, 8 bits por canal
+    RENDER_GRAPH_RGBA16F, // Cor, ponto flutuante de 16 bits por canal
+    RENDER_GRAPH_R16F,    // Um canal, ponto flutuante de 16 bits
+    RENDER_GRAPH_DEPTH24  // Profundidade, 24 bits
+};
+
+// Identificador de um recurso (textura ou framebuffer da janela) do quadro
+// atual. Só é válido até o próximo RenderGraph_Begin().
+typedef int RenderGraphResource;
+
+// Identificador de um passo do quadro atual.
+typedef int RenderGraphPass;
+
+// Informa o novo tamanho do framebuffer da janela, em pixels. Pode ser
+// chamada de FramebufferSizeCallback() a qualquer momento.
+void RenderGraph_Resize(int width, int height);
+
+// Tamanho do framebuffer da janela, informado por RenderGraph_Resize().
+void RenderGraph_GetBackbufferSize(int* width, int* height);
+
+// Começa a declaração de um novo quadro, descartando os passos e recursos
+// do quadro anterior.
+void RenderGraph_Begin();
+
+// Recurso que representa o framebuffer da janela. Passos que o escrevem
+// nunca são descartados.
+RenderGraphResource RenderGraph_ImportBackbuffer();
+
+// Declara uma textura temporária, que só existe durante a execução do
+// quadro. A textura é alocada somente se algum passo não descartado a usa.
+RenderGraphResource RenderGraph_CreateTexture(const char* name, RenderGraphFormat format, int width, int height);
+
+// Declara um passo. "execute" é chamada por RenderGraph_Execute() com o
+// framebuffer do passo já ligado (as texturas que ele escreve, ou a janela)
+// e o viewport cobrindo-o por inteiro. "name" deve ser uma cadeia constante.
+RenderGraphPass RenderGraph_AddPass(const char* name, const std::function<void()>& execute);
+
+// Declara que o passo "pass" lê o recurso "resource", como ele está depois
+// dos passos declarados antes de "pass" que o escrevem: "pass" é executado
+// depois destes e antes dos declarados depois dele que o escrevem. Se nenhum
+// passo anterior escreve o recurso, "pass" é executado depois de todos os
+// que o escrevem.
+void RenderGraph_Read(RenderGraphPass pass, RenderGraphResource resource);
+
+// Declara que o passo "pass" escreve o recurso "resource". Passos que
+// escrevem o mesmo recurso são executados na ordem em que foram declarados.
+// Um passo escreve no máximo quatro texturas de cor e uma de profundidade.
+void RenderGraph_Write(RenderGraphPass pass, RenderGraphResource resource);
+
+// Descarta os passos não usados, ordena os restantes e os executa, alocando
+// as texturas temporárias e medindo o tempo de cada passo. Nada é executado
+// enquanto a janela não tem tamanho (por exemplo, minimizada).
+void RenderGraph_Execute();
+
+// Textura OpenGL de um recurso lido pelo passo em execução.
+GLuint RenderGraph_GetTexture(RenderGraphResource resource);
+
+// Liga em GL_READ_FRAMEBUFFER um framebuffer com a textura de cor
+// "resource", para cópias com glBlitFramebuffer().
+void RenderGraph_BindReadFramebuffer(RenderGraphResource resource);
+
+// Passos executados no último quadro medido, e o tempo de GPU de cada um,
+// em milissegundos. As medições chegam com alguns quadros de atraso.
+int RenderGraph_GetTimedPassCount();
+const char* RenderGraph_GetTimedPassName(int index);
+float RenderGraph_GetTimedPassMilliseconds(int index);
+
+// Estatísticas do quadro atual.
+struct RenderGraphStats
+{
+    unsigned int passes;        // Passos declarados
+    unsigned int culled_passes; // Passos descartados
+    unsigned int textures;      // Texturas temporárias declaradas e usadas
+    unsigned int pool_textures; // Texturas alocadas no conjunto
+    unsigned long long pool_bytes; // Memória de vídeo do conjunto (estimada)
+};
+RenderGraphStats RenderGraph_GetStats();
+
+#endif // _RENDER_GRAPH_H
@@ -0,0 +1,107 @@
+#ifndef _RENDERER_H
+#define _RENDERER_H
+
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+
+#include "scene.h"
+
+struct Impostor; // Veja "impostor.h"
+
+// Passos (passes) em que um quadro é dividido. São desenhados nesta ordem:
+//
+//   RENDER_PASS_OPAQUE:      blending desligado, ordenados de frente para trás
+//                            para que o teste de profundidade descarte o
+//                            máximo possível de fragmentos ("early-Z");
+//   (céu):                   desenhado por Skybox_Draw() ao final dos opacos,
+//                            de forma que só os pixels não cobertos por
+//                            outros objetos sejam pintados;
+//   RENDER_PASS_TRANSPARENT: acumulados, sem ordenação, nas texturas da
+//                            transparência independente de ordem (veja
+//                            "oit.h"), em um passo separado:
+//                            Renderer_DrawTransparent().
+enum RenderPass
+{
+    RENDER_PASS_OPAQUE,
+    RENDER_PASS_TRANSPARENT
+};
+
+// Um pedido de desenho: qual objeto da cena virtual, com qual matriz de
+// modelagem, com qual textura e em qual passo. A função main() monta, a cada
+// quadro, uma lista destes pedidos, e o renderizador decide como e em que
+// ordem submetê-los à GPU.
+//
+// "lod_state" aponta para uma variável, mantida pelo chamador entre quadros,
+// com o nível de detalhe usado por esta instância no quadro anterior (veja
+// Lod_Select()). Se for NULL, o nível é escolhido sem histerese.
+//
+// "impostor", se não for NULL, é a imagem pré-renderizada (veja
+// Impostor_Create()) que substitui o objeto quando este está longe da
+// câmera. Somente para objetos do passo RENDER_PASS_OPAQUE.
+//
+// "occluder" marca objetos grandes e sólidos, que são rasterizados pela CPU
+// para descartar o que estiver atrás deles (veja "occlusion.h"). Somente para
+// objetos do passo RENDER_PASS_OPAQUE: os transparentes não escondem nada.
+//
+// "is_static" marca objetos que não mudam de um quadro para o outro (mesma
+// matriz e textura). Os opacos são desenhados, junto com o céu, em uma
+// camada guardada em cache enquanto a câmera não se move (veja
+// "layer_cache.h").
+//
+// "opacity", em [0, 1], multiplica o alfa da textura. Somente para objetos do
+// passo RENDER_PASS_TRANSPARENT.
+struct DrawItem
+{
+    const SceneObject* object;
+    glm::mat4          model;
+    GLuint             texture;
+    RenderPass         pass;
+    unsigned int*      lod_state;
+    const Impostor*    impostor;
+    bool               occluder;
+    bool               is_static;
+    float              opacity;
+};
+
+// Contadores do último quadro desenhado, para instrumentação.
+struct RendererStats
+{
+    unsigned int visible_objects;  // Objetos que passaram pelo descarte (culling)
+    unsigned int culled_objects;   // Objetos descartados por estarem fora do frustum
+    unsigned int occluded_objects; // Objetos descartados por estarem atrás dos oclusores
+    unsigned int cached_objects;   // Objetos visíveis da camada estática (veja "layer_cache.h")
+    unsigned int visible_meshlets; // Meshlets desenhados, dos objetos visíveis
+    unsigned int culled_meshlets;  // Meshlets descartados (fora do frustum ou de costas para a câmera)
+    unsigned int triangles;        // Triângulos submetidos, após a escolha dos níveis de detalhe
+    unsigned int impostors;        // Objetos desenhados, total ou parcialmente, como impostores
+};
+
+// Inicializa o renderizador. Deve ser chamada após TODA a geometria da cena
+// ter sido construída, pois o caminho com multi-draw indirect copia
+// g_SceneGeometry para a GPU. "program_id" é o programa de GPU usado no
+// caminho tradicional (OpenGL 3.3), construído a partir de
+// "shader_vertex.glsl" e "shader_fragment.glsl".
+void Renderer_Init(GLuint program_id);
+
+// Retorna true se a cena está sendo desenhada com glMultiDrawElementsIndirect().
+bool Renderer_UsingMultiDrawIndirect();
+
+// Desenha os itens da lista que estão dentro do campo de visão da câmera e
+// não estão escondidos pelos oclusores, cada um no nível de detalhe adequado
+// ao seu tamanho na tela (ou como impostor) e sem os meshlets que estão fora
+// da tela ou de costas para a câmera, utilizando as matrizes "view" e
+// "projection" fornecidas. Somente os objetos opacos (e o céu) são
+// desenhados; os transparentes visíveis são guardados para
+// Renderer_DrawTransparent(), e "items" deve continuar válida até lá.
+void Renderer_DrawScene(const std::vector<DrawItem>& items, const glm::mat4& view, const glm::mat4& projection);
+
+// Desenha os objetos transparentes visíveis do último Renderer_DrawScene(),
+// em qualquer ordem, entre Oit_BeginAccumulation() e Oit_EndAccumulation().
+void Renderer_DrawTransparent(const glm::mat4& view, const glm::mat4& projection);
+
+// Retorna os contadores do último quadro desenhado.
+const RendererStats& Renderer_GetStats();
+
+#endif // _RENDERER_H
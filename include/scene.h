@@ -0,0 +1,119 @@
+#ifndef _SCENE_H
+#define _SCENE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/vec3.hpp>
+
+// Número máximo de níveis de detalhe (LOD) de um objeto. Veja "lod.h".
+#define SCENE_MAX_LODS 4
+
+// Definimos uma estrutura que armazenará dados necessários para renderizar
+// cada objeto da cena virtual.
+struct SceneObject
+{
+    std::string  name;        // Nome do objeto
+    size_t       first_index; // Índice do primeiro vértice dentro do vetor indices[] definido em BuildTrianglesAndAddToVirtualScene()
+    size_t       num_indices; // Número de índices do objeto dentro do vetor indices[] definido em BuildTrianglesAndAddToVirtualScene()
+    GLenum       rendering_mode; // Modo de rasterização (GL_TRIANGLES, GL_TRIANGLE_STRIP, etc.)
+    GLuint       vertex_array_object_id; // ID do VAO onde estão armazenados os atributos do modelo
+
+    // Posição do objeto dentro da geometria unificada g_SceneGeometry (veja
+    // abaixo): primeiro índice e deslocamento somado a cada índice. Objetos
+    // criados depois da inicialização do renderizador (por exemplo, os
+    // chunks do chão; veja "chunk_stream.h") não estão lá: têm
+    // pool_base_vertex negativo e são sempre desenhados com o próprio VAO.
+    GLuint       pool_first_index;
+    GLint        pool_base_vertex;
+
+    // Cópia da malha na memória principal, para objetos fora de
+    // g_SceneGeometry usados como oclusores (veja "occlusion.h"): posições
+    // (X, Y, Z, W) e os índices do nível 0. NULL se não houver.
+    const float*  cpu_positions;
+    const GLuint* cpu_indices;
+
+    // Volumes envolventes do objeto, em coordenadas locais do modelo: caixa
+    // alinhada aos eixos (AABB) e esfera. Calculados por
+    // SceneObject_ComputeBounds() e usados no descarte de objetos fora da
+    // visão da câmera (veja "culling.h").
+    glm::vec3    bbox_min;
+    glm::vec3    bbox_max;
+    glm::vec3    bsphere_center;
+    float        bsphere_radius;
+
+    // Níveis de detalhe: o nível 0 é a malha original (first_index e
+    // num_indices); os demais são versões simplificadas, que usam os mesmos
+    // vértices, com índices colocados após os do nível 0 no mesmo vetor
+    // indices[]. Veja Lod_BuildLevels().
+    unsigned int num_lods;
+    size_t       lod_first_index[SCENE_MAX_LODS];
+    size_t       lod_num_indices[SCENE_MAX_LODS];
+
+    // Agrupamentos de triângulos ("meshlets") de cada nível de detalhe, em
+    // g_SceneMeshlets: lod_num_meshlets[k] grupos a partir de
+    // lod_first_meshlet[k]. Zero para objetos pequenos, que são sempre
+    // desenhados inteiros. Veja Meshlet_Build().
+    size_t       lod_first_meshlet[SCENE_MAX_LODS];
+    size_t       lod_num_meshlets[SCENE_MAX_LODS];
+
+    // Incrementado quando os vértices do objeto mudam depois de enviados
+    // para a GPU (por exemplo, as células dinâmicas dos chunks; veja
+    // "chunk_stream.h"), para que a camada estática em cache seja refeita
+    // (veja "layer_cache.h").
+    unsigned int revision;
+};
+
+// Cópia em memória principal de TODA a geometria da cena, concatenada em um
+// único conjunto de vetores. Os construtores de geometria (BuildTriangles() e
+// BuildTrianglesAndAddToVirtualScene()) adicionam seus dados aqui, além de
+// criarem seus próprios VAOs. A partir desta cópia o
+// renderizador monta um único VAO com todos os objetos, necessário para
+// desenhar a cena inteira com uma única chamada glMultiDrawElementsIndirect().
+struct SceneGeometry
+{
+    std::vector<float>  model_coefficients;   // X, Y, Z, W de cada vértice
+    std::vector<float>  texture_coefficients; // U, V de cada vértice
+    std::vector<GLuint> indices;              // Índices relativos a pool_base_vertex
+};
+
+// Meshlets de todos os objetos da cena. Cada meshlet é um trecho contíguo do
+// vetor indices[] do seu modelo, com até algumas centenas de índices, e com
+// volumes envolventes próprios (em coordenadas locais do modelo), usados para
+// descartar partes de um objeto que estão fora da tela ou de costas para a
+// câmera. Armazenados como estrutura de arrays, formato usado pelos testes
+// SIMD de "culling.h".
+struct SceneMeshlets
+{
+    std::vector<GLuint> first_index;  // Relativo ao vetor indices[] do modelo, como SceneObject::first_index
+    std::vector<GLuint> num_indices;
+    std::vector<float>  center_x, center_y, center_z, radius; // Esfera envolvente
+    std::vector<float>  axis_x, axis_y, axis_z, cutoff;       // Cone de normais (veja Culling_TestCones())
+};
+
+// A cena virtual é uma lista de objetos nomeados, guardados em um dicionário
+// (map). Definida em main.cpp.
+extern std::map<std::string, SceneObject> g_VirtualScene;
+
+// Geometria unificada da cena. Definida em scene.cpp.
+extern SceneGeometry g_SceneGeometry;
+
+// Meshlets de todos os objetos. Definidos em scene.cpp.
+extern SceneMeshlets g_SceneMeshlets;
+
+// Adiciona vértices e índices a g_SceneGeometry. Caso o modelo não possua
+// coordenadas de textura, "texture_coefficients" pode ser vazio. Retorna,
+// através dos ponteiros, a posição onde os dados foram colocados.
+void SceneGeometry_Append(const std::vector<float>& model_coefficients,
+                          const std::vector<float>& texture_coefficients,
+                          const std::vector<GLuint>& indices,
+                          GLint* base_vertex, GLuint* first_index);
+
+// Calcula a AABB e a esfera envolvente de "object" a partir dos vértices
+// referenciados por "indices" ("model_coefficients" com 4 floats por vértice).
+void SceneObject_ComputeBounds(SceneObject* object, const float* model_coefficients,
+                               const GLuint* indices, size_t num_indices);
+
+#endif // _SCENE_H
@@ -0,0 +1,19 @@
+#ifndef _SKYBOX_H
+#define _SKYBOX_H
+
+#include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+
+// Céu da cena, desenhado como um cubo "infinitamente distante" texturizado
+// com um cubemap. Veja "skybox.cpp".
+
+// Carrega as seis faces do cubemap (na ordem +X, -X, +Y, -Y, +Z, -Z, arquivos
+// BMP) e cria a geometria e o programa de GPU do céu.
+void Skybox_Init(const char* const face_paths[6]);
+
+// Desenha o céu. Deve ser chamada APÓS todos os objetos opacos, pois só
+// pinta os pixels em que nada foi desenhado (profundidade igual à do far
+// plane).
+void Skybox_Draw(const glm::mat4& view, const glm::mat4& projection);
+
+#endif // _SKYBOX_H
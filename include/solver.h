@@ -0,0 +1,57 @@
+#ifndef _SOLVER_H
+#define _SOLVER_H
+
+// Resolvedor de níveis: encontra a menor sequência de movimentos que leva o
+// bloco de um estado até a saída (de pé), ou prova que ela não existe.
+// A busca é em largura, a partir do início e da saída ao mesmo tempo
+// (bidirecional), sobre os estados do bloco (célula e orientação) que estão
+// inteiramente sobre o chão. Cada camada da busca pode ser expandida em
+// paralelo pelas threads de "thread_pool.h". Veja "solver.cpp".
+//
+// Solver_Solve() não considera a esfera; Solver_SolveTimed() busca também
+// sobre o tempo, evitando os perigos da tabela de ocupação (veja
+// "hazard.h"). Faz parte da biblioteca bode_core (veja "world.h").
+
+#include <vector>
+
+#include "block.h"
+#include "hazard.h"
+#include "level.h"
+
+// Ação de esperar um tick em SolverResult::moves, no modo com tempo.
+#define SOLVER_WAIT BLOCK_NUM_DIRECTIONS
+
+struct SolverResult
+{
+    bool             solvable;
+    std::vector<int> moves;          // Movimentos (BlockDirection ou SOLVER_WAIT), do estado inicial até a saída
+    size_t           visited_states; // Estados visitados pelas duas buscas
+};
+
+// Resolve o nível "level" a partir do estado "start". Com "parallel", cada
+// camada grande da busca é dividida entre as threads do conjunto, que não
+// pode estar em uso por outra chamada de ThreadPool_ParallelFor(); sem
+// "parallel" (por exemplo, dentro de uma tarefa do conjunto) tudo roda na
+// thread atual. Retorna result->solvable.
+bool Solver_Solve(const Level* level, BlockState start, bool parallel, SolverResult* result);
+
+// Primeiro movimento (BlockDirection) da menor solução a partir de "state",
+// por exemplo para uma dica ao jogador, ou -1 se não há solução ou o bloco
+// já está na saída. Roda na thread atual.
+int Solver_Hint(const Level* level, BlockState state);
+
+// Resolve o nível "level" a partir do estado "start" no tick "start_tick" da
+// tabela "hazards", sem que nenhum perigo atinja o bloco. Cada elemento de
+// result->moves ocupa um tick: um movimento feito no início do tick, ou
+// SOLVER_WAIT. A solução é a que chega à saída no menor tempo. O espaço de
+// busca é o de Solver_Solve() vezes hazards->num_ticks. Retorna
+// result->solvable.
+bool Solver_SolveTimed(const Level* level, const HazardTable* hazards, BlockState start, int start_tick,
+                       bool parallel, SolverResult* result);
+
+// Primeira ação (BlockDirection ou SOLVER_WAIT) da solução mais rápida a
+// partir de "state" no instante "time" (segundos de jogo), ou -1 se não há
+// solução ou o bloco já está na saída. Roda na thread atual.
+int Solver_HintTimed(const Level* level, const HazardTable* hazards, BlockState state, double time);
+
+#endif // _SOLVER_H
@@ -0,0 +1,30 @@
+#ifndef _THREAD_POOL_H
+#define _THREAD_POOL_H
+
+#include <cstddef>
+#include <functional>
+
+// Conjunto de threads de trabalho ("thread pool"), criadas uma única vez e
+// reutilizadas a cada quadro. Veja "thread_pool.cpp".
+
+// Cria as threads de trabalho. Se "num_threads" for 0, usa uma thread a menos
+// que o número de núcleos do processador (a thread que chama
+// ThreadPool_ParallelFor() também trabalha).
+void ThreadPool_Init(unsigned int num_threads);
+
+// Termina e libera as threads de trabalho. Deve ser chamada antes do fim do
+// programa.
+void ThreadPool_Terminate();
+
+// Número de threads que executam as tarefas, incluindo a que chama
+// ThreadPool_ParallelFor().
+unsigned int ThreadPool_NumThreads();
+
+// Executa task(i) para todo i em [0, count), distribuindo as chamadas entre as
+// threads de trabalho, e retorna quando todas terminarem. As chamadas podem
+// ocorrer em qualquer ordem e simultaneamente, logo "task" não deve escrever
+// em dados compartilhados sem sincronização. Se o conjunto não foi criado
+// (ou não tem threads), executa tudo na thread atual.
+void ThreadPool_ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+#endif // _THREAD_POOL_H
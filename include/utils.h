@@ -3,6 +3,12 @@
 
 #include <cstdio>
 
+// Consulta (e imprime) os erros OpenGL pendentes. glGetError() obriga o
+// driver a sincronizar, então, compilado com NDEBUG, glCheckError() não faz
+// nada; os erros são então relatados por GL_KHR_debug (veja "gl_debug.h").
+#ifdef NDEBUG
+#define glCheckError() ((void)0)
+#else
 static GLenum glCheckError_(const char *file, int line)
 {
     GLenum errorCode;
@@ -25,5 +31,6 @@ static GLenum glCheckError_(const char *file, int line)
     return errorCode;
 }
 #define glCheckError() glCheckError_(__FILE__, __LINE__)
+#endif // NDEBUG
 
 #endif // _UTILS_H
@@ -0,0 +1,65 @@
+#ifndef _WORLD_H
+#define _WORLD_H
+
+// Mundo do jogo: as regras, sem OpenGL, GLFW nem relógio do sistema. Faz
+// parte da biblioteca bode_core (alvo "bode_core" do projeto), junto com
+// "level.h", "block.h" e "collisions.h", e pode ser usado sem janela, por
+// exemplo para simular milhares de partidas por segundo ao validar um
+// nível. O executável do jogo usa o mesmo mundo: a cada quadro, transforma o
+// teclado e o tempo passado em entradas para World::step() e desenha o
+// resultado das consultas. Veja "world.cpp".
+
+#include "block.h"
+#include "hazard.h"
+#include "level.h"
+
+// Nenhum movimento em WorldInput::move.
+#define WORLD_NO_MOVE -1
+
+// Eventos de um passo, retornados por World::step() (máscara de bits).
+#define WORLD_EVENT_FAILED 1 // O jogador caiu ou encostou em um perigo, e voltou ao início
+#define WORLD_EVENT_WON    2 // O jogador chegou de pé à saída
+
+struct WorldInput
+{
+    double dt;   // Segundos de jogo que passam neste passo (animação da esfera)
+    int    move; // Movimento do jogador (BlockDirection), ou WORLD_NO_MOVE
+};
+
+class World
+{
+public:
+    // "level" deve existir enquanto o mundo existir, e pode ser compartilhado
+    // por vários mundos (inclusive em threads diferentes). Os perigos são
+    // copiados de "hazards" ou, se for NULL, são os do jogo (veja
+    // HazardSet_LoadDefault()).
+    explicit World(const Level* level, const HazardSet* hazards = NULL);
+
+    // Volta ao início: jogador na célula inicial, tempo zero.
+    void reset();
+
+    // Avança o tempo, move os perigos, aplica o movimento e verifica as
+    // colisões, nessa ordem. Retorna os eventos do passo.
+    unsigned int step(const WorldInput& input);
+
+    const Level* level() const { return m_Level; }
+    BlockState   block() const { return m_Block; }
+    double       time() const { return m_Time; }
+    bool         victory() const { return m_Victory; } // Jogador de pé sobre a saída
+    unsigned long failures() const { return m_Failures; }
+    unsigned long moves() const { return m_Moves; }
+
+    // Perigos, com os centros no instante time().
+    const HazardSet& hazards() const { return m_Hazards; }
+
+private:
+    const Level*  m_Level;
+    HazardSet     m_Hazards;
+    BlockState    m_Block;
+    double        m_Time;
+    bool          m_Victory;
+    unsigned long m_Failures;
+    unsigned long m_Moves;
+};
+
+#endif // _WORLD_H
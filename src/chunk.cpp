@@ -0,0 +1,73 @@
+// Chunks de um nível.
+//
+// Como CHUNK_SIZE divide LEVEL_WORD_BITS, cada linha de um chunk é metade de
+// uma palavra do mapa de bits do nível, copiada com um deslocamento.
+#include <cstring>
+
+#include "chunk.h"
+
+static_assert(LEVEL_WORD_BITS % CHUNK_SIZE == 0, "uma linha de chunk deve caber em uma palavra do nível");
+
+void Chunk_FromLevel(const Level* level, const HazardTable* hazards, int cx, int cz, ChunkData* data)
+{
+    data->cx = cx;
+    data->cz = cz;
+    memset(data->rows, 0, sizeof(data->rows));
+    memset(data->dynamic_rows, 0, sizeof(data->dynamic_rows));
+    data->solid_count = 0;
+    data->dynamic_count = 0;
+    data->exit_x = -1;
+    data->exit_z = -1;
+    data->hazards.clear();
+
+    int x0 = cx * CHUNK_SIZE;
+    int z0 = cz * CHUNK_SIZE;
+    if (cx < 0 || cz < 0 || x0 >= level->width || z0 >= level->depth)
+        return;
+
+    // Sem células dinâmicas, "bits" nunca muda e é o próprio chão fixo.
+    const std::vector<unsigned long long>& floor = level->dynamic.empty() ? level->bits : level->fixed;
+    int word = x0 / LEVEL_WORD_BITS;
+    int shift = x0 % LEVEL_WORD_BITS;
+    for (int z = 0; z < CHUNK_SIZE && z0 + z < level->depth; ++z)
+    {
+        size_t index = (size_t)(z0 + z) * level->stride + word;
+        uint32_t row = (uint32_t)(floor[index] >> shift);
+        data->rows[z] = row;
+        for (uint32_t bits = row; bits != 0; bits &= bits - 1)
+            data->solid_count += 1;
+
+        if (level->dynamic.empty())
+            continue;
+        row = (uint32_t)(level->dynamic[index] >> shift);
+        data->dynamic_rows[z] = row;
+        for (uint32_t bits = row; bits != 0; bits &= bits - 1)
+            data->dynamic_count += 1;
+    }
+
+    if (level->exit_x >> CHUNK_SHIFT == cx && level->exit_z >> CHUNK_SHIFT == cz)
+    {
+        data->exit_x = level->exit_x - x0;
+        data->exit_z = level->exit_z - z0;
+    }
+
+    if (hazards == NULL)
+        return;
+
+    // Um perigo entra na lista se, em algum tick, algum estado atingido do
+    // bloco tiver a sua célula no chunk.
+    for (int h = 0; h < hazards->num_hazards; ++h)
+    {
+        bool inside = false;
+        for (int tick = 0; tick < hazards->num_ticks && !inside; ++tick)
+        {
+            const HazardRect* rect = &hazards->rects[((size_t)tick * hazards->num_hazards + h) * BLOCK_NUM_ORIENTATIONS];
+            for (int o = 0; o < BLOCK_NUM_ORIENTATIONS && !inside; ++o)
+                inside = rect[o].x0 <= rect[o].x1
+                      && rect[o].x1 >= x0 && rect[o].x0 < x0 + CHUNK_SIZE
+                      && rect[o].z1 >= z0 && rect[o].z0 < z0 + CHUNK_SIZE;
+        }
+        if (inside)
+            data->hazards.push_back(h);
+    }
+}
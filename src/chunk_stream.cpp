@@ -0,0 +1,646 @@
+// Carregamento contínuo do chão em chunks.
+//
+// Estado de cada chunk, identificado por ChunkStream_Key(cx, cz):
+//
+//   pedido:     na fila g_ChunkStreamQueue, esperando uma thread de
+//               carregamento (só a thread principal retira pedidos que
+//               deixaram de ser necessários);
+//   carregando: uma thread de carregamento está lendo a fonte e montando a
+//               malha, na memória principal;
+//   pronto:     em g_ChunkStreamDone, esperando o envio para a GPU;
+//   carregado:  em g_ChunkStreamResident, com VAO e buffers próprios.
+//
+// Os três primeiros estados são contados em g_ChunkStreamLoading, que só a
+// thread principal acessa. A fila e a lista de prontos são protegidas por
+// g_ChunkStreamMutex; os chunks carregados pertencem à thread principal.
+//
+// Os chunks carregados viram SceneObjects com VAO próprio, fora da geometria
+// unificada da cena (pool_base_vertex negativo; veja "scene.h"), e são
+// desenhados pelo caminho OpenGL 3.3 do renderizador. As posições e os
+// índices ficam também na memória principal (SceneObject::cpu_positions),
+// para que o chão seja oclusor (veja "occlusion.h").
+//
+// Células dinâmicas: cada uma tem na malha uma caixa completa, com as seis
+// faces, em uma posição fixa após o chão fixo do chunk (a k-ésima célula
+// dinâmica, em ordem de z e depois de x, ocupa os vértices a partir de
+// fixed_vertices + k * CHUNK_TILE_VERTICES). Quando a célula não tem chão,
+// todos os vértices da caixa vão para o mesmo ponto e os triângulos não geram
+// fragmentos. Mudar uma célula é só reescrever as posições da sua caixa, com
+// glBufferSubData(), sem remontar a malha; os índices nunca mudam. As faces
+// do chão fixo encostadas em células dinâmicas nunca são descartadas.
+#include <algorithm>
+#include <cstdlib>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "chunk_stream.h"
+#include "gl_debug.h"
+#include "gl_state.h"
+#include "scene.h"
+
+// Altura do topo e espessura do chão, como nas cópias do cubo desenhadas
+// antes dos chunks: cubo unitário escalado para (1, 0.2, 1) e centrado em
+// y = -0.11.
+#define CHUNK_FLOOR_TOP    (-0.01f)
+#define CHUNK_FLOOR_BOTTOM (-0.21f)
+
+// Memória estimada de um chunk que ainda não terminou de carregar, usada
+// enquanto nenhum chunk foi carregado. Depois, usamos a média dos
+// carregados.
+#define CHUNK_STREAM_DEFAULT_ESTIMATE (256 * 1024)
+
+// Vértices da caixa de uma célula dinâmica: quatro por face.
+#define CHUNK_TILE_VERTICES (6 * 4)
+
+// Chunk carregado pelas threads, ainda na memória principal.
+struct ChunkBuild
+{
+    unsigned long long  key;
+    ChunkData           data;
+    std::vector<float>  model_coefficients;   // X, Y, Z, W
+    std::vector<float>  texture_coefficients; // U, V
+    std::vector<GLuint> indices;
+    int                 fixed_vertices; // Vértices do chão fixo; depois vêm as células dinâmicas
+};
+
+// Chunk carregado, com a malha na GPU.
+struct ChunkResident
+{
+    ChunkData   data;
+    SceneObject object;
+    GLuint      buffers[3]; // Posições, coordenadas de textura e índices
+    size_t      bytes;
+
+    // Cópia das posições e dos índices na memória principal, para o
+    // descarte por oclusão. As caixas das células dinâmicas acompanham as
+    // da GPU.
+    std::vector<float>  positions;
+    std::vector<GLuint> indices;
+
+    // Células dinâmicas: com chão, e com a caixa a reescrever na GPU.
+    int         fixed_vertices;
+    uint32_t    visible_rows[CHUNK_SIZE];
+    uint32_t    dirty_rows[CHUNK_SIZE];
+    bool        dirty;
+};
+
+static ChunkSource    g_ChunkStreamSource;
+static ChunkTileState g_ChunkStreamTileState;
+static size_t      g_ChunkStreamBudget = 0;
+static int         g_ChunkStreamRadius = 0;
+
+// Compartilhados com as threads de carregamento.
+static std::mutex                  g_ChunkStreamMutex;
+static std::condition_variable     g_ChunkStreamWake;
+static std::deque<unsigned long long> g_ChunkStreamQueue;
+static std::vector<ChunkBuild*>    g_ChunkStreamDone;
+static bool                        g_ChunkStreamQuit = false;
+static std::vector<std::thread>*   g_ChunkStreamThreads = NULL;
+
+// Somente da thread principal.
+static std::unordered_map<unsigned long long, ChunkResident> g_ChunkStreamResident;
+static std::unordered_set<unsigned long long>                g_ChunkStreamLoading;
+static std::vector<ChunkBuild*>                              g_ChunkStreamUploads;
+static std::vector<int>                                      g_ChunkStreamHazardRefs;
+static std::vector<unsigned long long>                       g_ChunkStreamDirty;
+static size_t                                                g_ChunkStreamBytes = 0;
+
+static unsigned long long ChunkStream_Key(int cx, int cz)
+{
+    return ((unsigned long long)(unsigned int)cx << 32) | (unsigned int)cz;
+}
+
+static int ChunkStream_KeyX(unsigned long long key) { return (int)(unsigned int)(key >> 32); }
+static int ChunkStream_KeyZ(unsigned long long key) { return (int)(unsigned int)key; }
+
+// Distância, em chunks, na norma do máximo.
+static int ChunkStream_Distance(unsigned long long key, int cx, int cz)
+{
+    return std::max(std::abs(ChunkStream_KeyX(key) - cx), std::abs(ChunkStream_KeyZ(key) - cz));
+}
+
+// Faces do cubo de BuildTriangles() (em "main.cpp"): quatro vértices por
+// face, nos cantos (0 ou 1) indicados, e as coordenadas de textura na mesma
+// ordem. As faces laterais são, nesta ordem, -Z, -X, +Z e +X.
+static const unsigned char g_ChunkFaceCorners[6][4][3] =
+{
+    { {0,0,0}, {1,0,0}, {0,1,0}, {1,1,0} }, // -Z
+    { {0,0,1}, {0,0,0}, {0,1,1}, {0,1,0} }, // -X
+    { {1,0,1}, {0,0,1}, {1,1,1}, {0,1,1} }, // +Z
+    { {1,0,0}, {1,0,1}, {1,1,0}, {1,1,1} }, // +X
+    { {0,0,1}, {1,0,1}, {0,0,0}, {1,0,0} }, // Baixo
+    { {0,1,1}, {1,1,1}, {0,1,0}, {1,1,0} }, // Cima
+};
+static const int g_ChunkFaceNeighbor[4][2] = { {0,-1}, {-1,0}, {0,1}, {1,0} };
+static const float g_ChunkFaceUV[4][2] = { {0,0}, {1,0}, {0,1}, {1,1} };
+
+// Escreve em "out" as posições (X, Y, Z, W) dos quatro vértices da face
+// "face" da caixa da célula (x, z), em coordenadas globais.
+static void ChunkStream_FaceVertices(int x, int z, int face, float* out)
+{
+    for (int v = 0; v < 4; ++v)
+    {
+        const unsigned char* corner = g_ChunkFaceCorners[face][v];
+        *out++ = (float)x - 0.5f + corner[0];
+        *out++ = corner[1] ? CHUNK_FLOOR_TOP : CHUNK_FLOOR_BOTTOM;
+        *out++ = (float)z - 0.5f + corner[2];
+        *out++ = 1.0f;
+    }
+}
+
+// Escreve em "out" as posições dos CHUNK_TILE_VERTICES vértices da caixa da
+// célula dinâmica (x, z), em coordenadas globais. Sem chão, todos ficam no
+// centro do topo da célula.
+static void ChunkStream_TileVertices(int x, int z, bool solid, float* out)
+{
+    for (int face = 0; face < 6; ++face, out += 16)
+    {
+        if (solid)
+        {
+            ChunkStream_FaceVertices(x, z, face, out);
+            continue;
+        }
+        for (int v = 0; v < 4; ++v)
+        {
+            out[v * 4 + 0] = (float)x;
+            out[v * 4 + 1] = CHUNK_FLOOR_TOP;
+            out[v * 4 + 2] = (float)z;
+            out[v * 4 + 3] = 1.0f;
+        }
+    }
+}
+
+// Acrescenta à malha os quatro vértices de uma face, com as posições
+// "positions", e os seus dois triângulos.
+static void ChunkStream_AddFace(ChunkBuild* build, const float* positions)
+{
+    GLuint base = (GLuint)(build->model_coefficients.size() / 4);
+    build->model_coefficients.insert(build->model_coefficients.end(), positions, positions + 16);
+    for (int v = 0; v < 4; ++v)
+    {
+        build->texture_coefficients.push_back(g_ChunkFaceUV[v][0]);
+        build->texture_coefficients.push_back(g_ChunkFaceUV[v][1]);
+    }
+
+    // Mesma ordem de índices do cubo de BuildTriangles().
+    GLuint quad[6] = { base + 0, base + 1, base + 2, base + 1, base + 2, base + 3 };
+    build->indices.insert(build->indices.end(), quad, quad + 6);
+}
+
+// Monta a malha do chão do chunk: uma caixa por célula com chão fixo, exceto
+// a saída (desenhada à parte, transparente), sem as faces laterais encostadas
+// em outra célula com chão fixo do mesmo chunk, e depois uma caixa completa
+// por célula dinâmica, com chão (veja o início do arquivo).
+static void ChunkStream_BuildMesh(ChunkBuild* build)
+{
+    const ChunkData& data = build->data;
+    int x0 = data.cx * CHUNK_SIZE;
+    int z0 = data.cz * CHUNK_SIZE;
+    float positions[CHUNK_TILE_VERTICES * 4];
+
+    for (int z = 0; z < CHUNK_SIZE; ++z)
+    {
+        for (int x = 0; x < CHUNK_SIZE; ++x)
+        {
+            if (!Chunk_IsSolid(&data, x, z) || (x == data.exit_x && z == data.exit_z))
+                continue;
+
+            for (int face = 0; face < 6; ++face)
+            {
+                if (face < 4 && Chunk_IsSolid(&data, x + g_ChunkFaceNeighbor[face][0], z + g_ChunkFaceNeighbor[face][1])
+                    && !(x + g_ChunkFaceNeighbor[face][0] == data.exit_x && z + g_ChunkFaceNeighbor[face][1] == data.exit_z))
+                    continue;
+
+                ChunkStream_FaceVertices(x0 + x, z0 + z, face, positions);
+                ChunkStream_AddFace(build, positions);
+            }
+        }
+    }
+
+    build->fixed_vertices = (int)(build->model_coefficients.size() / 4);
+    for (int z = 0; z < CHUNK_SIZE; ++z)
+    {
+        for (uint32_t bits = data.dynamic_rows[z]; bits != 0; bits &= bits - 1)
+        {
+            ChunkStream_TileVertices(x0 + __builtin_ctz(bits), z0 + z, true, positions);
+            for (int face = 0; face < 6; ++face)
+                ChunkStream_AddFace(build, positions + face * 16);
+        }
+    }
+}
+
+static void ChunkStream_Loader()
+{
+    for (;;)
+    {
+        unsigned long long key;
+        {
+            std::unique_lock<std::mutex> lock(g_ChunkStreamMutex);
+            g_ChunkStreamWake.wait(lock, [] { return g_ChunkStreamQuit || !g_ChunkStreamQueue.empty(); });
+            if (g_ChunkStreamQuit)
+                return;
+            key = g_ChunkStreamQueue.front();
+            g_ChunkStreamQueue.pop_front();
+        }
+
+        ChunkBuild* build = new ChunkBuild();
+        build->key = key;
+        g_ChunkStreamSource(ChunkStream_KeyX(key), ChunkStream_KeyZ(key), &build->data);
+        ChunkStream_BuildMesh(build);
+
+        std::lock_guard<std::mutex> lock(g_ChunkStreamMutex);
+        g_ChunkStreamDone.push_back(build);
+    }
+}
+
+void ChunkStream_Init(const ChunkSource& source, const ChunkTileState& tile_state, size_t memory_budget, int load_radius)
+{
+    g_ChunkStreamSource = source;
+    g_ChunkStreamTileState = tile_state;
+    g_ChunkStreamBudget = memory_budget;
+    g_ChunkStreamRadius = load_radius;
+    g_ChunkStreamQuit = false;
+
+    g_ChunkStreamThreads = new std::vector<std::thread>();
+    for (int i = 0; i < CHUNK_STREAM_LOADER_THREADS; ++i)
+        g_ChunkStreamThreads->push_back(std::thread(ChunkStream_Loader));
+}
+
+static void ChunkStream_Evict(std::unordered_map<unsigned long long, ChunkResident>::iterator it)
+{
+    ChunkResident& chunk = it->second;
+    if (chunk.object.vertex_array_object_id != 0)
+    {
+        glDeleteVertexArrays(1, &chunk.object.vertex_array_object_id);
+        glDeleteBuffers(3, chunk.buffers);
+    }
+
+    for (size_t i = 0; i < chunk.data.hazards.size(); ++i)
+        g_ChunkStreamHazardRefs[chunk.data.hazards[i]] -= 1;
+
+    g_ChunkStreamBytes -= chunk.bytes;
+    g_ChunkStreamResident.erase(it);
+}
+
+void ChunkStream_Terminate()
+{
+    if (!g_ChunkStreamThreads)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(g_ChunkStreamMutex);
+        g_ChunkStreamQuit = true;
+    }
+    g_ChunkStreamWake.notify_all();
+
+    for (size_t i = 0; i < g_ChunkStreamThreads->size(); ++i)
+        (*g_ChunkStreamThreads)[i].join();
+    delete g_ChunkStreamThreads;
+    g_ChunkStreamThreads = NULL;
+
+    g_ChunkStreamQueue.clear();
+    for (size_t i = 0; i < g_ChunkStreamDone.size(); ++i)
+        delete g_ChunkStreamDone[i];
+    g_ChunkStreamDone.clear();
+    for (size_t i = 0; i < g_ChunkStreamUploads.size(); ++i)
+        delete g_ChunkStreamUploads[i];
+    g_ChunkStreamUploads.clear();
+
+    while (!g_ChunkStreamResident.empty())
+        ChunkStream_Evict(g_ChunkStreamResident.begin());
+    g_ChunkStreamLoading.clear();
+    g_ChunkStreamDirty.clear();
+    g_ChunkStreamSource = ChunkSource();
+    g_ChunkStreamTileState = ChunkTileState();
+}
+
+// Envia a malha do chunk para a GPU, em um VAO com os mesmos atributos dos
+// demais objetos (veja "shader_vertex.glsl").
+static void ChunkStream_Upload(ChunkBuild* build)
+{
+    ChunkResident chunk;
+    chunk.data = build->data;
+    chunk.bytes = sizeof(ChunkResident)
+                + build->model_coefficients.size() * sizeof(float) * 2 // Na GPU e na cópia
+                + build->texture_coefficients.size() * sizeof(float)
+                + build->indices.size() * sizeof(GLuint) * 2;
+
+    SceneObject& object = chunk.object;
+    object.name = "Chunk";
+    object.first_index = 0;
+    object.num_indices = build->indices.size();
+    object.rendering_mode = GL_TRIANGLES;
+    object.vertex_array_object_id = 0;
+    object.pool_first_index = 0;
+    object.pool_base_vertex = -1; // Fora de g_SceneGeometry
+    object.num_lods = 1;
+    object.lod_first_index[0] = 0;
+    object.lod_num_indices[0] = object.num_indices;
+    object.lod_first_meshlet[0] = 0;
+    object.lod_num_meshlets[0] = 0;
+    object.revision = 0;
+    SceneObject_ComputeBounds(&object, build->model_coefficients.data(), build->indices.data(), build->indices.size());
+
+    // As células dinâmicas foram montadas com chão; as que estão sem chão
+    // agora são escondidas antes do envio. Os volumes envolventes já
+    // incluem todas as caixas.
+    chunk.fixed_vertices = build->fixed_vertices;
+    chunk.dirty = false;
+    memset(chunk.dirty_rows, 0, sizeof(chunk.dirty_rows));
+    float* tile = build->model_coefficients.data() + (size_t)build->fixed_vertices * 4;
+    for (int z = 0; z < CHUNK_SIZE; ++z)
+    {
+        chunk.visible_rows[z] = 0;
+        for (uint32_t bits = build->data.dynamic_rows[z]; bits != 0; bits &= bits - 1, tile += CHUNK_TILE_VERTICES * 4)
+        {
+            int x = __builtin_ctz(bits);
+            int global_x = build->data.cx * CHUNK_SIZE + x;
+            int global_z = build->data.cz * CHUNK_SIZE + z;
+            if (g_ChunkStreamTileState(global_x, global_z))
+                chunk.visible_rows[z] |= 1u << x;
+            else
+                ChunkStream_TileVertices(global_x, global_z, false, tile);
+        }
+    }
+
+    if (!build->indices.empty())
+    {
+        glGenVertexArrays(1, &object.vertex_array_object_id);
+        glBindVertexArray(object.vertex_array_object_id);
+        glGenBuffers(3, chunk.buffers);
+
+        glBindBuffer(GL_ARRAY_BUFFER, chunk.buffers[0]);
+        glBufferData(GL_ARRAY_BUFFER, build->model_coefficients.size() * sizeof(float), build->model_coefficients.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0); // "(location = 0)" em "shader_vertex.glsl"
+        glEnableVertexAttribArray(0);
+
+        glBindBuffer(GL_ARRAY_BUFFER, chunk.buffers[1]);
+        glBufferData(GL_ARRAY_BUFFER, build->texture_coefficients.size() * sizeof(float), build->texture_coefficients.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, 0); // "(location = 1)" em "shader_vertex.glsl"
+        glEnableVertexAttribArray(1);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chunk.buffers[2]);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, build->indices.size() * sizeof(GLuint), build->indices.data(), GL_STATIC_DRAW);
+        glBindVertexArray(0);
+
+        char label[64];
+        snprintf(label, sizeof(label), "chunk (%d, %d)", build->data.cx, build->data.cz);
+        GLDebug_Label(GL_VERTEX_ARRAY, object.vertex_array_object_id, label);
+    }
+
+    for (size_t i = 0; i < chunk.data.hazards.size(); ++i)
+    {
+        int hazard = chunk.data.hazards[i];
+        if (hazard >= (int)g_ChunkStreamHazardRefs.size())
+            g_ChunkStreamHazardRefs.resize(hazard + 1, 0);
+        g_ChunkStreamHazardRefs[hazard] += 1;
+    }
+
+    g_ChunkStreamBytes += chunk.bytes;
+    chunk.positions.swap(build->model_coefficients);
+    chunk.indices.swap(build->indices);
+    ChunkResident& resident = g_ChunkStreamResident[build->key];
+    resident = std::move(chunk);
+    resident.object.cpu_positions = resident.positions.data();
+    resident.object.cpu_indices = resident.indices.data();
+}
+
+// Envia para a GPU as caixas das células dinâmicas first_slot a last_slot,
+// da cópia na memória principal.
+static void ChunkStream_UploadTiles(const ChunkResident& chunk, int first_slot, int last_slot)
+{
+    size_t first = ((size_t)chunk.fixed_vertices + (size_t)first_slot * CHUNK_TILE_VERTICES) * 4;
+    size_t count = (size_t)(last_slot - first_slot + 1) * CHUNK_TILE_VERTICES * 4;
+    glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(float), count * sizeof(float), &chunk.positions[first]);
+}
+
+// Reescreve as caixas das células dinâmicas alteradas desde o último quadro,
+// na cópia e na GPU. Caixas vizinhas na malha são enviadas em uma só
+// chamada.
+static void ChunkStream_FlushTiles()
+{
+    for (size_t i = 0; i < g_ChunkStreamDirty.size(); ++i)
+    {
+        std::unordered_map<unsigned long long, ChunkResident>::iterator it = g_ChunkStreamResident.find(g_ChunkStreamDirty[i]);
+        if (it == g_ChunkStreamResident.end())
+            continue;
+
+        ChunkResident& chunk = it->second;
+        chunk.dirty = false;
+        chunk.object.revision += 1; // A camada estática em cache mostra a malha antiga
+        glBindBuffer(GL_ARRAY_BUFFER, chunk.buffers[0]);
+
+        int slot = 0;        // Caixa da célula atual
+        int first_slot = -1; // Primeira e última caixas do grupo ainda não enviado
+        int last_slot = -1;
+        for (int z = 0; z < CHUNK_SIZE; ++z)
+        {
+            for (uint32_t bits = chunk.data.dynamic_rows[z]; bits != 0; bits &= bits - 1, ++slot)
+            {
+                int x = __builtin_ctz(bits);
+                if (!((chunk.dirty_rows[z] >> x) & 1))
+                    continue;
+
+                if (first_slot >= 0 && last_slot + 1 != slot)
+                {
+                    ChunkStream_UploadTiles(chunk, first_slot, last_slot);
+                    first_slot = -1;
+                }
+                if (first_slot < 0)
+                    first_slot = slot;
+                last_slot = slot;
+
+                float* tile = &chunk.positions[((size_t)chunk.fixed_vertices + (size_t)slot * CHUNK_TILE_VERTICES) * 4];
+                ChunkStream_TileVertices(chunk.data.cx * CHUNK_SIZE + x, chunk.data.cz * CHUNK_SIZE + z,
+                                         (chunk.visible_rows[z] >> x) & 1, tile);
+            }
+            chunk.dirty_rows[z] = 0;
+        }
+
+        if (first_slot >= 0)
+            ChunkStream_UploadTiles(chunk, first_slot, last_slot);
+    }
+
+    if (!g_ChunkStreamDirty.empty())
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    g_ChunkStreamDirty.clear();
+}
+
+void ChunkStream_SetTile(int x, int z, bool solid)
+{
+    // Um chunk que não está carregado consulta o estado atual no envio.
+    std::unordered_map<unsigned long long, ChunkResident>::iterator it =
+        g_ChunkStreamResident.find(ChunkStream_Key(x >> CHUNK_SHIFT, z >> CHUNK_SHIFT));
+    if (it == g_ChunkStreamResident.end())
+        return;
+
+    ChunkResident& chunk = it->second;
+    int local_x = x & (CHUNK_SIZE - 1);
+    int local_z = z & (CHUNK_SIZE - 1);
+    if (!Chunk_IsDynamic(&chunk.data, local_x, local_z) || (bool)((chunk.visible_rows[local_z] >> local_x) & 1) == solid)
+        return;
+
+    chunk.visible_rows[local_z] ^= 1u << local_x;
+    chunk.dirty_rows[local_z] |= 1u << local_x;
+    if (!chunk.dirty)
+    {
+        chunk.dirty = true;
+        g_ChunkStreamDirty.push_back(it->first);
+    }
+}
+
+void ChunkStream_Update(int x, int z)
+{
+    ChunkStream_FlushTiles();
+
+    int center_x = x >> CHUNK_SHIFT;
+    int center_z = z >> CHUNK_SHIFT;
+
+    // Pedidos que ainda não começaram e ficaram longe são cancelados; malhas
+    // prontas passam para a fila de envio.
+    {
+        std::lock_guard<std::mutex> lock(g_ChunkStreamMutex);
+        for (size_t i = 0; i < g_ChunkStreamQueue.size(); )
+        {
+            if (ChunkStream_Distance(g_ChunkStreamQueue[i], center_x, center_z) > g_ChunkStreamRadius)
+            {
+                g_ChunkStreamLoading.erase(g_ChunkStreamQueue[i]);
+                g_ChunkStreamQueue.erase(g_ChunkStreamQueue.begin() + i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        g_ChunkStreamUploads.insert(g_ChunkStreamUploads.end(), g_ChunkStreamDone.begin(), g_ChunkStreamDone.end());
+        g_ChunkStreamDone.clear();
+    }
+
+    // Envio para a GPU, dos mais próximos para os mais distantes.
+    std::sort(g_ChunkStreamUploads.begin(), g_ChunkStreamUploads.end(), [&](const ChunkBuild* a, const ChunkBuild* b) {
+        return ChunkStream_Distance(a->key, center_x, center_z) < ChunkStream_Distance(b->key, center_x, center_z);
+    });
+    size_t num_uploads = std::min(g_ChunkStreamUploads.size(), (size_t)CHUNK_STREAM_UPLOADS_PER_FRAME);
+    for (size_t i = 0; i < num_uploads; ++i)
+    {
+        ChunkBuild* build = g_ChunkStreamUploads[i];
+        g_ChunkStreamLoading.erase(build->key);
+        ChunkStream_Upload(build);
+        delete build;
+    }
+    g_ChunkStreamUploads.erase(g_ChunkStreamUploads.begin(), g_ChunkStreamUploads.begin() + num_uploads);
+
+    // Acima do limite: descartamos os chunks mais distantes, primeiro os que
+    // estão fora do raio. Os mais próximos nunca são descartados para dar
+    // lugar aos mais distantes, já que só pedimos chunks abaixo do limite.
+    while (g_ChunkStreamBytes > g_ChunkStreamBudget && !g_ChunkStreamResident.empty())
+    {
+        std::unordered_map<unsigned long long, ChunkResident>::iterator farthest = g_ChunkStreamResident.begin();
+        for (std::unordered_map<unsigned long long, ChunkResident>::iterator it = g_ChunkStreamResident.begin(); it != g_ChunkStreamResident.end(); ++it)
+            if (ChunkStream_Distance(it->first, center_x, center_z) > ChunkStream_Distance(farthest->first, center_x, center_z))
+                farthest = it;
+
+        // O chunk do jogador fica, mesmo acima do limite.
+        if (ChunkStream_Distance(farthest->first, center_x, center_z) == 0)
+            break;
+        ChunkStream_Evict(farthest);
+    }
+
+    // Pedimos os chunks que faltam no raio, em anéis a partir do jogador,
+    // enquanto a memória estimada (carregados mais pedidos) couber no limite.
+    // Um pedido que não cabe não é feito: se fosse, o chunk seria descartado
+    // logo depois de carregado, e pedido de novo no quadro seguinte. O chunk
+    // do jogador é sempre pedido.
+    size_t estimate = g_ChunkStreamResident.empty() ? (size_t)CHUNK_STREAM_DEFAULT_ESTIMATE
+                                                    : g_ChunkStreamBytes / g_ChunkStreamResident.size();
+    size_t expected = g_ChunkStreamBytes + g_ChunkStreamLoading.size() * estimate;
+    std::vector<unsigned long long> requests;
+    bool full = false;
+    for (int ring = 0; ring <= g_ChunkStreamRadius && !full; ++ring)
+    {
+        for (int dz = -ring; dz <= ring && !full; ++dz)
+        {
+            for (int dx = -ring; dx <= ring && !full; ++dx)
+            {
+                if (std::max(std::abs(dx), std::abs(dz)) != ring)
+                    continue;
+
+                unsigned long long key = ChunkStream_Key(center_x + dx, center_z + dz);
+                if (g_ChunkStreamResident.count(key) || g_ChunkStreamLoading.count(key))
+                    continue;
+
+                if (ring > 0 && expected + estimate > g_ChunkStreamBudget)
+                {
+                    full = true;
+                    continue;
+                }
+
+                g_ChunkStreamLoading.insert(key);
+                requests.push_back(key);
+                expected += estimate;
+            }
+        }
+    }
+
+    if (!requests.empty())
+    {
+        {
+            std::lock_guard<std::mutex> lock(g_ChunkStreamMutex);
+            g_ChunkStreamQueue.insert(g_ChunkStreamQueue.end(), requests.begin(), requests.end());
+        }
+        g_ChunkStreamWake.notify_all();
+    }
+}
+
+void ChunkStream_AppendDrawItems(std::vector<DrawItem>* items, GLuint texture)
+{
+    for (std::unordered_map<unsigned long long, ChunkResident>::const_iterator it = g_ChunkStreamResident.begin(); it != g_ChunkStreamResident.end(); ++it)
+    {
+        if (it->second.object.num_indices == 0)
+            continue;
+
+        // A malha já está em coordenadas globais. O chão é oclusor, com os
+        // triângulos da cópia na memória principal.
+        DrawItem item = { &it->second.object, glm::mat4(1.0f), texture, RENDER_PASS_OPAQUE, NULL, NULL, true, true, 1.0f };
+        items->push_back(item);
+    }
+}
+
+bool ChunkStream_IsSolid(int x, int z)
+{
+    std::unordered_map<unsigned long long, ChunkResident>::const_iterator it =
+        g_ChunkStreamResident.find(ChunkStream_Key(x >> CHUNK_SHIFT, z >> CHUNK_SHIFT));
+    if (it == g_ChunkStreamResident.end())
+        return false;
+    int local_x = x & (CHUNK_SIZE - 1);
+    int local_z = z & (CHUNK_SIZE - 1);
+    return Chunk_IsSolid(&it->second.data, local_x, local_z) || ((it->second.visible_rows[local_z] >> local_x) & 1);
+}
+
+bool ChunkStream_IsHazardResident(int hazard)
+{
+    return hazard < (int)g_ChunkStreamHazardRefs.size() && g_ChunkStreamHazardRefs[hazard] > 0;
+}
+
+bool ChunkStream_IsLoading()
+{
+    return !g_ChunkStreamLoading.empty();
+}
+
+ChunkStreamStats ChunkStream_GetStats()
+{
+    ChunkStreamStats stats;
+    stats.resident_chunks = (unsigned int)g_ChunkStreamResident.size();
+    stats.pending_chunks = (unsigned int)g_ChunkStreamLoading.size();
+    stats.resident_bytes = g_ChunkStreamBytes;
+    return stats;
+}
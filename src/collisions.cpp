@@ -1,71 +1,56 @@
 #include "collisions.h"
-extern int block_position;
-extern float g_PositionX;
-extern float g_PositionZ;
-extern float g_PositionY;
 
-bool plane_collision()
+bool plane_collision(const Level* level, BlockState block)
 {
-    if (block_position == 1) {
-        // Bloco está de pé
-        if (g_PositionZ == 0 && g_PositionX >= 0 && g_PositionX <= 2) return false;
-        if (g_PositionZ == 1 && g_PositionX >= 0 && g_PositionX <= 5) return false;
-        if (g_PositionZ == 2 && g_PositionX >= 0 && g_PositionX <= 8) return false;
-        if (g_PositionZ == 3 && g_PositionX >= 1 && g_PositionX <= 9) return false;
-        if (g_PositionZ == 4 && g_PositionX >= 5 && g_PositionX <= 9) return false;
-        if (g_PositionZ == 5 && g_PositionX >= 6 && g_PositionX <= 8) return false;
-    } 
-    
-    else if (block_position == 2) {
-        // Bloco está deitado paralelo ao eixo Z
-        if (g_PositionZ == 0.5 && g_PositionX >= 0 && g_PositionX <= 2) return false;
-        if (g_PositionZ == 1.5 && g_PositionX >= 0 && g_PositionX <= 5) return false;
-        if (g_PositionZ == 2.5 && g_PositionX >= 1 && g_PositionX <= 8) return false;
-        if (g_PositionZ == 3.5 && g_PositionX >= 5 && g_PositionX <= 9) return false;
-        if (g_PositionZ == 4.5 && g_PositionX >= 6 && g_PositionX <= 8) return false;
-    }
-    
-    else if (block_position == 3) {
-        // Bloco está deitado paralelo ao eixo X
-        if (g_PositionZ == 0 && g_PositionX >= 0.5 && g_PositionX <= 1.5) return false;
-        if (g_PositionZ == 1 && g_PositionX >= 0.5 && g_PositionX <= 4.5) return false;
-        if (g_PositionZ == 2 && g_PositionX >= 0.5 && g_PositionX <= 7.5) return false;
-        if (g_PositionZ == 3 && g_PositionX >= 1.5 && g_PositionX <= 8.5) return false;
-        if (g_PositionZ == 4 && g_PositionX >= 5.5 && g_PositionX <= 8.5) return false;
-        if (g_PositionZ == 5 && g_PositionX >= 6.5 && g_PositionX <= 7.5) return false;
-    } 
-    
-    return true;
+    // O bloco cai se alguma das células sob ele não tem chão.
+    int cells_x[2], cells_z[2];
+    int count = Block_GetCells(block, cells_x, cells_z);
+    for (int i = 0; i < count; ++i)
+        if (!Level_IsSolid(level, cells_x[i], cells_z[i])) return true;
+
+    return false;
 }
 
 
-bool sphere_collision()
+bool sphere_collision(BlockState block, float sphere_x, float sphere_z)
+{
+    return hazard_collision(block, sphere_x, sphere_z, COLLISION_SPHERE_RADIUS);
+}
+
+bool hazard_collision(BlockState block, float x, float z, float radius)
 {
-    if (g_sphere_position_z - g_PositionZ < 1.0 && g_sphere_position_z - g_PositionZ > -1.0) {
+    float block_x, block_y, block_z;
+    Block_GetCenter(block, &block_x, &block_y, &block_z);
+
+    // Zero para a esfera: as comparações são exatamente as de antes.
+    double grow = radius - COLLISION_SPHERE_RADIUS;
+
+    if (z - block_z < 1.0 + grow && z - block_z > -1.0 - grow) {
 
-        if (block_position == 1)
+        if (block.orientation == BLOCK_STANDING)
         {
             // Bloco está de pé
-            if (g_sphere_position_x - g_PositionX <= 0.8 && g_sphere_position_x - g_PositionX >= -0.8) return true;
+            if (x - block_x <= 0.8 + grow && x - block_x >= -0.8 - grow) return true;
         } 
     
-        else if (block_position == 2) {
+        else if (block.orientation == BLOCK_LYING_Z) {
             // Bloco está deitado paralelo ao eixo Z
-            if (g_sphere_position_x - g_PositionX <= 0.5 && g_sphere_position_x - g_PositionX >= -0.5) return true;
+            if (x - block_x <= 0.5 + grow && x - block_x >= -0.5 - grow) return true;
         }
     
-        else if (block_position == 3) {
+        else if (block.orientation == BLOCK_LYING_X) {
             // Bloco está deitado paralelo ao eixo X
-            if (g_sphere_position_x - g_PositionX < 1.0 && g_sphere_position_x - g_PositionX > -1.0) return true;
+            if (x - block_x < 1.0 + grow && x - block_x > -1.0 - grow) return true;
         }
     } 
     
     return false;
 }
 
-bool victory_cube_collision()
+bool victory_cube_collision(const Level* level, BlockState block)
 {
-    if (block_position == 1.0f && g_PositionX == 7.0f && g_PositionZ == 4.0f) return true;
+    int cells_x[2], cells_z[2];
+    if (Block_GetCells(block, cells_x, cells_z) == 1 && cells_x[0] == level->exit_x && cells_z[0] == level->exit_z) return true;
 
     return false;
 }
@@ -0,0 +1,179 @@
+// Descarte de objetos fora do frustum (view-frustum culling).
+//
+// Os planos são extraídos diretamente da matriz projection * view (método de
+// Gribb e Hartmann): em coordenadas de recorte, um ponto está dentro do
+// volume de visualização se -w <= x <= w, -w <= y <= w e -w <= z <= w. Cada
+// uma destas seis desigualdades, escrita em função das linhas da matriz,
+// é a equação de um plano em coordenadas globais.
+//
+// O descarte por cone de normais segue Zeux ("meshoptimizer",
+// meshopt_computeClusterBounds()): se todas as normais de um grupo estão
+// dentro de um cone de eixo "a" e semiângulo "alfa", e o grupo está dentro de
+// uma esfera de centro "c" e raio "r", todos os triângulos estão de costas
+// para a câmera em "p" quando
+//
+//     dot(c - p, a) >= sin(alfa) * |c - p| + r
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CULLING_USE_SSE
+#endif
+
+#include <glm/matrix.hpp>
+
+#include "culling.h"
+
+Frustum Culling_ExtractFrustum(const glm::mat4& M)
+{
+    // Linhas da matriz. GLM armazena as matrizes por colunas: M[coluna][linha].
+    glm::vec4 row0(M[0][0], M[1][0], M[2][0], M[3][0]);
+    glm::vec4 row1(M[0][1], M[1][1], M[2][1], M[3][1]);
+    glm::vec4 row2(M[0][2], M[1][2], M[2][2], M[3][2]);
+    glm::vec4 row3(M[0][3], M[1][3], M[2][3], M[3][3]);
+
+    Frustum frustum;
+    frustum.planes[0] = row3 + row0; // left
+    frustum.planes[1] = row3 - row0; // right
+    frustum.planes[2] = row3 + row1; // bottom
+    frustum.planes[3] = row3 - row1; // top
+    frustum.planes[4] = row3 + row2; // near
+    frustum.planes[5] = row3 - row2; // far
+
+    // Normalizamos os planos, para que a*x + b*y + c*z + d seja a distância
+    // com sinal até o plano, comparável com o raio das esferas.
+    for (int i = 0; i < 6; ++i)
+    {
+        glm::vec4& p = frustum.planes[i];
+        float length = std::sqrt(p.x*p.x + p.y*p.y + p.z*p.z);
+        p /= length;
+    }
+
+    return frustum;
+}
+
+Frustum Culling_TransformFrustum(const Frustum& frustum, const glm::mat4& model)
+{
+    // Um ponto local x está no lado positivo do plano P (global) se
+    // dot(P, model * x) >= 0, isto é, se dot(transpose(model) * P, x) >= 0.
+    glm::mat4 model_t = glm::transpose(model);
+
+    Frustum local;
+    for (int i = 0; i < 6; ++i)
+    {
+        glm::vec4 p = model_t * frustum.planes[i];
+        float length = std::sqrt(p.x*p.x + p.y*p.y + p.z*p.z);
+        local.planes[i] = p / length;
+    }
+
+    return local;
+}
+
+size_t Culling_TestSpheres(const Frustum& frustum,
+                           const float* x, const float* y, const float* z, const float* radius,
+                           size_t count, unsigned char* visible)
+{
+    size_t num_visible = 0;
+    size_t i = 0;
+
+#ifdef CULLING_USE_SSE
+    // Quatro esferas por iteração: cada registrador contém a mesma
+    // coordenada de quatro esferas diferentes.
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(x + i);
+        __m128 cy = _mm_loadu_ps(y + i);
+        __m128 cz = _mm_loadu_ps(z + i);
+        __m128 minus_r = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; ++p)
+        {
+            const glm::vec4& plane = frustum.planes[p];
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)), _mm_mul_ps(cy, _mm_set1_ps(plane.y))),
+                _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+
+            // A esfera está fora se estiver inteiramente atrás de algum plano.
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, minus_r));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        for (int k = 0; k < 4; ++k)
+        {
+            visible[i + k] = (mask >> k) & 1;
+            num_visible += visible[i + k];
+        }
+    }
+#endif
+
+    // Esferas restantes (ou todas, sem SSE).
+    for (; i < count; ++i)
+    {
+        bool inside = true;
+        for (int p = 0; p < 6 && inside; ++p)
+        {
+            const glm::vec4& plane = frustum.planes[p];
+            float distance = plane.x*x[i] + plane.y*y[i] + plane.z*z[i] + plane.w;
+            inside = distance >= -radius[i];
+        }
+
+        visible[i] = inside ? 1 : 0;
+        num_visible += visible[i];
+    }
+
+    return num_visible;
+}
+
+size_t Culling_TestCones(const glm::vec3& camera_position,
+                         const float* x, const float* y, const float* z, const float* radius,
+                         const float* axis_x, const float* axis_y, const float* axis_z, const float* cutoff,
+                         size_t count, unsigned char* visible)
+{
+    size_t num_visible = 0;
+    size_t i = 0;
+
+#ifdef CULLING_USE_SSE
+    __m128 px = _mm_set1_ps(camera_position.x);
+    __m128 py = _mm_set1_ps(camera_position.y);
+    __m128 pz = _mm_set1_ps(camera_position.z);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(x + i), px);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(y + i), py);
+        __m128 dz = _mm_sub_ps(_mm_loadu_ps(z + i), pz);
+
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, _mm_loadu_ps(axis_x + i)),
+                                           _mm_mul_ps(dy, _mm_loadu_ps(axis_y + i))),
+                                _mm_mul_ps(dz, _mm_loadu_ps(axis_z + i)));
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+        __m128 limit = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(cutoff + i), distance), _mm_loadu_ps(radius + i));
+
+        int backfacing = _mm_movemask_ps(_mm_cmpge_ps(dot, limit));
+        for (int k = 0; k < 4; ++k)
+        {
+            if ((backfacing >> k) & 1)
+                visible[i + k] = 0;
+            num_visible += visible[i + k] != 0;
+        }
+    }
+#endif
+
+    // Grupos restantes (ou todos, sem SSE).
+    for (; i < count; ++i)
+    {
+        float dx = x[i] - camera_position.x;
+        float dy = y[i] - camera_position.y;
+        float dz = z[i] - camera_position.z;
+
+        float dot = dx*axis_x[i] + dy*axis_y[i] + dz*axis_z[i];
+        float distance = std::sqrt(dx*dx + dy*dy + dz*dz);
+        if (dot >= cutoff[i] * distance + radius[i])
+            visible[i] = 0;
+
+        num_visible += visible[i] != 0;
+    }
+
+    return num_visible;
+}
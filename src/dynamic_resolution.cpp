@@ -0,0 +1,177 @@
+// Resolução dinâmica.
+//
+// As texturas da cena são temporárias do grafo de renderização, com a
+// resolução da janela (veja "render_graph.h"), e a cena é renderizada somente
+// no seu canto inferior esquerdo, com largura * escala x altura * escala
+// pixels; assim mudar a escala não exige realocar nada. Ao final,
+// glBlitFramebuffer() amplia este retângulo para a janela inteira, com filtro
+// bilinear.
+//
+// O tempo de GPU de cada quadro é medido com consultas GL_TIME_ELAPSED
+// (OpenGL 3.3). O resultado de uma consulta só fica disponível alguns quadros
+// depois, e esperar por ele pararia a CPU até a GPU terminar; por isso usamos
+// um anel de consultas e só lemos as que já estão prontas.
+//
+// A cada DYNAMIC_RESOLUTION_INTERVAL medições, o controlador compara o tempo
+// médio com o orçamento. Como o custo da cena é dominado pelo número de
+// pixels, que é proporcional ao quadrado da escala, a escala ideal é
+//
+//     escala * sqrt(orçamento / tempo)
+//
+// O passo é limitado, e há uma faixa morta abaixo do orçamento, para que a
+// resolução não oscile a cada ajuste.
+#include <cmath>
+#include <algorithm>
+
+#include <glad/glad.h>
+
+#include "dynamic_resolution.h"
+
+// Orçamento de tempo de GPU da cena, em milissegundos: um pouco abaixo de
+// um quadro a 60 Hz, deixando margem para o texto e a ampliação.
+#define DYNAMIC_RESOLUTION_TARGET_MS 14.0f
+
+// A escala só aumenta quando o tempo está abaixo desta fração do orçamento.
+#define DYNAMIC_RESOLUTION_DEAD_BAND 0.8f
+
+// Limites da escala e maior variação relativa por ajuste.
+#define DYNAMIC_RESOLUTION_MIN_SCALE 0.5f
+#define DYNAMIC_RESOLUTION_MAX_SCALE 1.0f
+#define DYNAMIC_RESOLUTION_MAX_STEP  0.1f
+
+// Número de medições entre ajustes.
+#define DYNAMIC_RESOLUTION_INTERVAL 8
+
+// Número de consultas em voo.
+#define DYNAMIC_RESOLUTION_QUERIES 4
+
+static int g_DynamicResolutionWidth  = 0; // Tamanho da janela
+static int g_DynamicResolutionHeight = 0;
+
+static int g_DynamicResolutionSceneWidth  = 0; // Tamanho da cena no quadro atual
+static int g_DynamicResolutionSceneHeight = 0;
+
+static float g_DynamicResolutionScale = 1.0f;
+
+// Anel de consultas: as consultas de g_DynamicResolutionQueryFirst em diante
+// (g_DynamicResolutionQueryCount delas) aguardam resultado.
+static GLuint   g_DynamicResolutionQueries[DYNAMIC_RESOLUTION_QUERIES];
+static unsigned g_DynamicResolutionQueryFirst = 0;
+static unsigned g_DynamicResolutionQueryCount = 0;
+static bool     g_DynamicResolutionQueryActive = false;
+
+// Medições acumuladas desde o último ajuste, e média do último ajuste.
+static double g_DynamicResolutionSampleSum = 0.0;
+static int    g_DynamicResolutionSampleCount = 0;
+static float  g_DynamicResolutionGpuMilliseconds = 0.0f;
+
+void DynamicResolution_Init()
+{
+    glGenQueries(DYNAMIC_RESOLUTION_QUERIES, g_DynamicResolutionQueries);
+}
+
+void DynamicResolution_Resize(int width, int height)
+{
+    g_DynamicResolutionWidth  = width;
+    g_DynamicResolutionHeight = height;
+}
+
+void DynamicResolution_SetViewport()
+{
+    glViewport(0, 0, g_DynamicResolutionSceneWidth, g_DynamicResolutionSceneHeight);
+}
+
+void DynamicResolution_BeginScene()
+{
+    if (g_DynamicResolutionWidth <= 0 || g_DynamicResolutionHeight <= 0)
+        return;
+
+    g_DynamicResolutionSceneWidth  = std::max(1, (int)(g_DynamicResolutionWidth  * g_DynamicResolutionScale + 0.5f));
+    g_DynamicResolutionSceneHeight = std::max(1, (int)(g_DynamicResolutionHeight * g_DynamicResolutionScale + 0.5f));
+
+    DynamicResolution_SetViewport();
+
+    // Se todas as consultas ainda aguardam resultado, este quadro não é
+    // medido.
+    g_DynamicResolutionQueryActive = g_DynamicResolutionQueryCount < DYNAMIC_RESOLUTION_QUERIES;
+    if (g_DynamicResolutionQueryActive)
+    {
+        unsigned slot = (g_DynamicResolutionQueryFirst + g_DynamicResolutionQueryCount) % DYNAMIC_RESOLUTION_QUERIES;
+        glBeginQuery(GL_TIME_ELAPSED, g_DynamicResolutionQueries[slot]);
+    }
+}
+
+// Lê as consultas já prontas e, a cada DYNAMIC_RESOLUTION_INTERVAL medições,
+// ajusta a escala.
+static void DynamicResolution_Update()
+{
+    while (g_DynamicResolutionQueryCount > 0)
+    {
+        GLuint query = g_DynamicResolutionQueries[g_DynamicResolutionQueryFirst];
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+        g_DynamicResolutionSampleSum   += nanoseconds * 1e-6;
+        g_DynamicResolutionSampleCount += 1;
+
+        g_DynamicResolutionQueryFirst = (g_DynamicResolutionQueryFirst + 1) % DYNAMIC_RESOLUTION_QUERIES;
+        g_DynamicResolutionQueryCount -= 1;
+    }
+
+    if (g_DynamicResolutionSampleCount < DYNAMIC_RESOLUTION_INTERVAL)
+        return;
+
+    float milliseconds = (float)(g_DynamicResolutionSampleSum / g_DynamicResolutionSampleCount);
+    g_DynamicResolutionGpuMilliseconds = milliseconds;
+    g_DynamicResolutionSampleSum   = 0.0;
+    g_DynamicResolutionSampleCount = 0;
+
+    if (milliseconds <= 0.0f)
+        return;
+    if (milliseconds <= DYNAMIC_RESOLUTION_TARGET_MS && milliseconds >= DYNAMIC_RESOLUTION_DEAD_BAND * DYNAMIC_RESOLUTION_TARGET_MS)
+        return;
+
+    float factor = std::sqrt(DYNAMIC_RESOLUTION_TARGET_MS / milliseconds);
+    factor = std::min(std::max(factor, 1.0f - DYNAMIC_RESOLUTION_MAX_STEP), 1.0f + DYNAMIC_RESOLUTION_MAX_STEP);
+    g_DynamicResolutionScale = std::min(std::max(g_DynamicResolutionScale * factor, DYNAMIC_RESOLUTION_MIN_SCALE), DYNAMIC_RESOLUTION_MAX_SCALE);
+}
+
+void DynamicResolution_EndScene()
+{
+    if (g_DynamicResolutionWidth <= 0 || g_DynamicResolutionHeight <= 0)
+        return;
+
+    if (g_DynamicResolutionQueryActive)
+    {
+        glEndQuery(GL_TIME_ELAPSED);
+        g_DynamicResolutionQueryCount += 1;
+        g_DynamicResolutionQueryActive = false;
+    }
+
+    DynamicResolution_Update();
+}
+
+void DynamicResolution_Upscale()
+{
+    if (g_DynamicResolutionSceneWidth <= 0 || g_DynamicResolutionSceneHeight <= 0)
+        return;
+
+    // Com escala 1 o filtro não tem efeito.
+    glBlitFramebuffer(0, 0, g_DynamicResolutionSceneWidth, g_DynamicResolutionSceneHeight,
+                      0, 0, g_DynamicResolutionWidth, g_DynamicResolutionHeight,
+                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+}
+
+float DynamicResolution_GetScale()
+{
+    return g_DynamicResolutionScale;
+}
+
+float DynamicResolution_GetGpuMilliseconds()
+{
+    return g_DynamicResolutionGpuMilliseconds;
+}
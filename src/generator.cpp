@@ -0,0 +1,177 @@
+// Gerador de níveis.
+//
+// Um candidato começa vazio. O bloco parte de uma célula sorteada e dá
+// params.walk_length movimentos aleatórios sem sair do retângulo do nível,
+// abrindo chão em toda célula por onde passa; a saída é a última célula,
+// diferente do início, onde ele ficou de pé (se não houver nenhuma, o passeio
+// continua até haver). Assim todo candidato tem solução (no máximo o próprio
+// passeio), e o resolvedor encontra a menor. Depois, cada célula ainda vazia
+// recebe chão com probabilidade params.extra_floor, o que cria atalhos e
+// becos.
+//
+// Usamos std::mt19937 e restos de divisão, e não as distribuições da
+// biblioteca padrão, cujos resultados mudam de um compilador para outro:
+// uma semente gera o mesmo nível em qualquer plataforma.
+#include <cassert>
+#include <random>
+#include <string>
+#include <utility>
+
+#include "collisions.h"
+#include "generator.h"
+#include "solver.h"
+#include "thread_pool.h"
+
+GeneratorParams Generator_DefaultParams()
+{
+    GeneratorParams params;
+    params.width = 12;
+    params.depth = 8;
+    params.walk_length = 60;
+    params.extra_floor = 0.15f;
+    params.min_solution_length = 10;
+    return params;
+}
+
+// O bloco em "state" está inteiramente dentro do retângulo do nível.
+static bool Generator_Inside(const GeneratorParams& params, BlockState state)
+{
+    int cells_x[2], cells_z[2];
+    int count = Block_GetCells(state, cells_x, cells_z);
+    for (int i = 0; i < count; ++i)
+        if (cells_x[i] < 0 || cells_x[i] >= params.width || cells_z[i] < 0 || cells_z[i] >= params.depth)
+            return false;
+    return true;
+}
+
+static void Generator_Carve(std::vector<std::string>& rows, BlockState state)
+{
+    int cells_x[2], cells_z[2];
+    int count = Block_GetCells(state, cells_x, cells_z);
+    for (int i = 0; i < count; ++i)
+        rows[cells_z[i]][cells_x[i]] = '#';
+}
+
+bool Generator_Sample(Level* level, const GeneratorParams& params, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::string> rows(params.depth, std::string(params.width, '.'));
+
+    BlockState start = BlockState{ (int)(rng() % params.width), (int)(rng() % params.depth), BLOCK_STANDING };
+    BlockState exit = start;
+    BlockState state = start;
+    Generator_Carve(rows, state);
+
+    bool has_exit = false;
+    for (int step = 0; step < params.walk_length || !has_exit; ++step)
+    {
+        BlockState options[BLOCK_NUM_DIRECTIONS];
+        int num_options = 0;
+        for (int dir = 0; dir < BLOCK_NUM_DIRECTIONS; ++dir)
+        {
+            BlockState next = Block_Move(state, (BlockDirection)dir);
+            if (Generator_Inside(params, next))
+                options[num_options++] = next;
+        }
+        if (num_options == 0)
+            break;
+
+        state = options[rng() % num_options];
+        Generator_Carve(rows, state);
+        if (state.orientation == BLOCK_STANDING && (state.x != start.x || state.z != start.z))
+        {
+            exit = state;
+            has_exit = true;
+        }
+    }
+    assert(has_exit && "o nivel e pequeno demais para o passeio");
+
+    for (int z = 0; z < params.depth; ++z)
+    {
+        for (int x = 0; x < params.width; ++x)
+        {
+            // Sorteamos para toda célula, com chão ou não, para que o resto
+            // do nível não dependa de quais células o passeio abriu.
+            bool extra = (rng() % 65536) < (unsigned int)(params.extra_floor * 65536);
+            if (extra)
+                rows[z][x] = '#';
+        }
+    }
+
+    rows[start.z][start.x] = 'S';
+    rows[exit.z][exit.x] = 'E';
+
+    std::vector<const char*> row_pointers(params.depth);
+    for (int z = 0; z < params.depth; ++z)
+        row_pointers[z] = rows[z].c_str();
+    return Level_Load(level, row_pointers.data(), params.depth);
+}
+
+// A nota cresce com o comprimento da solução, com o número médio de escolhas
+// em cada estado (normalizado para 1 em um corredor, onde se pode ir ou
+// voltar) e com a fração de becos, que punem escolhas erradas.
+bool Generator_Score(const Level* level, GeneratorScore* score)
+{
+    BlockState start = BlockState{ level->start_x, level->start_z, BLOCK_STANDING };
+
+    SolverResult solution;
+    if (!Solver_Solve(level, start, false, &solution))
+        return false;
+
+    // Busca em largura sobre todos os estados alcançáveis, contando os
+    // movimentos válidos de cada um.
+    std::vector<unsigned char> visited((size_t)level->width * level->depth * BLOCK_NUM_ORIENTATIONS, 0);
+    std::vector<BlockState> queue;
+    queue.push_back(start);
+    visited[((size_t)start.z * level->width + start.x) * BLOCK_NUM_ORIENTATIONS + start.orientation] = 1;
+
+    long long total_moves = 0;
+    int dead_ends = 0;
+    for (size_t i = 0; i < queue.size(); ++i)
+    {
+        int num_moves = 0;
+        for (int dir = 0; dir < BLOCK_NUM_DIRECTIONS; ++dir)
+        {
+            BlockState next = Block_Move(queue[i], (BlockDirection)dir);
+            if (plane_collision(level, next))
+                continue;
+
+            num_moves += 1;
+            unsigned char& seen = visited[((size_t)next.z * level->width + next.x) * BLOCK_NUM_ORIENTATIONS + next.orientation];
+            if (!seen)
+            {
+                seen = 1;
+                queue.push_back(next);
+            }
+        }
+
+        total_moves += num_moves;
+        if (num_moves == 1)
+            dead_ends += 1;
+    }
+
+    score->solution_length = (int)solution.moves.size();
+    score->reachable_states = (int)queue.size();
+    score->branching_factor = (float)total_moves / queue.size();
+    score->dead_ends = dead_ends;
+    score->difficulty = score->solution_length * (score->branching_factor / 2.0f) * (1.0f + (float)dead_ends / queue.size());
+    return true;
+}
+
+void Generator_Run(const GeneratorParams& params, unsigned int first_seed, size_t count, std::vector<GeneratedLevel>* accepted)
+{
+    std::vector<GeneratedLevel> candidates(count);
+    std::vector<unsigned char> valid(count, 0);
+
+    ThreadPool_ParallelFor(count, [&](size_t i) {
+        GeneratedLevel& candidate = candidates[i];
+        candidate.seed = first_seed + (unsigned int)i;
+        valid[i] = Generator_Sample(&candidate.level, params, candidate.seed)
+                && Generator_Score(&candidate.level, &candidate.score)
+                && candidate.score.solution_length >= params.min_solution_length;
+    });
+
+    for (size_t i = 0; i < count; ++i)
+        if (valid[i])
+            accepted->push_back(std::move(candidates[i]));
+}
@@ -0,0 +1,70 @@
+// Ferramenta de linha de comando do gerador de níveis (alvo
+// "bode_generator"). Uso:
+//
+//     bode_generator <pasta> [candidatos] [primeira semente]
+//
+// Gera e avalia os candidatos em paralelo (veja "generator.h"), grava cada
+// nível aceito em "<pasta>/level_<semente>.txt" (veja Level_Save()) e as
+// notas em "<pasta>/levels.csv", do mais fácil para o mais difícil. A pasta
+// deve existir.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "generator.h"
+#include "thread_pool.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <directory> [candidates] [first seed]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::string directory = argv[1];
+    size_t count = argc > 2 ? (size_t)strtoul(argv[2], NULL, 10) : 1000;
+    unsigned int first_seed = argc > 3 ? (unsigned int)strtoul(argv[3], NULL, 10) : 1;
+
+    ThreadPool_Init(0);
+
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    std::vector<GeneratedLevel> levels;
+    Generator_Run(Generator_DefaultParams(), first_seed, count, &levels);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    printf("%d de %d candidatos aceitos em %.2f segundos (%u threads).\n",
+           (int)levels.size(), (int)count, seconds, ThreadPool_NumThreads());
+
+    std::stable_sort(levels.begin(), levels.end(), [](const GeneratedLevel& a, const GeneratedLevel& b) {
+        return a.score.difficulty < b.score.difficulty;
+    });
+
+    std::string index_name = directory + "/levels.csv";
+    FILE* index = fopen(index_name.c_str(), "w");
+    if (index == NULL)
+    {
+        fprintf(stderr, "ERROR: cannot write \"%s\".\n", index_name.c_str());
+        ThreadPool_Terminate();
+        return EXIT_FAILURE;
+    }
+
+    fprintf(index, "file,seed,solution_length,reachable_states,branching_factor,dead_ends,difficulty\n");
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        const GeneratedLevel& level = levels[i];
+        std::string name = "level_" + std::to_string(level.seed) + ".txt";
+        if (!Level_Save(&level.level, (directory + "/" + name).c_str()))
+            continue;
+
+        fprintf(index, "%s,%u,%d,%d,%.3f,%d,%.3f\n", name.c_str(), level.seed,
+                level.score.solution_length, level.score.reachable_states,
+                level.score.branching_factor, level.score.dead_ends, level.score.difficulty);
+    }
+
+    fclose(index);
+    ThreadPool_Terminate();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,205 @@
+// Mensagens de depuração OpenGL.
+//
+// A função de callback pode ser chamada pelo driver de qualquer thread (com
+// GL_DEBUG_OUTPUT_SYNCHRONOUS desligado), inclusive de várias ao mesmo tempo,
+// e não deve travar nem alocar memória. Cada mensagem é copiada para uma
+// posição de um anel de tamanho fixo: a posição é reservada com uma
+// comparação-e-troca atômica no índice de escrita, e o número de sequência
+// da posição avisa a thread principal (GLDebug_Flush()) quando a cópia
+// terminou. Se o anel está cheio a mensagem é descartada e apenas contada.
+//
+// O grupo de cada mensagem é o grupo aberto no momento em que o driver a
+// entrega; como a entrega é assíncrona, uma mensagem pode, raramente, ser
+// atribuída ao passo seguinte.
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+#include "gl_debug.h"
+#include "gl_extensions.h"
+
+// Número de posições do anel (potência de 2) e tamanho máximo de cada
+// mensagem guardada.
+#define GL_DEBUG_RING_SIZE      64
+#define GL_DEBUG_MESSAGE_LENGTH 256
+
+// Profundidade máxima de grupos aninhados guardados.
+#define GL_DEBUG_MAX_GROUPS 8
+
+struct GLDebugMessage
+{
+    std::atomic<unsigned int> sequence;
+    GLenum      source;
+    GLenum      type;
+    GLenum      severity;
+    GLuint      id;
+    const char* group;
+    char        text[GL_DEBUG_MESSAGE_LENGTH];
+};
+
+static GLDebugMessage            g_GLDebugRing[GL_DEBUG_RING_SIZE];
+static std::atomic<unsigned int> g_GLDebugWriteIndex(0);
+static unsigned int              g_GLDebugReadIndex = 0; // Só da thread principal
+static std::atomic<unsigned int> g_GLDebugDropped(0);
+
+static std::atomic<const char*> g_GLDebugGroup(NULL);
+static const char*              g_GLDebugGroupStack[GL_DEBUG_MAX_GROUPS];
+static int                      g_GLDebugGroupDepth = 0;
+
+static bool g_GLDebugSupported = false;
+
+static void APIENTRY GLDebug_Callback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                      GLsizei length, const GLchar* message, const void* user_param)
+{
+    (void)user_param;
+
+    unsigned int index = g_GLDebugWriteIndex.load(std::memory_order_relaxed);
+    GLDebugMessage* slot;
+    for (;;)
+    {
+        slot = &g_GLDebugRing[index % GL_DEBUG_RING_SIZE];
+        int diff = (int)(slot->sequence.load(std::memory_order_acquire) - index);
+        if (diff == 0)
+        {
+            if (g_GLDebugWriteIndex.compare_exchange_weak(index, index + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // Anel cheio: a posição ainda não foi lida por GLDebug_Flush().
+            g_GLDebugDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            index = g_GLDebugWriteIndex.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->source   = source;
+    slot->type     = type;
+    slot->severity = severity;
+    slot->id       = id;
+    slot->group    = g_GLDebugGroup.load(std::memory_order_relaxed);
+
+    size_t n = length >= 0 ? (size_t)length : strlen(message);
+    if (n > GL_DEBUG_MESSAGE_LENGTH - 1)
+        n = GL_DEBUG_MESSAGE_LENGTH - 1;
+    memcpy(slot->text, message, n);
+    slot->text[n] = '\0';
+
+    slot->sequence.store(index + 1, std::memory_order_release);
+}
+
+static const char* GLDebug_SourceName(GLenum source)
+{
+    switch (source)
+    {
+        case GL_DEBUG_SOURCE_API:             return "API";
+        case GL_DEBUG_SOURCE_WINDOW_SYSTEM:   return "WINDOW_SYSTEM";
+        case GL_DEBUG_SOURCE_SHADER_COMPILER: return "SHADER_COMPILER";
+        case GL_DEBUG_SOURCE_THIRD_PARTY:     return "THIRD_PARTY";
+        case GL_DEBUG_SOURCE_APPLICATION:     return "APPLICATION";
+        default:                              return "OTHER";
+    }
+}
+
+static const char* GLDebug_TypeName(GLenum type)
+{
+    switch (type)
+    {
+        case GL_DEBUG_TYPE_ERROR:               return "ERROR";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "DEPRECATED_BEHAVIOR";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  return "UNDEFINED_BEHAVIOR";
+        case GL_DEBUG_TYPE_PORTABILITY:         return "PORTABILITY";
+        case GL_DEBUG_TYPE_PERFORMANCE:         return "PERFORMANCE";
+        case GL_DEBUG_TYPE_MARKER:              return "MARKER";
+        default:                                return "OTHER";
+    }
+}
+
+void GLDebug_Init()
+{
+    g_GLDebugSupported = glObjectLabel != NULL && glPushDebugGroup != NULL && glPopDebugGroup != NULL &&
+                         glDebugMessageCallback != NULL && glDebugMessageControl != NULL &&
+                         (GLExtensions_VersionAtLeast(4, 3) || GLExtensions_IsSupported("GL_KHR_debug"));
+    if (!g_GLDebugSupported)
+        return;
+
+    for (unsigned int i = 0; i < GL_DEBUG_RING_SIZE; ++i)
+        g_GLDebugRing[i].sequence.store(i, std::memory_order_relaxed);
+
+#ifndef NDEBUG
+    glDebugMessageCallback(GLDebug_Callback, NULL);
+
+    // Notificações (por exemplo, onde cada buffer foi alocado, e a abertura
+    // de cada grupo) só poluiriam o terminal.
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, NULL, GL_FALSE);
+
+    glEnable(GL_DEBUG_OUTPUT);
+    glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+
+    GLint flags = 0;
+    glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+    if (!(flags & GL_CONTEXT_FLAG_DEBUG_BIT))
+        fprintf(stderr, "WARNING: OpenGL context is not a debug context; debug output may be incomplete.\n");
+#endif
+}
+
+bool GLDebug_IsSupported()
+{
+    return g_GLDebugSupported;
+}
+
+void GLDebug_Flush()
+{
+    for (;;)
+    {
+        GLDebugMessage& slot = g_GLDebugRing[g_GLDebugReadIndex % GL_DEBUG_RING_SIZE];
+        if (slot.sequence.load(std::memory_order_acquire) != g_GLDebugReadIndex + 1)
+            break;
+
+        const char* level = slot.type == GL_DEBUG_TYPE_ERROR || slot.severity == GL_DEBUG_SEVERITY_HIGH ? "ERROR" : "WARNING";
+        fprintf(stderr, "%s: OpenGL %s %s 0x%x in pass \"%s\": %s\n", level,
+                GLDebug_SourceName(slot.source), GLDebug_TypeName(slot.type), slot.id,
+                slot.group ? slot.group : "(none)", slot.text);
+
+        slot.sequence.store(g_GLDebugReadIndex + GL_DEBUG_RING_SIZE, std::memory_order_release);
+        g_GLDebugReadIndex += 1;
+    }
+
+    unsigned int dropped = g_GLDebugDropped.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0)
+        fprintf(stderr, "WARNING: %u OpenGL debug messages dropped.\n", dropped);
+}
+
+void GLDebug_Label(GLenum identifier, GLuint name, const char* label)
+{
+    if (g_GLDebugSupported)
+        glObjectLabel(identifier, name, -1, label);
+}
+
+void GLDebug_PushGroup(const char* name)
+{
+    if (!g_GLDebugSupported)
+        return;
+
+    glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name);
+
+    if (g_GLDebugGroupDepth < GL_DEBUG_MAX_GROUPS)
+        g_GLDebugGroupStack[g_GLDebugGroupDepth] = name;
+    g_GLDebugGroupDepth += 1;
+    g_GLDebugGroup.store(name, std::memory_order_relaxed);
+}
+
+void GLDebug_PopGroup()
+{
+    if (!g_GLDebugSupported || g_GLDebugGroupDepth == 0)
+        return;
+
+    glPopDebugGroup();
+
+    g_GLDebugGroupDepth -= 1;
+    int top = g_GLDebugGroupDepth < GL_DEBUG_MAX_GROUPS ? g_GLDebugGroupDepth : GL_DEBUG_MAX_GROUPS;
+    g_GLDebugGroup.store(top > 0 ? g_GLDebugGroupStack[top - 1] : NULL, std::memory_order_relaxed);
+}
@@ -0,0 +1,50 @@
+#include <cstring>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "gl_extensions.h"
+
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC glad_glMultiDrawElementsIndirect = NULL;
+PFNGLDEBUGMESSAGECALLBACKPROC      glad_glDebugMessageCallback = NULL;
+PFNGLDEBUGMESSAGECONTROLPROC       glad_glDebugMessageControl = NULL;
+PFNGLOBJECTLABELPROC               glad_glObjectLabel = NULL;
+PFNGLPUSHDEBUGGROUPPROC            glad_glPushDebugGroup = NULL;
+PFNGLPOPDEBUGGROUPPROC             glad_glPopDebugGroup = NULL;
+
+void GLExtensions_Load()
+{
+    glad_glMultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC) glfwGetProcAddress("glMultiDrawElementsIndirect");
+    glad_glDebugMessageCallback = (PFNGLDEBUGMESSAGECALLBACKPROC) glfwGetProcAddress("glDebugMessageCallback");
+    glad_glDebugMessageControl = (PFNGLDEBUGMESSAGECONTROLPROC) glfwGetProcAddress("glDebugMessageControl");
+    glad_glObjectLabel = (PFNGLOBJECTLABELPROC) glfwGetProcAddress("glObjectLabel");
+    glad_glPushDebugGroup = (PFNGLPUSHDEBUGGROUPPROC) glfwGetProcAddress("glPushDebugGroup");
+    glad_glPopDebugGroup = (PFNGLPOPDEBUGGROUPPROC) glfwGetProcAddress("glPopDebugGroup");
+}
+
+bool GLExtensions_IsSupported(const char* name)
+{
+    // Em perfil "core" a lista de extensões deve ser percorrida uma a uma,
+    // com glGetStringi().
+    GLint num_extensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &num_extensions);
+
+    for (GLint i = 0; i < num_extensions; ++i)
+    {
+        const char* extension = (const char*) glGetStringi(GL_EXTENSIONS, i);
+        if (extension && strcmp(extension, name) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+bool GLExtensions_VersionAtLeast(int major, int minor)
+{
+    GLint context_major = 0;
+    GLint context_minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &context_major);
+    glGetIntegerv(GL_MINOR_VERSION, &context_minor);
+
+    return context_major > major || (context_major == major && context_minor >= minor);
+}
@@ -0,0 +1,267 @@
+// Cache do estado OpenGL.
+//
+// Cada valor guardado começa desconhecido (GL_STATE_UNKNOWN), e a primeira
+// chamada correspondente é sempre executada. Somente o estado global do
+// contexto é guardado: a ligação de GL_ELEMENT_ARRAY_BUFFER faz parte do VAO
+// atual, e as chamadas para ela (e para outros alvos e capacidades não
+// listados abaixo) são sempre executadas.
+#define GL_STATE_IMPLEMENTATION
+#include "gl_state.h"
+#include "gl_extensions.h"
+
+// Valor guardado desconhecido.
+#define GL_STATE_UNKNOWN 0xFFFFFFFFu
+
+// Unidades de textura guardadas. Deve ser no mínimo MAX_TEXTURE_SLOTS em
+// "renderer.cpp".
+#define GL_STATE_MAX_UNITS 32
+
+// Alvos de textura, de buffer e capacidades (glEnable()) guardados.
+static const GLenum g_GLStateTextureTargets[] = { GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP };
+static const GLenum g_GLStateBufferTargets[]  = { GL_ARRAY_BUFFER, GL_DRAW_INDIRECT_BUFFER, GL_SHADER_STORAGE_BUFFER };
+static const GLenum g_GLStateCaps[]           = { GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE };
+
+#define GL_STATE_NUM_TEXTURE_TARGETS (sizeof(g_GLStateTextureTargets) / sizeof(g_GLStateTextureTargets[0]))
+#define GL_STATE_NUM_BUFFER_TARGETS  (sizeof(g_GLStateBufferTargets) / sizeof(g_GLStateBufferTargets[0]))
+#define GL_STATE_NUM_CAPS            (sizeof(g_GLStateCaps) / sizeof(g_GLStateCaps[0]))
+
+static GLuint g_GLStateProgram;
+static GLuint g_GLStateVertexArray;
+static GLuint g_GLStateActiveUnit; // Índice da unidade, a partir de 0
+static GLuint g_GLStateTextures[GL_STATE_MAX_UNITS][GL_STATE_NUM_TEXTURE_TARGETS];
+static GLuint g_GLStateBuffers[GL_STATE_NUM_BUFFER_TARGETS];
+static GLuint g_GLStateCapEnabled[GL_STATE_NUM_CAPS]; // GL_TRUE, GL_FALSE ou desconhecido
+static GLenum g_GLStateBlend[4]; // Fatores RGB e alfa, de origem e destino
+static GLenum g_GLStateDepthFunc;
+static GLuint g_GLStateDepthMask;
+static bool   g_GLStateInitialized = false;
+
+static unsigned long g_GLStateIssued = 0;
+static unsigned long g_GLStateElided = 0;
+static GLStateStats  g_GLStateFrameStats = { 0, 0 };
+
+void GLState_Invalidate()
+{
+    g_GLStateProgram     = GL_STATE_UNKNOWN;
+    g_GLStateVertexArray = GL_STATE_UNKNOWN;
+    g_GLStateActiveUnit  = GL_STATE_UNKNOWN;
+    for (size_t u = 0; u < GL_STATE_MAX_UNITS; ++u)
+        for (size_t t = 0; t < GL_STATE_NUM_TEXTURE_TARGETS; ++t)
+            g_GLStateTextures[u][t] = GL_STATE_UNKNOWN;
+    for (size_t b = 0; b < GL_STATE_NUM_BUFFER_TARGETS; ++b)
+        g_GLStateBuffers[b] = GL_STATE_UNKNOWN;
+    for (size_t c = 0; c < GL_STATE_NUM_CAPS; ++c)
+        g_GLStateCapEnabled[c] = GL_STATE_UNKNOWN;
+    for (int i = 0; i < 4; ++i)
+        g_GLStateBlend[i] = GL_STATE_UNKNOWN;
+    g_GLStateDepthFunc = GL_STATE_UNKNOWN;
+    g_GLStateDepthMask = GL_STATE_UNKNOWN;
+    g_GLStateInitialized = true;
+}
+
+// Atualiza o valor guardado "*shadow". Retorna true se a chamada deve ser
+// executada.
+static bool GLState_Update(GLuint* shadow, GLuint value)
+{
+    if (!g_GLStateInitialized)
+        GLState_Invalidate();
+
+    if (*shadow == value)
+    {
+        g_GLStateElided += 1;
+        return false;
+    }
+    *shadow = value;
+    g_GLStateIssued += 1;
+    return true;
+}
+
+// Chamada que não é guardada: sempre executada.
+static void GLState_PassThrough()
+{
+    g_GLStateIssued += 1;
+}
+
+static int GLState_Find(const GLenum* list, size_t count, GLenum value)
+{
+    for (size_t i = 0; i < count; ++i)
+        if (list[i] == value)
+            return (int)i;
+    return -1;
+}
+
+void GLState_UseProgram(GLuint program)
+{
+    if (GLState_Update(&g_GLStateProgram, program))
+        glad_glUseProgram(program);
+}
+
+void GLState_BindVertexArray(GLuint array)
+{
+    if (GLState_Update(&g_GLStateVertexArray, array))
+        glad_glBindVertexArray(array);
+}
+
+void GLState_ActiveTexture(GLenum texture)
+{
+    if (GLState_Update(&g_GLStateActiveUnit, texture - GL_TEXTURE0))
+        glad_glActiveTexture(texture);
+}
+
+void GLState_BindTexture(GLenum target, GLuint texture)
+{
+    int t = GLState_Find(g_GLStateTextureTargets, GL_STATE_NUM_TEXTURE_TARGETS, target);
+    GLuint unit = g_GLStateInitialized ? g_GLStateActiveUnit : GL_STATE_UNKNOWN;
+
+    if (t < 0 || unit >= GL_STATE_MAX_UNITS)
+    {
+        GLState_PassThrough();
+        glad_glBindTexture(target, texture);
+        return;
+    }
+
+    if (GLState_Update(&g_GLStateTextures[unit][t], texture))
+        glad_glBindTexture(target, texture);
+}
+
+void GLState_BindBuffer(GLenum target, GLuint buffer)
+{
+    int b = GLState_Find(g_GLStateBufferTargets, GL_STATE_NUM_BUFFER_TARGETS, target);
+    if (b < 0)
+    {
+        GLState_PassThrough();
+        glad_glBindBuffer(target, buffer);
+        return;
+    }
+
+    if (GLState_Update(&g_GLStateBuffers[b], buffer))
+        glad_glBindBuffer(target, buffer);
+}
+
+void GLState_BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    // Também liga o buffer ao alvo genérico "target".
+    GLState_PassThrough();
+    glad_glBindBufferBase(target, index, buffer);
+
+    int b = GLState_Find(g_GLStateBufferTargets, GL_STATE_NUM_BUFFER_TARGETS, target);
+    if (b >= 0 && g_GLStateInitialized)
+        g_GLStateBuffers[b] = buffer;
+}
+
+static void GLState_SetCap(GLenum cap, GLuint enabled)
+{
+    int c = GLState_Find(g_GLStateCaps, GL_STATE_NUM_CAPS, cap);
+    if (c < 0)
+        GLState_PassThrough();
+    else if (!GLState_Update(&g_GLStateCapEnabled[c], enabled))
+        return;
+
+    if (enabled)
+        glad_glEnable(cap);
+    else
+        glad_glDisable(cap);
+}
+
+void GLState_Enable(GLenum cap)
+{
+    GLState_SetCap(cap, GL_TRUE);
+}
+
+void GLState_Disable(GLenum cap)
+{
+    GLState_SetCap(cap, GL_FALSE);
+}
+
+void GLState_BlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha)
+{
+    if (!g_GLStateInitialized)
+        GLState_Invalidate();
+
+    if (g_GLStateBlend[0] == sfactorRGB && g_GLStateBlend[1] == dfactorRGB &&
+        g_GLStateBlend[2] == sfactorAlpha && g_GLStateBlend[3] == dfactorAlpha)
+    {
+        g_GLStateElided += 1;
+        return;
+    }
+
+    g_GLStateBlend[0] = sfactorRGB;
+    g_GLStateBlend[1] = dfactorRGB;
+    g_GLStateBlend[2] = sfactorAlpha;
+    g_GLStateBlend[3] = dfactorAlpha;
+    g_GLStateIssued += 1;
+    glad_glBlendFuncSeparate(sfactorRGB, dfactorRGB, sfactorAlpha, dfactorAlpha);
+}
+
+void GLState_BlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    GLState_BlendFuncSeparate(sfactor, dfactor, sfactor, dfactor);
+}
+
+void GLState_DepthFunc(GLenum func)
+{
+    if (GLState_Update(&g_GLStateDepthFunc, func))
+        glad_glDepthFunc(func);
+}
+
+void GLState_DepthMask(GLboolean flag)
+{
+    if (GLState_Update(&g_GLStateDepthMask, flag ? GL_TRUE : GL_FALSE))
+        glad_glDepthMask(flag);
+}
+
+void GLState_DeleteTextures(GLsizei n, const GLuint* textures)
+{
+    GLState_PassThrough();
+    glad_glDeleteTextures(n, textures);
+
+    if (!g_GLStateInitialized)
+        return;
+
+    // Texturas apagadas são desligadas de todas as unidades.
+    for (GLsizei i = 0; i < n; ++i)
+        for (size_t u = 0; u < GL_STATE_MAX_UNITS; ++u)
+            for (size_t t = 0; t < GL_STATE_NUM_TEXTURE_TARGETS; ++t)
+                if (g_GLStateTextures[u][t] == textures[i])
+                    g_GLStateTextures[u][t] = 0;
+}
+
+void GLState_DeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    GLState_PassThrough();
+    glad_glDeleteBuffers(n, buffers);
+
+    if (!g_GLStateInitialized)
+        return;
+
+    for (GLsizei i = 0; i < n; ++i)
+        for (size_t b = 0; b < GL_STATE_NUM_BUFFER_TARGETS; ++b)
+            if (g_GLStateBuffers[b] == buffers[i])
+                g_GLStateBuffers[b] = 0;
+}
+
+void GLState_DeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+    GLState_PassThrough();
+    glad_glDeleteVertexArrays(n, arrays);
+
+    if (!g_GLStateInitialized)
+        return;
+
+    for (GLsizei i = 0; i < n; ++i)
+        if (g_GLStateVertexArray == arrays[i])
+            g_GLStateVertexArray = 0;
+}
+
+void GLState_EndFrame()
+{
+    g_GLStateFrameStats.issued = g_GLStateIssued;
+    g_GLStateFrameStats.elided = g_GLStateElided;
+    g_GLStateIssued = 0;
+    g_GLStateElided = 0;
+}
+
+GLStateStats GLState_GetFrameStats()
+{
+    return g_GLStateFrameStats;
+}
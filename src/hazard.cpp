@@ -0,0 +1,259 @@
+// Perigos e tabela de ocupação.
+//
+// O movimento PATROL é uma onda periódica da distância percorrida (veja
+// Path_Wrap()); o SWING, um seno do parâmetro das curvas, convertido em
+// distância pela tabela do caminho (veja Path_ParameterDistance()).
+// HazardSet_Update() calcula as distâncias e leva e avalia todos os perigos
+// de uma vez com Path_WrapMany() e Path_EvaluateMany(), que dão os mesmos
+// valores que Path_Wrap() e Path_Evaluate(), usadas por
+// HazardSet_Position().
+//
+// Para montar a tabela, cada perigo é amostrado HAZARD_SAMPLES_PER_TICK + 1
+// vezes por tick (incluindo os dois extremos). Em cada amostra, testamos com
+// hazard_collision() os estados do bloco com célula a até
+// HAZARD_SEARCH_RADIUS células do perigo (mais o quanto o perigo é maior que
+// a esfera), e o retângulo do tick é o menor que contém todos os atingidos.
+// Como as regras de colisão comparam X e Z separadamente, os estados
+// atingidos em uma amostra já formam um retângulo; a união das amostras
+// pode aumentá-lo um pouco, o que só deixa a tabela mais cautelosa.
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "collisions.h"
+#include "hazard.h"
+
+// Distância máxima, em células, entre o perigo e a célula de um estado
+// atingido. sphere_collision() não vai além de 1 célula em cada eixo, e a
+// célula de um bloco deitado fica meia célula antes do seu centro.
+#define HAZARD_SEARCH_RADIUS 2
+
+// Célula de um perigo que ainda não está no hash.
+#define HAZARD_NO_CELL INT_MIN
+
+static int HazardSet_Bucket(int x, int z)
+{
+    return (int)((((unsigned int)x * 73856093u) ^ ((unsigned int)z * 19349663u)) & (HAZARD_HASH_BUCKETS - 1));
+}
+
+// Quanto um perigo de raio "radius" alcança além da esfera.
+static float HazardSet_Grow(float radius)
+{
+    return std::max(radius - COLLISION_SPHERE_RADIUS, 0.0f);
+}
+
+void HazardSet_Clear(HazardSet* set)
+{
+    set->paths.clear();
+    set->x.clear();
+    set->y.clear();
+    set->z.clear();
+    set->radius.clear();
+    set->path.clear();
+    set->offset.clear();
+    set->speed.clear();
+    set->motion.clear();
+    set->distance.clear();
+    set->max_radius = 0.0f;
+    set->cell_x.clear();
+    set->cell_z.clear();
+    set->buckets.assign(HAZARD_HASH_BUCKETS, std::vector<int>());
+}
+
+int HazardSet_AddPath(HazardSet* set, const Path& path)
+{
+    set->paths.push_back(path);
+    return (int)set->paths.size() - 1;
+}
+
+int HazardSet_Add(HazardSet* set, int path, HazardMotion motion, float offset, float speed, float radius)
+{
+    int hazard = (int)set->radius.size();
+    set->x.push_back(0.0f);
+    set->y.push_back(0.0f);
+    set->z.push_back(0.0f);
+    set->radius.push_back(radius);
+    set->path.push_back(path);
+    set->offset.push_back(offset);
+    set->speed.push_back(speed);
+    set->motion.push_back(motion);
+    set->distance.push_back(0.0f);
+    set->max_radius = std::max(set->max_radius, radius);
+    set->cell_x.push_back(HAZARD_NO_CELL);
+    set->cell_z.push_back(HAZARD_NO_CELL);
+    return hazard;
+}
+
+void HazardSet_LoadDefault(HazardSet* set)
+{
+    HazardSet_Clear(set);
+
+    // O caminho do jogo (veja Path_LoadDefault()) levado para a reta x = 4,
+    // na altura 0.7, com o Z dobrado: a esfera só anda em Z. As curvas de
+    // Bézier acompanham a transformação dos pontos de controle.
+    Path path;
+    Path_LoadDefault(&path);
+    std::vector<glm::vec3> points = path.points;
+    for (size_t i = 0; i < points.size(); ++i)
+        points[i] = glm::vec3(4.0f, 0.7f, 2 * points[i].z - 3.0f);
+    std::vector<float> knots = path.knots;
+    Path_InitBezier(&path, points.data(), (int)points.size(), knots.data());
+
+    // Seno do próprio tempo: período HAZARD_SPHERE_PERIOD.
+    HazardSet_Add(set, HazardSet_AddPath(set, path), HAZARD_MOTION_SWING, 0.0f, 1.0f, COLLISION_SPHERE_RADIUS);
+}
+
+// Distância no caminho de um perigo HAZARD_MOTION_SWING. O seno move o
+// parâmetro da curva; Path_ParameterDistance() o leva para a tabela de
+// distâncias, sem avaliar a curva.
+static float HazardSet_SwingDistance(const HazardSet* set, int hazard, double time)
+{
+    float t = (float)(set->offset[hazard] + set->speed[hazard] * time);
+    t = (1 + sin(t)) / 2;
+    return Path_ParameterDistance(&set->paths[set->path[hazard]], t);
+}
+
+// Distância no caminho do perigo "hazard" no instante "time", antes de
+// Path_Wrap(): a dos perigos PATROL ainda pode passar das pontas.
+static float HazardSet_Distance(const HazardSet* set, int hazard, double time)
+{
+    if (set->motion[hazard] == HAZARD_MOTION_SWING)
+        return HazardSet_SwingDistance(set, hazard, time);
+    return set->offset[hazard] + set->speed[hazard] * (float)time;
+}
+
+void HazardSet_Position(const HazardSet* set, int hazard, double time, float* x, float* y, float* z)
+{
+    const Path* path = &set->paths[set->path[hazard]];
+    glm::vec3 point = Path_Evaluate(path, Path_Wrap(path, HazardSet_Distance(set, hazard, time)));
+    *x = point.x;
+    *y = point.y;
+    *z = point.z;
+}
+
+void HazardSet_Update(HazardSet* set, double time)
+{
+    const int count = (int)set->radius.size();
+    int h;
+
+    // As distâncias dos SWING já estão dentro do caminho, e Path_Wrap() não
+    // muda o seu ponto; todos os perigos passam juntos pelas duas etapas.
+    for (h = 0; h < count; ++h)
+        set->distance[h] = HazardSet_Distance(set, h, time);
+    Path_WrapMany(set->paths.data(), set->path.data(), set->distance.data(), count);
+    Path_EvaluateMany(set->paths.data(), set->path.data(), set->distance.data(), count,
+                      set->x.data(), set->y.data(), set->z.data());
+
+    // Só os perigos que trocaram de célula mudam de bucket.
+    for (h = 0; h < count; ++h)
+    {
+        int cell_x = (int)std::floor(set->x[h] + 0.5f);
+        int cell_z = (int)std::floor(set->z[h] + 0.5f);
+        if (cell_x == set->cell_x[h] && cell_z == set->cell_z[h])
+            continue;
+
+        if (set->cell_x[h] != HAZARD_NO_CELL)
+        {
+            std::vector<int>& bucket = set->buckets[HazardSet_Bucket(set->cell_x[h], set->cell_z[h])];
+            *std::find(bucket.begin(), bucket.end(), h) = bucket.back();
+            bucket.pop_back();
+        }
+        set->buckets[HazardSet_Bucket(cell_x, cell_z)].push_back(h);
+        set->cell_x[h] = cell_x;
+        set->cell_z[h] = cell_z;
+    }
+}
+
+bool HazardSet_Hits(const HazardSet* set, BlockState block)
+{
+    float block_x, block_y, block_z;
+    Block_GetCenter(block, &block_x, &block_y, &block_z);
+
+    // hazard_collision() exige o centro do perigo a menos de 1 (mais o
+    // crescimento) do centro do bloco em cada eixo, e o centro está a até
+    // meia célula da célula do hash.
+    float reach = 1.5f + HazardSet_Grow(set->max_radius);
+    int x0 = (int)std::ceil(block_x - reach);
+    int x1 = (int)std::floor(block_x + reach);
+    int z0 = (int)std::ceil(block_z - reach);
+    int z1 = (int)std::floor(block_z + reach);
+
+    for (int z = z0; z <= z1; ++z)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            const std::vector<int>& bucket = set->buckets[HazardSet_Bucket(x, z)];
+            for (size_t i = 0; i < bucket.size(); ++i)
+            {
+                int h = bucket[i];
+                if (set->cell_x[h] == x && set->cell_z[h] == z && hazard_collision(block, set->x[h], set->z[h], set->radius[h]))
+                    return true;
+            }
+        }
+    }
+    return false;
+}
+
+void HazardTable_Build(HazardTable* table, int num_ticks, double tick_length, int num_hazards, const float* radius,
+                       const std::function<void(int hazard, double time, float* x, float* z)>& position)
+{
+    table->num_ticks = num_ticks;
+    table->num_hazards = num_hazards;
+    table->tick_length = tick_length;
+    table->rects.assign((size_t)num_ticks * num_hazards * BLOCK_NUM_ORIENTATIONS, HazardRect{ INT_MAX, INT_MAX, INT_MIN, INT_MIN });
+
+    for (int tick = 0; tick < num_ticks; ++tick)
+    {
+        for (int h = 0; h < num_hazards; ++h)
+        {
+            HazardRect* rects = &table->rects[((size_t)tick * num_hazards + h) * BLOCK_NUM_ORIENTATIONS];
+            float hazard_radius = radius != NULL ? radius[h] : COLLISION_SPHERE_RADIUS;
+            int search = HAZARD_SEARCH_RADIUS + (int)std::ceil(HazardSet_Grow(hazard_radius));
+            for (int sample = 0; sample <= HAZARD_SAMPLES_PER_TICK; ++sample)
+            {
+                float hazard_x, hazard_z;
+                position(h, (tick + (double)sample / HAZARD_SAMPLES_PER_TICK) * tick_length, &hazard_x, &hazard_z);
+
+                int center_x = (int)std::floor(hazard_x);
+                int center_z = (int)std::floor(hazard_z);
+                for (int o = 0; o < BLOCK_NUM_ORIENTATIONS; ++o)
+                {
+                    HazardRect& rect = rects[o];
+                    for (int z = center_z - search; z <= center_z + search; ++z)
+                    {
+                        for (int x = center_x - search; x <= center_x + search; ++x)
+                        {
+                            if (!hazard_collision(BlockState{ x, z, (BlockOrientation)o }, hazard_x, hazard_z, hazard_radius))
+                                continue;
+                            rect.x0 = std::min(rect.x0, x);
+                            rect.z0 = std::min(rect.z0, z);
+                            rect.x1 = std::max(rect.x1, x);
+                            rect.z1 = std::max(rect.z1, z);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void HazardTable_BuildSet(HazardTable* table, const HazardSet* set, int num_ticks, double tick_length)
+{
+    HazardTable_Build(table, num_ticks, tick_length, (int)set->radius.size(), set->radius.data(),
+        [set](int hazard, double time, float* x, float* z) {
+            float y;
+            HazardSet_Position(set, hazard, time, x, &y, z);
+        });
+}
+
+void HazardTable_BuildDefault(HazardTable* table)
+{
+    HazardSet set;
+    HazardSet_LoadDefault(&set);
+    HazardTable_BuildSet(table, &set, HAZARD_DEFAULT_TICKS, HAZARD_SPHERE_PERIOD / HAZARD_DEFAULT_TICKS);
+}
+
+int HazardTable_Tick(const HazardTable* table, double time)
+{
+    return (int)((long long)std::floor(time / table->tick_length) % table->num_ticks);
+}
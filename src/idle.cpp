@@ -0,0 +1,117 @@
+// Modo ocioso.
+//
+// A cena só muda por quatro motivos: interação do usuário (que também move a
+// câmera), o mundo (perigos que se movem com o tempo), animações decorativas
+// (a rotação e o passeio dos gatos) e mudanças no texto da tela (a mensagem
+// de falha que some após alguns segundos). As interações chegam pelos
+// callbacks da GLFW, que chamam Idle_NotifyInput(); o mundo é informado por
+// Idle_SetSimulating(); o texto agenda o seu próximo quadro com
+// Idle_RedrawAt(). As animações decorativas ficam ativas por IDLE_TIMEOUT
+// segundos após a última interação: depois disso o relógio delas para, e se
+// nada mais mudar nenhum quadro é renderizado. O mundo nunca para: um
+// perigo congelado mudaria o jogo.
+#include <algorithm>
+
+#include <GLFW/glfw3.h>
+
+#include "idle.h"
+
+// Maior tempo bloqueado em Idle_WaitEvents(), em segundos.
+#define IDLE_MAX_WAIT 1.0
+
+static double g_IdleLastInput = 0.0;     // Instante da última interação
+static double g_IdlePausedTotal = 0.0;   // Tempo total com as animações paradas
+static double g_IdleRedrawTime = -1.0;   // Próximo quadro agendado (negativo: nenhum)
+static bool   g_IdleDirty = true;        // Algo mudou desde o último quadro
+static bool   g_IdleSimulating = false;  // O mundo muda sozinho com o tempo
+static bool   g_IdleWasAnimating = true; // Estado das animações no último quadro
+
+// Instante em que as animações param (ou pararam).
+static double Idle_AnimationsStop()
+{
+    return g_IdleLastInput + IDLE_TIMEOUT;
+}
+
+static bool Idle_IsAnimating(double now)
+{
+    return now < Idle_AnimationsStop();
+}
+
+void Idle_Init()
+{
+    g_IdleLastInput = glfwGetTime();
+    g_IdlePausedTotal = 0.0;
+    g_IdleRedrawTime = -1.0;
+    g_IdleDirty = true;
+    g_IdleWasAnimating = true;
+}
+
+void Idle_SetSimulating(bool simulating)
+{
+    g_IdleSimulating = simulating;
+}
+
+void Idle_NotifyInput()
+{
+    double now = glfwGetTime();
+
+    // Retomando as animações: o tempo parado não conta no relógio delas.
+    if (!Idle_IsAnimating(now))
+        g_IdlePausedTotal += now - Idle_AnimationsStop();
+
+    g_IdleLastInput = now;
+    g_IdleDirty = true;
+}
+
+void Idle_Invalidate()
+{
+    g_IdleDirty = true;
+}
+
+void Idle_RedrawAt(double time)
+{
+    if (g_IdleRedrawTime < 0.0 || time < g_IdleRedrawTime)
+        g_IdleRedrawTime = time;
+}
+
+bool Idle_BeginFrame()
+{
+    double now = glfwGetTime();
+    bool animating = Idle_IsAnimating(now);
+
+    // Um último quadro quando as animações param, com o relógio já parado.
+    bool render = g_IdleSimulating || animating || g_IdleDirty || g_IdleWasAnimating;
+
+    if (g_IdleRedrawTime >= 0.0 && now >= g_IdleRedrawTime)
+    {
+        render = true;
+        g_IdleRedrawTime = -1.0;
+    }
+
+    if (render)
+    {
+        g_IdleDirty = false;
+        g_IdleWasAnimating = animating;
+    }
+
+    return render;
+}
+
+void Idle_WaitEvents()
+{
+    double timeout = IDLE_MAX_WAIT;
+    if (g_IdleRedrawTime >= 0.0)
+        timeout = std::min(timeout, g_IdleRedrawTime - glfwGetTime());
+
+    // glfwWaitEventsTimeout() exige um tempo positivo.
+    if (timeout > 0.0)
+        glfwWaitEventsTimeout(timeout);
+    else
+        glfwPollEvents();
+}
+
+double Idle_DecorationTime()
+{
+    double now = glfwGetTime();
+    return std::min(now, Idle_AnimationsStop()) - g_IdlePausedTotal;
+}
@@ -0,0 +1,294 @@
+// Impostores de objetos distantes.
+//
+// Durante o carregamento, cada objeto marcado é renderizado com projeção
+// ortográfica, enquadrando a sua esfera envolvente, a partir de
+// IMPOSTOR_YAW_VIEWS x IMPOSTOR_PITCH_VIEWS direções, em células de uma única
+// textura (o atlas). O fundo é transparente (alfa 0).
+//
+// A cada quadro, o impostor é um retângulo do tamanho da esfera envolvente,
+// voltado para a câmera, que mostra a célula cuja direção de captura é a
+// mais próxima da direção de visão atual, medida no sistema de coordenadas
+// local do objeto (assim um objeto girando mostra outra face). Pressupõe-se
+// que o eixo Y local do objeto aponta para cima, como nos modelos da cena.
+//
+// A transição entre o objeto e o impostor usa "dithering" ordenado
+// complementar: uma fração "fade" dos pixels é desenhada pelo impostor e o
+// restante pelo objeto (veja "shader_fragment.glsl"), sem necessidade de
+// blending nem de ordenação.
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "gl_debug.h"
+#include "gl_state.h"
+#include "impostor.h"
+
+// Funções definidas em main.cpp
+GLuint LoadShader_Vertex(const char* filename);
+GLuint LoadShader_Fragment(const char* filename);
+GLuint CreateGpuProgram(GLuint vertex_shader_id, GLuint fragment_shader_id);
+
+// Direções de captura: IMPOSTOR_YAW_VIEWS ângulos ao redor do eixo Y local,
+// para cada uma de IMPOSTOR_PITCH_VIEWS elevações, de 0 a
+// IMPOSTOR_MAX_PITCH radianos (vistas de cima).
+#define IMPOSTOR_YAW_VIEWS   8
+#define IMPOSTOR_PITCH_VIEWS 3
+#define IMPOSTOR_MAX_PITCH   (3.141592f / 3.0f)
+
+// Tamanho, em texels, de cada célula do atlas.
+#define IMPOSTOR_CELL_SIZE 256
+
+// Transição: com raio projetado (NDC) acima de IMPOSTOR_FADE_START somente o
+// objeto é desenhado; abaixo de IMPOSTOR_FADE_END, somente o impostor. Com
+// uma janela de 800 pixels de altura, uma esfera de raio 0.32 ocupa cerca de
+// IMPOSTOR_CELL_SIZE pixels, e o impostor não perde resolução.
+#define IMPOSTOR_FADE_START 0.32f
+#define IMPOSTOR_FADE_END   0.26f
+
+// Programa usado na captura (caminho OpenGL 3.3 do renderizador)
+GLint  g_ImpostorCaptureModelUniform;
+GLint  g_ImpostorCaptureViewUniform;
+GLint  g_ImpostorCaptureProjectionUniform;
+GLint  g_ImpostorCaptureFadeUniform;
+GLuint g_ImpostorCaptureProgramId;
+
+// Programa usado para desenhar os impostores
+GLuint g_ImpostorProgramId;
+GLint  g_ImpostorViewUniform;
+GLint  g_ImpostorProjectionUniform;
+GLint  g_ImpostorCenterUniform;
+GLint  g_ImpostorRadiusUniform;
+GLint  g_ImpostorRightUniform;
+GLint  g_ImpostorUpUniform;
+GLint  g_ImpostorCellUniform;
+GLint  g_ImpostorFadeUniform;
+GLuint g_ImpostorQuadVAO;
+
+GLint  g_ImpostorCellSize;
+
+void Impostor_Init(GLuint program_id)
+{
+    g_ImpostorCaptureProgramId         = program_id;
+    g_ImpostorCaptureModelUniform      = glGetUniformLocation(program_id, "model");
+    g_ImpostorCaptureViewUniform       = glGetUniformLocation(program_id, "view");
+    g_ImpostorCaptureProjectionUniform = glGetUniformLocation(program_id, "projection");
+    g_ImpostorCaptureFadeUniform       = glGetUniformLocation(program_id, "impostor_fade");
+
+    GLuint vertex_shader_id   = LoadShader_Vertex("../src/shader_vertex_impostor.glsl");
+    GLuint fragment_shader_id = LoadShader_Fragment("../src/shader_fragment_impostor.glsl");
+    g_ImpostorProgramId       = CreateGpuProgram(vertex_shader_id, fragment_shader_id);
+    GLDebug_Label(GL_PROGRAM, g_ImpostorProgramId, "impostor");
+
+    g_ImpostorViewUniform       = glGetUniformLocation(g_ImpostorProgramId, "view");
+    g_ImpostorProjectionUniform = glGetUniformLocation(g_ImpostorProgramId, "projection");
+    g_ImpostorCenterUniform     = glGetUniformLocation(g_ImpostorProgramId, "center");
+    g_ImpostorRadiusUniform     = glGetUniformLocation(g_ImpostorProgramId, "radius");
+    g_ImpostorRightUniform      = glGetUniformLocation(g_ImpostorProgramId, "right");
+    g_ImpostorUpUniform         = glGetUniformLocation(g_ImpostorProgramId, "up");
+    g_ImpostorCellUniform       = glGetUniformLocation(g_ImpostorProgramId, "cell");
+    g_ImpostorFadeUniform       = glGetUniformLocation(g_ImpostorProgramId, "impostor_fade");
+
+    // O atlas é lido da unidade de textura 1: a unidade 0 tem um sampler
+    // object (veja TextRendering_Init()) que desligaria o mipmapping.
+    glUseProgram(g_ImpostorProgramId);
+    glUniform1i(glGetUniformLocation(g_ImpostorProgramId, "gAtlas"), 1);
+    glUseProgram(0);
+
+    // Retângulo com vértices em (-1,-1) ... (1,1), desenhado como
+    // GL_TRIANGLE_STRIP: dois triângulos.
+    GLfloat corners[] = {
+        -1.0f, -1.0f,
+         1.0f, -1.0f,
+        -1.0f,  1.0f,
+         1.0f,  1.0f,
+    };
+
+    glGenVertexArrays(1, &g_ImpostorQuadVAO);
+    glBindVertexArray(g_ImpostorQuadVAO);
+
+    GLuint VBO_corners_id;
+    glGenBuffers(1, &VBO_corners_id);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO_corners_id);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0); // "(location = 0)" em "shader_vertex_impostor.glsl"
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindVertexArray(0);
+
+    // OpenGL 3.3 garante texturas de somente 1024 texels de lado.
+    GLint max_texture_size;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+    g_ImpostorCellSize = IMPOSTOR_CELL_SIZE;
+    while (g_ImpostorCellSize * IMPOSTOR_YAW_VIEWS > max_texture_size)
+        g_ImpostorCellSize /= 2;
+}
+
+// Direção de captura (unitária, em coordenadas locais, do objeto para a
+// câmera) da célula (yaw, pitch).
+static glm::vec3 Impostor_ViewDirection(int yaw, int pitch)
+{
+    float theta = yaw * (2.0f * 3.141592f / IMPOSTOR_YAW_VIEWS);
+    float phi   = pitch * (IMPOSTOR_MAX_PITCH / (IMPOSTOR_PITCH_VIEWS - 1));
+    return glm::vec3(std::cos(phi) * std::sin(theta), std::sin(phi), std::cos(phi) * std::cos(theta));
+}
+
+Impostor Impostor_Create(const SceneObject& object, GLuint texture)
+{
+    Impostor impostor;
+    impostor.center = object.bsphere_center;
+    impostor.radius = object.bsphere_radius;
+
+    GLsizei atlas_width  = g_ImpostorCellSize * IMPOSTOR_YAW_VIEWS;
+    GLsizei atlas_height = g_ImpostorCellSize * IMPOSTOR_PITCH_VIEWS;
+
+    glGenTextures(1, &impostor.atlas);
+    glBindTexture(GL_TEXTURE_2D, impostor.atlas);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, atlas_width, atlas_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    GLuint depth_buffer;
+    glGenRenderbuffers(1, &depth_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, atlas_width, atlas_height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    GLuint framebuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, impostor.atlas, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_buffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        fprintf(stderr, "WARNING: impostor framebuffer incomplete; impostor of \"%s\" will be empty.\n", object.name.c_str());
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    GLfloat clear_color[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clear_color);
+
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glEnable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+
+    glUseProgram(g_ImpostorCaptureProgramId);
+    glUniform1f(g_ImpostorCaptureFadeUniform, 0.0f);
+    glUniformMatrix4fv(g_ImpostorCaptureModelUniform, 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
+
+    // Projeção ortográfica que enquadra exatamente a esfera envolvente.
+    float r = impostor.radius;
+    glm::mat4 projection = glm::ortho(-r, r, -r, r, r, 5.0f * r);
+    glUniformMatrix4fv(g_ImpostorCaptureProjectionUniform, 1, GL_FALSE, glm::value_ptr(projection));
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glBindVertexArray(object.vertex_array_object_id);
+
+    for (int pitch = 0; pitch < IMPOSTOR_PITCH_VIEWS; ++pitch)
+        for (int yaw = 0; yaw < IMPOSTOR_YAW_VIEWS; ++yaw)
+        {
+            glm::vec3 direction = Impostor_ViewDirection(yaw, pitch);
+            glm::mat4 view = glm::lookAt(impostor.center + 3.0f * r * direction, impostor.center, glm::vec3(0.0f, 1.0f, 0.0f));
+            glUniformMatrix4fv(g_ImpostorCaptureViewUniform, 1, GL_FALSE, glm::value_ptr(view));
+
+            glViewport(yaw * g_ImpostorCellSize, pitch * g_ImpostorCellSize, g_ImpostorCellSize, g_ImpostorCellSize);
+            glDrawElements(object.rendering_mode, object.lod_num_indices[0], GL_UNSIGNED_INT,
+                           (void*)(object.lod_first_index[0] * sizeof(GLuint)));
+        }
+
+    glBindVertexArray(0);
+
+    glBindTexture(GL_TEXTURE_2D, impostor.atlas);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Restauramos o estado e liberamos o que não é mais necessário.
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteRenderbuffers(1, &depth_buffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glClearColor(clear_color[0], clear_color[1], clear_color[2], clear_color[3]);
+
+    return impostor;
+}
+
+float Impostor_Fade(float projected_radius)
+{
+    float t = (IMPOSTOR_FADE_START - projected_radius) / (IMPOSTOR_FADE_START - IMPOSTOR_FADE_END);
+    return std::min(std::max(t, 0.0f), 1.0f);
+}
+
+void Impostor_Draw(const std::vector<ImpostorInstance>& instances, const glm::mat4& view, const glm::mat4& projection)
+{
+    if (instances.empty())
+        return;
+
+    glm::vec3 camera_position = glm::vec3(glm::inverse(view)[3]);
+
+    glUseProgram(g_ImpostorProgramId);
+    glUniformMatrix4fv(g_ImpostorViewUniform       , 1 , GL_FALSE , glm::value_ptr(view));
+    glUniformMatrix4fv(g_ImpostorProjectionUniform , 1 , GL_FALSE , glm::value_ptr(projection));
+    glActiveTexture(GL_TEXTURE1);
+    glBindVertexArray(g_ImpostorQuadVAO);
+
+    float cell_width  = 1.0f / IMPOSTOR_YAW_VIEWS;
+    float cell_height = 1.0f / IMPOSTOR_PITCH_VIEWS;
+
+    for (size_t i = 0; i < instances.size(); ++i)
+    {
+        const Impostor& impostor = *instances[i].impostor;
+        const glm::mat4& model = instances[i].model;
+
+        glm::vec3 center = glm::vec3(model * glm::vec4(impostor.center, 1.0f));
+        float scale = std::sqrt(std::max(glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+                                std::max(glm::dot(glm::vec3(model[1]), glm::vec3(model[1])),
+                                         glm::dot(glm::vec3(model[2]), glm::vec3(model[2])))));
+
+        // Célula com a direção de captura mais próxima da direção atual,
+        // calculada no sistema de coordenadas local do objeto.
+        glm::vec3 local_direction = glm::vec3(glm::inverse(model) * glm::vec4(camera_position, 1.0f)) - impostor.center;
+        float length = glm::length(local_direction);
+        if (length == 0.0f)
+            continue;
+        local_direction /= length;
+
+        float theta = std::atan2(local_direction.x, local_direction.z);
+        float phi   = std::asin(std::min(std::max(local_direction.y, -1.0f), 1.0f));
+        int yaw   = (int)std::floor(theta / (2.0f * 3.141592f / IMPOSTOR_YAW_VIEWS) + 0.5f);
+        int pitch = (int)std::floor(phi / (IMPOSTOR_MAX_PITCH / (IMPOSTOR_PITCH_VIEWS - 1)) + 0.5f);
+        yaw   = ((yaw % IMPOSTOR_YAW_VIEWS) + IMPOSTOR_YAW_VIEWS) % IMPOSTOR_YAW_VIEWS;
+        pitch = std::min(std::max(pitch, 0), IMPOSTOR_PITCH_VIEWS - 1);
+
+        // Eixos do retângulo, os mesmos da câmera usada na captura: "right"
+        // perpendicular ao eixo Y e à direção de visão.
+        glm::vec3 forward = glm::normalize(center - camera_position);
+        glm::vec3 right = glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f));
+        right = glm::length(right) > 1e-4f ? glm::normalize(right) : glm::vec3(1.0f, 0.0f, 0.0f);
+        glm::vec3 up = glm::cross(right, forward);
+
+        glUniform3fv(g_ImpostorCenterUniform, 1, glm::value_ptr(center));
+        glUniform1f (g_ImpostorRadiusUniform, impostor.radius * scale);
+        glUniform3fv(g_ImpostorRightUniform, 1, glm::value_ptr(right));
+        glUniform3fv(g_ImpostorUpUniform, 1, glm::value_ptr(up));
+        glUniform4f (g_ImpostorCellUniform, yaw * cell_width, pitch * cell_height, cell_width, cell_height);
+        glUniform1f (g_ImpostorFadeUniform, instances[i].fade);
+
+        glBindTexture(GL_TEXTURE_2D, impostor.atlas);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(0);
+}
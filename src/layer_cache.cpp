@@ -0,0 +1,133 @@
+// Cache da camada estática.
+//
+// O cache tem o tamanho do viewport de destino e é renderizado a partir da
+// origem; a cópia (glBlitFramebuffer()) leva a cor E a profundidade, de forma
+// que os objetos dinâmicos desenhados em seguida são corretamente escondidos
+// pelos estáticos. Copiar profundidade exige o mesmo formato nos dois
+// framebuffers: o cache usa GL_DEPTH_COMPONENT24, o formato da textura de
+// profundidade da cena (veja o passo "scene" em main()), e fica desligado com
+// qualquer outro destino (inclusive a janela, cujo formato não controlamos).
+#include <glad/glad.h>
+
+#include "gl_debug.h"
+#include "layer_cache.h"
+
+static GLuint g_LayerCacheFramebuffer = 0;
+static GLuint g_LayerCacheColor = 0;
+static GLuint g_LayerCacheDepth = 0;
+static GLint  g_LayerCacheWidth  = 0; // Tamanho alocado
+static GLint  g_LayerCacheHeight = 0;
+
+// Conteúdo do cache, e chave do quadro anterior.
+static bool               g_LayerCacheValid = false;
+static unsigned long long g_LayerCacheKey = 0;
+static bool               g_LayerCacheHasPreviousKey = false;
+static unsigned long long g_LayerCachePreviousKey = 0;
+
+// Destino do quadro atual.
+static GLint g_LayerCacheTarget = 0;
+static GLint g_LayerCacheViewport[4];
+
+// Último destino verificado, e se o seu formato de profundidade é compatível.
+static GLint g_LayerCacheCheckedTarget = -1;
+static bool  g_LayerCacheTargetCompatible = false;
+
+static bool LayerCache_TargetCompatible(GLint target)
+{
+    if (target == g_LayerCacheCheckedTarget)
+        return g_LayerCacheTargetCompatible;
+
+    g_LayerCacheCheckedTarget = target;
+    g_LayerCacheTargetCompatible = false;
+    if (target == 0)
+        return false;
+
+    GLint type = GL_NONE;
+    glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_TYPE, &type);
+    if (type == GL_NONE)
+        return false;
+
+    GLint depth_bits = 0, stencil_bits = 0;
+    glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_FRAMEBUFFER_ATTACHMENT_DEPTH_SIZE, &depth_bits);
+    glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE, &stencil_bits);
+    g_LayerCacheTargetCompatible = depth_bits == 24 && stencil_bits == 0;
+    return g_LayerCacheTargetCompatible;
+}
+
+LayerCacheState LayerCache_Begin(unsigned long long key)
+{
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &g_LayerCacheTarget);
+    glGetIntegerv(GL_VIEWPORT, g_LayerCacheViewport);
+
+    // O tamanho do viewport também faz parte do conteúdo da camada (muda, por
+    // exemplo, com a resolução dinâmica).
+    key ^= ((unsigned long long)g_LayerCacheViewport[2] << 40) ^ ((unsigned long long)g_LayerCacheViewport[3] << 20);
+
+    bool stable = g_LayerCacheHasPreviousKey && key == g_LayerCachePreviousKey;
+    g_LayerCachePreviousKey = key;
+    g_LayerCacheHasPreviousKey = true;
+
+    if (!LayerCache_TargetCompatible(g_LayerCacheTarget))
+    {
+        g_LayerCacheValid = false;
+        return LAYER_CACHE_DISABLED;
+    }
+
+    if (g_LayerCacheValid && key == g_LayerCacheKey)
+        return LAYER_CACHE_REUSE;
+
+    if (!stable)
+        return LAYER_CACHE_DISABLED;
+
+    g_LayerCacheKey = key;
+    return LAYER_CACHE_REBUILD;
+}
+
+void LayerCache_BeginRebuild()
+{
+    GLint width  = g_LayerCacheViewport[2];
+    GLint height = g_LayerCacheViewport[3];
+
+    if (g_LayerCacheFramebuffer == 0)
+    {
+        glGenFramebuffers(1, &g_LayerCacheFramebuffer);
+        glGenRenderbuffers(1, &g_LayerCacheColor);
+        glGenRenderbuffers(1, &g_LayerCacheDepth);
+        GLDebug_Label(GL_FRAMEBUFFER, g_LayerCacheFramebuffer, "layer cache");
+    }
+
+    if (width != g_LayerCacheWidth || height != g_LayerCacheHeight)
+    {
+        glBindRenderbuffer(GL_RENDERBUFFER, g_LayerCacheColor);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, g_LayerCacheDepth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, g_LayerCacheFramebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, g_LayerCacheColor);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, g_LayerCacheDepth);
+
+        g_LayerCacheWidth  = width;
+        g_LayerCacheHeight = height;
+    }
+
+    // Limpamos com a cor de limpeza atual, a mesma usada no destino.
+    glBindFramebuffer(GL_FRAMEBUFFER, g_LayerCacheFramebuffer);
+    glViewport(0, 0, width, height);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    g_LayerCacheValid = true;
+}
+
+void LayerCache_Blit()
+{
+    const GLint* v = g_LayerCacheViewport;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, g_LayerCacheFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, g_LayerCacheTarget);
+    glBlitFramebuffer(0, 0, v[2], v[3], v[0], v[1], v[0] + v[2], v[1] + v[3],
+                      GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, g_LayerCacheTarget);
+    glViewport(v[0], v[1], v[2], v[3]);
+}
@@ -0,0 +1,204 @@
+// Nível.
+//
+// Cada linha do mapa de bits começa em uma palavra nova, de forma que um
+// nível de LEVEL_MAX_SIZE x LEVEL_MAX_SIZE ocupa 2 MB.
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "level.h"
+
+// Nível do jogo. Veja Level_Load().
+static const char* const g_LevelDefault[] =
+{
+    "S##",
+    "######",
+    "#########",
+    ".#########",
+    ".....##E##",
+    "......###",
+};
+
+bool Level_Load(Level* level, const char* const* rows, int num_rows)
+{
+    int width = 0;
+    for (int z = 0; z < num_rows; ++z)
+    {
+        int length = (int)strlen(rows[z]);
+        if (length > width)
+            width = length;
+    }
+
+    if (width > LEVEL_MAX_SIZE || num_rows > LEVEL_MAX_SIZE)
+    {
+        fprintf(stderr, "ERROR: level of %dx%d cells is larger than %dx%d.\n", width, num_rows, LEVEL_MAX_SIZE, LEVEL_MAX_SIZE);
+        Level_Load(level, NULL, 0);
+        return false;
+    }
+
+    level->width  = width;
+    level->depth  = num_rows;
+    level->stride = (width + LEVEL_WORD_BITS - 1) / LEVEL_WORD_BITS;
+    level->bits.assign((size_t)level->stride * level->depth, 0);
+    level->start_x = 0;
+    level->start_z = 0;
+    level->exit_x = -1;
+    level->exit_z = -1;
+    level->solid_count = 0;
+    level->dynamic.clear();
+    level->fixed.clear();
+    level->dirty.clear();
+    level->dirty_words.clear();
+    level->dynamic_count = 0;
+
+    for (int z = 0; z < num_rows; ++z)
+    {
+        for (int x = 0; rows[z][x] != '\0'; ++x)
+        {
+            char c = rows[z][x];
+            if (c == '.' || c == ' ')
+                continue;
+
+            size_t word = (size_t)z * level->stride + x / LEVEL_WORD_BITS;
+            unsigned long long bit = 1ull << (x % LEVEL_WORD_BITS);
+            if (c == 'B' || c == 'b')
+            {
+                if (level->dynamic.empty())
+                {
+                    level->dynamic.assign(level->bits.size(), 0);
+                    level->dirty.assign(level->bits.size(), 0);
+                }
+                level->dynamic[word] |= bit;
+                level->dynamic_count += 1;
+                if (c == 'b')
+                    continue;
+            }
+            else if (c == 'E')
+            {
+                level->exit_x = x;
+                level->exit_z = z;
+            }
+            else if (c == 'S')
+            {
+                level->start_x = x;
+                level->start_z = z;
+            }
+            else if (c != '#')
+            {
+                fprintf(stderr, "WARNING: unknown level cell '%c' at (%d, %d), treated as floor.\n", c, x, z);
+            }
+
+            level->bits[word] |= bit;
+            level->solid_count += 1;
+        }
+    }
+
+    // O chão fixo é lido pelas threads de carregamento dos chunks enquanto
+    // a thread principal altera "bits" (veja "chunk.cpp").
+    if (!level->dynamic.empty())
+    {
+        level->fixed = level->bits;
+        for (size_t i = 0; i < level->fixed.size(); ++i)
+            level->fixed[i] &= ~level->dynamic[i];
+    }
+
+    if (level->exit_x < 0 && num_rows > 0)
+        fprintf(stderr, "WARNING: level has no exit.\n");
+    return true;
+}
+
+bool Level_LoadDefault(Level* level)
+{
+    return Level_Load(level, g_LevelDefault, (int)(sizeof(g_LevelDefault) / sizeof(g_LevelDefault[0])));
+}
+
+void Level_SetTile(Level* level, int x, int z, bool solid)
+{
+    if (!Level_IsDynamic(level, x, z) || Level_IsSolid(level, x, z) == solid)
+        return;
+
+    size_t word = (size_t)z * level->stride + x / LEVEL_WORD_BITS;
+    unsigned long long bit = 1ull << (x % LEVEL_WORD_BITS);
+    level->bits[word] ^= bit;
+    level->solid_count += solid ? 1 : -1;
+
+    // Uma célula que volta ao estado consumido continua suja: quem consome
+    // lê o estado atual, e não o anterior.
+    if (level->dirty[word] == 0)
+        level->dirty_words.push_back((int)word);
+    level->dirty[word] |= bit;
+}
+
+void Level_ConsumeDirty(Level* level, const std::function<void(int x, int z)>& callback)
+{
+    // Em ordem de palavra, e portanto de z e depois de x.
+    std::sort(level->dirty_words.begin(), level->dirty_words.end());
+    for (size_t i = 0; i < level->dirty_words.size(); ++i)
+    {
+        int word = level->dirty_words[i];
+        int z = word / level->stride;
+        int x0 = (word % level->stride) * LEVEL_WORD_BITS;
+        for (unsigned long long bits = level->dirty[word]; bits != 0; bits &= bits - 1)
+            callback(x0 + __builtin_ctzll(bits), z);
+        level->dirty[word] = 0;
+    }
+    level->dirty_words.clear();
+}
+
+bool Level_LoadFile(Level* level, const char* filename)
+{
+    std::ifstream file(filename);
+    if (!file)
+    {
+        fprintf(stderr, "ERROR: cannot open level \"%s\".\n", filename);
+        return false;
+    }
+
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        // Arquivos gravados no Windows terminam as linhas com "\r\n".
+        if (!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+        lines.push_back(line);
+    }
+
+    std::vector<const char*> rows(lines.size());
+    for (size_t z = 0; z < lines.size(); ++z)
+        rows[z] = lines[z].c_str();
+    return Level_Load(level, rows.data(), (int)rows.size());
+}
+
+bool Level_Save(const Level* level, const char* filename)
+{
+    FILE* file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        fprintf(stderr, "ERROR: cannot write level \"%s\".\n", filename);
+        return false;
+    }
+
+    std::string row;
+    for (int z = 0; z < level->depth; ++z)
+    {
+        row.clear();
+        for (int x = 0; x < level->width; ++x)
+        {
+            if (Level_IsDynamic(level, x, z))
+                row += Level_IsSolid(level, x, z) ? 'B' : 'b';
+            else if (x == level->exit_x && z == level->exit_z)
+                row += 'E';
+            else if (x == level->start_x && z == level->start_z && Level_IsSolid(level, x, z))
+                row += 'S';
+            else
+                row += Level_IsSolid(level, x, z) ? '#' : '.';
+        }
+        fprintf(file, "%s\n", row.c_str());
+    }
+
+    fclose(file);
+    return true;
+}
@@ -0,0 +1,315 @@
+// Geração e escolha de níveis de detalhe (LOD).
+//
+// A simplificação segue o método de quádricas de erro de Garland e Heckbert
+// ("Surface Simplification Using Quadric Error Metrics", 1997): cada vértice
+// acumula uma quádrica Q (matriz 4x4 simétrica) que mede a soma das
+// distâncias ao quadrado até os planos dos triângulos que o contêm. Colapsar
+// o vértice u sobre o vértice v custa v^T (Q_u + Q_v) v. As arestas de menor
+// custo são colapsadas primeiro.
+//
+// Usamos somente colapsos de meia-aresta (u é removido e substituído por v,
+// que permanece na mesma posição). Assim nenhum vértice novo é criado e todos
+// os níveis de detalhe compartilham o VBO do modelo: cada nível é apenas um
+// novo trecho do vetor de índices.
+//
+// Vértices na borda da malha não são removidos. Como os vértices do modelo
+// são distintos por (posição, coordenada de textura), isto inclui as
+// "costuras" do mapeamento de textura, onde o mesmo ponto aparece com duas
+// coordenadas de textura: removê-los abriria buracos na malha.
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+
+#include "lod.h"
+
+// Número mínimo de triângulos para que um objeto receba níveis de detalhe.
+#define LOD_MIN_TRIANGLES 256
+
+// Cada nível tem (no máximo) esta fração dos índices do nível anterior.
+#define LOD_REDUCTION 0.5f
+
+// Limiares de troca de nível, em raio projetado (NDC). O nível k é usado
+// enquanto o raio projetado for menor que LOD_THRESHOLDS[k-1]. Como cada
+// nível tem metade dos triângulos do anterior, os limiares caem por um fator
+// de raiz de 2, mantendo aproximadamente constante a densidade de triângulos
+// na tela.
+static const float LOD_THRESHOLDS[SCENE_MAX_LODS - 1] = { 0.7f, 0.5f, 0.35f };
+
+// Margem de histerese: fração do limiar que o raio precisa ultrapassar para
+// que o nível seja trocado.
+#define LOD_HYSTERESIS 0.15f
+
+// Matriz 4x4 simétrica: armazenamos somente os 10 coeficientes distintos.
+struct Quadric
+{
+    double a00, a01, a02, a03, a11, a12, a13, a22, a23, a33;
+};
+
+static void Quadric_AddPlane(Quadric* q, double a, double b, double c, double d, double weight)
+{
+    q->a00 += weight*a*a; q->a01 += weight*a*b; q->a02 += weight*a*c; q->a03 += weight*a*d;
+    q->a11 += weight*b*b; q->a12 += weight*b*c; q->a13 += weight*b*d;
+    q->a22 += weight*c*c; q->a23 += weight*c*d;
+    q->a33 += weight*d*d;
+}
+
+static void Quadric_Add(Quadric* q, const Quadric& r)
+{
+    q->a00 += r.a00; q->a01 += r.a01; q->a02 += r.a02; q->a03 += r.a03;
+    q->a11 += r.a11; q->a12 += r.a12; q->a13 += r.a13;
+    q->a22 += r.a22; q->a23 += r.a23;
+    q->a33 += r.a33;
+}
+
+// Calcula p^T Q p, com p = (x, y, z, 1).
+static double Quadric_Error(const Quadric& q, const glm::vec3& p)
+{
+    double x = p.x, y = p.y, z = p.z;
+    return q.a00*x*x + 2*q.a01*x*y + 2*q.a02*x*z + 2*q.a03*x
+         + q.a11*y*y + 2*q.a12*y*z + 2*q.a13*y
+         + q.a22*z*z + 2*q.a23*z
+         + q.a33;
+}
+
+// Candidato a colapso: o vértice "from" é substituído por "to".
+struct Collapse
+{
+    GLuint from;
+    GLuint to;
+    double cost;
+};
+
+static bool Lod_CheaperCollapse(const Collapse& a, const Collapse& b) { return a.cost < b.cost; }
+
+static glm::vec3 Lod_Position(const std::vector<float>& model_coefficients, GLuint vertex)
+{
+    return glm::vec3(model_coefficients[4*vertex + 0], model_coefficients[4*vertex + 1], model_coefficients[4*vertex + 2]);
+}
+
+float Lod_SimplifyMesh(const std::vector<float>& model_coefficients,
+                       const GLuint* indices, size_t num_indices,
+                       size_t target_num_indices, std::vector<GLuint>& result)
+{
+    size_t num_vertices = model_coefficients.size() / 4;
+
+    result.assign(indices, indices + num_indices);
+
+    // Quádricas iniciais: planos dos triângulos, com peso igual à área.
+    std::vector<Quadric> quadrics(num_vertices);
+    for (size_t i = 0; i + 2 < num_indices; i += 3)
+    {
+        glm::vec3 p0 = Lod_Position(model_coefficients, indices[i + 0]);
+        glm::vec3 p1 = Lod_Position(model_coefficients, indices[i + 1]);
+        glm::vec3 p2 = Lod_Position(model_coefficients, indices[i + 2]);
+
+        glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+        float length = glm::length(n);
+        if (length == 0.0f)
+            continue;
+        n /= length;
+
+        double area = 0.5 * length;
+        double d = -glm::dot(n, p0);
+        for (int k = 0; k < 3; ++k)
+            Quadric_AddPlane(&quadrics[indices[i + k]], n.x, n.y, n.z, d, area);
+    }
+
+    // Vértices de borda: pertencem a alguma aresta usada por um único
+    // triângulo.
+    std::vector<unsigned char> locked(num_vertices, 0);
+    {
+        std::map< std::pair<GLuint, GLuint>, int > edge_count;
+        for (size_t i = 0; i + 2 < num_indices; i += 3)
+            for (int k = 0; k < 3; ++k)
+            {
+                GLuint a = indices[i + k], b = indices[i + (k + 1) % 3];
+                edge_count[std::make_pair(std::min(a, b), std::max(a, b))] += 1;
+            }
+
+        for (std::map< std::pair<GLuint, GLuint>, int >::const_iterator it = edge_count.begin(); it != edge_count.end(); ++it)
+            if (it->second == 1)
+                locked[it->first.first] = locked[it->first.second] = 1;
+    }
+
+    double max_cost = 0.0;
+
+    std::vector<GLuint>        remap(num_vertices);
+    std::vector<unsigned char> touched(num_vertices);
+    std::vector<GLuint>        adjacency_offset(num_vertices + 1);
+    std::vector<GLuint>        adjacency;
+    std::vector<Collapse>      collapses;
+
+    // Cada iteração escolhe um conjunto de colapsos independentes (sem
+    // vértices em comum na vizinhança), aplica todos e reconstrói a malha.
+    while (result.size() > target_num_indices)
+    {
+        size_t num_triangles = result.size() / 3;
+
+        // Lista de triângulos de cada vértice, em formato compacto: os
+        // triângulos do vértice v estão em adjacency[adjacency_offset[v] ...
+        // adjacency_offset[v+1]-1].
+        std::fill(adjacency_offset.begin(), adjacency_offset.end(), 0);
+        for (size_t i = 0; i < result.size(); ++i)
+            adjacency_offset[result[i] + 1] += 1;
+        for (size_t v = 0; v < num_vertices; ++v)
+            adjacency_offset[v + 1] += adjacency_offset[v];
+        adjacency.resize(result.size());
+        {
+            std::vector<GLuint> fill(adjacency_offset.begin(), adjacency_offset.end() - 1);
+            for (size_t i = 0; i < result.size(); ++i)
+                adjacency[fill[result[i]]++] = (GLuint)(i / 3);
+        }
+
+        // Candidatos: cada aresta, no sentido de menor custo. Arestas
+        // internas aparecem em dois triângulos, com sentidos opostos; usamos
+        // somente a ocorrência com a < b.
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i += 3)
+            for (int k = 0; k < 3; ++k)
+            {
+                GLuint a = result[i + k], b = result[i + (k + 1) % 3];
+                if (a > b || (locked[a] && locked[b]))
+                    continue;
+
+                Quadric q = quadrics[a];
+                Quadric_Add(&q, quadrics[b]);
+
+                Collapse c;
+                double cost_ab = locked[a] ? HUGE_VAL : Quadric_Error(q, Lod_Position(model_coefficients, b));
+                double cost_ba = locked[b] ? HUGE_VAL : Quadric_Error(q, Lod_Position(model_coefficients, a));
+                if (cost_ab <= cost_ba) { c.from = a; c.to = b; c.cost = cost_ab; }
+                else                    { c.from = b; c.to = a; c.cost = cost_ba; }
+                collapses.push_back(c);
+            }
+
+        std::sort(collapses.begin(), collapses.end(), Lod_CheaperCollapse);
+
+        for (size_t v = 0; v < num_vertices; ++v)
+            remap[v] = (GLuint)v;
+        std::fill(touched.begin(), touched.end(), 0);
+
+        size_t triangles_to_remove = num_triangles - target_num_indices / 3;
+        size_t triangles_removed = 0;
+
+        for (size_t c = 0; c < collapses.size() && triangles_removed < triangles_to_remove; ++c)
+        {
+            GLuint u = collapses[c].from;
+            GLuint v = collapses[c].to;
+            if (touched[u] || touched[v])
+                continue;
+
+            // O colapso não pode inverter a orientação de nenhum dos
+            // triângulos que permanecem.
+            glm::vec3 pv = Lod_Position(model_coefficients, v);
+            bool flips = false;
+            size_t removed = 0;
+            for (GLuint t = adjacency_offset[u]; t < adjacency_offset[u + 1] && !flips; ++t)
+            {
+                const GLuint* tri = &result[3 * adjacency[t]];
+                if (tri[0] == v || tri[1] == v || tri[2] == v)
+                {
+                    ++removed;
+                    continue;
+                }
+
+                glm::vec3 p[3], q[3];
+                for (int k = 0; k < 3; ++k)
+                {
+                    p[k] = Lod_Position(model_coefficients, tri[k]);
+                    q[k] = tri[k] == u ? pv : p[k];
+                }
+                glm::vec3 n_old = glm::cross(p[1] - p[0], p[2] - p[0]);
+                glm::vec3 n_new = glm::cross(q[1] - q[0], q[2] - q[0]);
+                flips = glm::dot(n_old, n_new) <= 0.0f;
+            }
+            if (flips)
+                continue;
+
+            remap[u] = v;
+            Quadric_Add(&quadrics[v], quadrics[u]);
+            max_cost = std::max(max_cost, collapses[c].cost);
+            triangles_removed += removed;
+
+            // Os vértices vizinhos de u e v não participam de outros colapsos
+            // nesta iteração, pois o teste acima depende das suas posições e
+            // triângulos atuais.
+            GLuint ends[2] = { u, v };
+            for (int e = 0; e < 2; ++e)
+                for (GLuint t = adjacency_offset[ends[e]]; t < adjacency_offset[ends[e] + 1]; ++t)
+                    for (int k = 0; k < 3; ++k)
+                        touched[result[3 * adjacency[t] + k]] = 1;
+        }
+
+        if (triangles_removed == 0)
+            break;
+
+        // Aplicamos os colapsos, descartando os triângulos degenerados.
+        size_t out = 0;
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            GLuint a = remap[result[i + 0]];
+            GLuint b = remap[result[i + 1]];
+            GLuint c = remap[result[i + 2]];
+            if (a == b || b == c || c == a)
+                continue;
+            result[out++] = a;
+            result[out++] = b;
+            result[out++] = c;
+        }
+        result.resize(out);
+    }
+
+    return (float)std::sqrt(std::max(max_cost, 0.0));
+}
+
+void Lod_BuildLevels(SceneObject* object, const std::vector<float>& model_coefficients, std::vector<GLuint>& indices)
+{
+    object->num_lods = 1;
+    object->lod_first_index[0] = object->first_index;
+    object->lod_num_indices[0] = object->num_indices;
+
+    if (object->rendering_mode != GL_TRIANGLES || object->num_indices / 3 < LOD_MIN_TRIANGLES)
+        return;
+
+    std::vector<GLuint> previous(indices.begin() + object->first_index,
+                                 indices.begin() + object->first_index + object->num_indices);
+    std::vector<GLuint> simplified;
+
+    while (object->num_lods < SCENE_MAX_LODS)
+    {
+        size_t target = (size_t)(previous.size() / 3 * LOD_REDUCTION) * 3;
+        Lod_SimplifyMesh(model_coefficients, previous.data(), previous.size(), target, simplified);
+
+        // Se a malha não pôde ser reduzida de forma significativa (por
+        // exemplo, se quase todos os vértices estão em bordas), um novo nível
+        // não traria ganho.
+        if (simplified.empty() || simplified.size() > previous.size() * 9 / 10)
+            break;
+
+        unsigned int lod = object->num_lods++;
+        object->lod_first_index[lod] = indices.size();
+        object->lod_num_indices[lod] = simplified.size();
+        indices.insert(indices.end(), simplified.begin(), simplified.end());
+
+        previous.swap(simplified);
+    }
+}
+
+unsigned int Lod_Select(const SceneObject& object, float projected_radius, unsigned int previous)
+{
+    unsigned int lod = std::min(previous, object.num_lods - 1);
+
+    // Menor na tela: níveis mais simples.
+    while (lod + 1 < object.num_lods && projected_radius < LOD_THRESHOLDS[lod] * (1.0f - LOD_HYSTERESIS))
+        ++lod;
+
+    // Maior na tela: níveis mais detalhados.
+    while (lod > 0 && projected_radius > LOD_THRESHOLDS[lod - 1] * (1.0f + LOD_HYSTERESIS))
+        --lod;
+
+    return lod;
+}
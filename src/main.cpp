@@ -44,12 +44,40 @@
 // Headers locais, definidos na pasta "include/"
 #include "utils.h"
 #include "matrices.h"
-#include "collisions.h"
+#include "block.h"
+#include "level.h"
+#include "world.h"
+#include "path.h"
+#include "solver.h"
+#include "chunk.h"
+#include "chunk_stream.h"
+#include "scene.h"
+#include "renderer.h"
+#include "gl_extensions.h"
+#include "gl_debug.h"
+#include "gl_state.h"
+#include "skybox.h"
+#include "lod.h"
+#include "meshlet.h"
+#include "impostor.h"
+#include "thread_pool.h"
+#include "dynamic_resolution.h"
+#include "render_graph.h"
+#include "oit.h"
+#include "idle.h"
 
 // Defines
-#define TAO 0.7
 #define TEXCOORD_SHADER_LOCATION 1
 
+// Opacidade dos objetos transparentes: o bloco de saída e o jogador.
+#define EXIT_OPACITY   0.5f
+#define PLAYER_OPACITY 0.6f
+
+// Chão carregado em chunks ao redor do jogador: raio, em chunks, e memória
+// máxima. Veja "chunk_stream.h".
+#define FLOOR_LOAD_RADIUS   4
+#define FLOOR_MEMORY_BUDGET (64 * 1024 * 1024)
+
 // Estrutura que representa um modelo geométrico carregado a partir de um
 // arquivo ".obj". Veja https://en.wikipedia.org/wiki/Wavefront_.obj_file .
 struct ObjModel
@@ -80,7 +108,6 @@ struct ObjModel
 // Declaração de várias funções utilizadas em main().  Essas estão definidas
 // logo após a definição de main() neste arquivo.
 GLuint BuildTriangles(); // Constrói triângulos para renderização
-GLuint BuildSceneryCube();
 GLuint LoadShader_Vertex(const char *filename); // Carrega um vertex shader
 GLuint LoadShader_Fragment(const char* filename); // Carrega um fragment shader
 void LoadShader(const char* filename, GLuint shader_id); // Função utilizada pelas duas acima
@@ -106,6 +133,9 @@ void TextRendering_ShowFail(GLFWwindow *window);
 void TextRendering_ShowVictory(GLFWwindow *window);
 void TextRendering_ShowProjection(GLFWwindow* window);
 void TextRendering_ShowFramesPerSecond(GLFWwindow* window);
+void TextRendering_ShowRendererStats(GLFWwindow* window);
+void TextRendering_ShowResolution(GLFWwindow* window);
+void TextRendering_ShowRenderGraph(GLFWwindow* window);
 void TextRendering_ShowBlockPosition(GLFWwindow *window);
 
 // Funções callback para comunicação com o sistema operacional e interação do
@@ -116,21 +146,12 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mode
 void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
 void CursorPosCallback(GLFWwindow* window, double xpos, double ypos);
 void ScrollCallback(GLFWwindow* window, double xoffset, double yoffset);
+void WindowRefreshCallback(GLFWwindow* window);
 
 // Carregamento de imagens para textura
+unsigned char* Load_BMP(const char *file_path, unsigned int *width, unsigned int *height);
 GLuint Load_Texture_BMP(const char *file_path);
 
-// Definimos uma estrutura que armazenará dados necessários para renderizar
-// cada objeto da cena virtual.
-struct SceneObject
-{
-    std::string  name;        // Nome do objeto
-    size_t       first_index; // Índice do primeiro vértice dentro do vetor indices[] definido em BuildTrianglesAndAddToVirtualScene()
-    size_t       num_indices; // Número de índices do objeto dentro do vetor indices[] definido em BuildTrianglesAndAddToVirtualScene()
-    GLenum       rendering_mode; // Modo de rasterização (GL_TRIANGLES, GL_TRIANGLE_STRIP, etc.)
-    GLuint       vertex_array_object_id; // ID do VAO onde estão armazenados os atributos do modelo
-};
-
 // Abaixo definimos variáveis globais utilizadas em várias funções do código.
 
 // A cena virtual é uma lista de objetos nomeados, guardados em um dicionário
@@ -142,21 +163,22 @@ std::map<std::string, SceneObject> g_VirtualScene;
 // Razão de proporção da janela (largura/altura). Veja função FramebufferSizeCallback().
 float g_ScreenRatio = 1.0f;
 
-// Ângulos de Euler que controlam a rotação do jogador na cena virtual
-float g_AngleX     = 0.0f;
-float g_AngleY     = 0.0f;
-float g_AngleZ     = 0.0f;
-// Posicionamento do jogador na cena virtual
-float g_PositionX  = 0.0f;
-float g_PositionZ  = 0.0f;
-float g_PositionY  = 0.0f;
-//Posicionamento da esfera na cena virtual
-float g_sphere_position_x = 0.0f;
-float g_sphere_position_y = 0.0f;
-float g_sphere_position_z = 0.0f;
+// Mundo do jogo (nível, jogador e esfera), criado em main(). A posição e a
+// rotação do bloco do jogador na cena virtual são derivadas do seu estado.
+// Veja "world.h".
+World* g_World = NULL;
+
+// Movimentos do jogador (BlockDirection) pedidos pelo teclado desde o último
+// quadro. Veja KeyCallback().
+std::vector<int> g_PendingMoves;
 
+#ifndef NDEBUG
+// Pedido de troca do estado das células dinâmicas (pontes) do nível, no
+// próximo quadro. Só existe no build de depuração, para exercitar a
+// reconstrução dos chunks. Veja KeyCallback().
+bool g_ToggleBridges = false;
+#endif
 
-int block_position = 1.0f;
 
 // "g_LeftMouseButtonPressed = true" se o usuário está com o botão esquerdo do mouse
 // pressionado no momento atual. Veja função MouseButtonCallback().
@@ -187,7 +209,7 @@ bool g_CameraFreelook = true;
 // Tempo
 double g_LastTime = glfwGetTime();
 
-int main()
+int main(int argc, char* argv[])
 {
     // Inicializamos a biblioteca GLFW, utilizada para criar uma janela do
     // sistema operacional, onde poderemos renderizar com OpenGL.
@@ -213,6 +235,12 @@ int main()
     // funções modernas de OpenGL.
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+    // Sem NDEBUG, pedimos um contexto de depuração, em que o driver valida
+    // as chamadas e nos envia mensagens detalhadas. Veja "gl_debug.h".
+    #ifndef NDEBUG
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+    #endif
+
     // Criamos uma janela do sistema operacional, com 800 colunas e 800 linhas
     // de pixels, e com título "INF01047 ...".
     GLFWwindow* window;
@@ -240,6 +268,11 @@ int main()
     glfwSetFramebufferSizeCallback(window, FramebufferSizeCallback);
     glfwSetWindowSize(window, 800, 800); // Forçamos a chamada do callback acima, para definir g_ScreenRatio.
 
+    // E a função chamada quando o conteúdo da janela precisa ser redesenhado
+    // (por exemplo, quando ela deixa de estar coberta por outra janela),
+    // mesmo que nada tenha mudado na cena.
+    glfwSetWindowRefreshCallback(window, WindowRefreshCallback);
+
     // Indicamos que as chamadas OpenGL deverão renderizar nesta janela
     glfwMakeContextCurrent(window);
 
@@ -247,6 +280,14 @@ int main()
     // biblioteca GLAD.
     gladLoadGLLoader((GLADloadproc) glfwGetProcAddress);
 
+    // Carregamento das funções de versões posteriores à 3.3, usadas
+    // opcionalmente pelo renderizador. Veja "gl_extensions.h".
+    GLExtensions_Load();
+
+    // Mensagens de depuração OpenGL, nomes de objetos e grupos. Veja
+    // "gl_debug.h".
+    GLDebug_Init();
+
     // Imprimimos no terminal informações sobre a GPU do sistema
     const GLubyte *vendor      = glGetString(GL_VENDOR);
     const GLubyte *renderer    = glGetString(GL_RENDERER);
@@ -270,9 +311,22 @@ int main()
     GLuint program_id = CreateGpuProgram(vertex_shader_id, fragment_shader_id);
 
     // Construímos a representação de um triângulo
-    GLuint vertex_array_object_id = BuildTriangles();
+    BuildTriangles();
+
+    // Inicializamos o renderizador, que escolhe entre o caminho OpenGL 3.3 e
+    // o caminho com multi-draw indirect. Veja "renderer.cpp".
+    Renderer_Init(program_id);
 
-    GLuint scenery_cube_VAO = BuildSceneryCube();
+    // Threads de trabalho, usadas pelo descarte por oclusão. Veja
+    // "thread_pool.h".
+    ThreadPool_Init(0);
+
+    // Framebuffer fora da tela onde a cena é renderizada com resolução
+    // variável. Veja "dynamic_resolution.cpp".
+    DynamicResolution_Init();
+
+    // Transparência independente de ordem. Veja "oit.cpp".
+    Oit_Init();
 
     // Inicializamos o código para renderização de texto.
     TextRendering_Init();
@@ -282,22 +336,80 @@ int main()
     GLuint ExitTexture = Load_Texture_BMP("../data/exit_texture.bmp");
     GLuint PlayerTexture = Load_Texture_BMP("../data/player_texture.bmp");
     GLuint SphereTexture = Load_Texture_BMP("../data/marble_texture_2.bmp");
-    GLuint SkyTexture = Load_Texture_BMP("../data/sky_texture.bmp");
     GLuint CatTexture = Load_Texture_BMP("../data/cat_texture.bmp");
     GLuint CatTexture2 = Load_Texture_BMP("../data/cat_texture_2.bmp");
 
-    // Buscamos o endereço das variáveis definidas dentro do Vertex Shader.
-    // Utilizaremos estas variáveis para enviar dados para a placa de vídeo
-    // (GPU)! Veja arquivo "shader_vertex.glsl".
-    GLint model_uniform           = glGetUniformLocation(program_id, "model"); // Variável da matriz "model"
-    GLint view_uniform            = glGetUniformLocation(program_id, "view"); // Variável da matriz "view" em shader_vertex.glsl
-    GLint projection_uniform      = glGetUniformLocation(program_id, "projection"); // Variável da matriz "projection" em shader_vertex.glsl
+    // Os gatos são decorativos e ficam longe da área de jogo: de longe, são
+    // desenhados como impostores, um para cada textura. Veja "impostor.cpp".
+    Impostor_Init(program_id);
+    Impostor CatImpostor  = Impostor_Create(g_VirtualScene["cat"], CatTexture);
+    Impostor CatImpostor2 = Impostor_Create(g_VirtualScene["cat"], CatTexture2);
+
+    // Céu: cubemap com a mesma imagem nas seis faces. Veja "skybox.cpp".
+    const char* const sky_faces[6] = {
+        "../data/sky_texture.bmp", "../data/sky_texture.bmp", // +X, -X
+        "../data/sky_texture.bmp", "../data/sky_texture.bmp", // +Y, -Y
+        "../data/sky_texture.bmp", "../data/sky_texture.bmp", // +Z, -Z
+    };
+    Skybox_Init(sky_faces);
+
+    // Nível: células com chão, usadas tanto para desenhar o chão quanto para
+    // saber se o jogador caiu. Veja "level.h".
+    // No build de depuração, um arquivo de nível pode ser passado na linha
+    // de comando (p. ex. "../data/nivel_pontes.txt"), no lugar do nível do
+    // jogo. Veja Level_LoadFile().
+    Level level;
+    bool level_loaded;
+#ifndef NDEBUG
+    if (argc > 1)
+        level_loaded = Level_LoadFile(&level, argv[1]);
+    else
+#endif
+        level_loaded = Level_LoadDefault(&level);
+    if (!level_loaded)
+    {
+        fprintf(stderr, "ERROR: cannot load the game level.\n");
+        std::exit(EXIT_FAILURE);
+    }
+    World world(&level);
+    g_World = &world;
+
+    // Verificamos se o nível tem solução, já que é barato. Veja "solver.h".
+    SolverResult solution;
+    if (Solver_Solve(&level, world.block(), true, &solution))
+        printf("Nivel: solucao em %d movimentos (%d estados visitados).\n", (int)solution.moves.size(), (int)solution.visited_states);
+    else
+        fprintf(stderr, "WARNING: level has no solution (%d states visited).\n", (int)solution.visited_states);
+
+    // E também se tem solução evitando a esfera, partindo no instante zero.
+    HazardTable hazards;
+    HazardTable_BuildDefault(&hazards);
+    if (Solver_SolveTimed(&level, &hazards, world.block(), 0, true, &solution))
+        printf("Nivel: solucao evitando a esfera em %.1f segundos (%d estados visitados).\n", solution.moves.size() * hazards.tick_length, (int)solution.visited_states);
+    else
+        fprintf(stderr, "WARNING: level has no solution avoiding the hazards (%d states visited).\n", (int)solution.visited_states);
+
+    // Caminho da esfera, também seguido por um dos gatos, com velocidade
+    // constante: ida e volta a cada 2 pi segundos. Veja "path.h".
+    Path path;
+    Path_LoadDefault(&path);
+    PathFollowers cat_walk;
+    PathFollowers_Add(&cat_walk, 0.0f, path.length / 3.141592f);
+    float cat_walk_time = 0.0f; // Tempo das animações no último avanço
+
+    // O chão é carregado e montado em chunks, por threads próprias, conforme
+    // o jogador anda. Veja "chunk_stream.h".
+    ChunkStream_Init([&level, &hazards](int cx, int cz, ChunkData* data) {
+        Chunk_FromLevel(&level, &hazards, cx, cz, data);
+    }, [&level](int x, int z) {
+        return Level_IsSolid(&level, x, z);
+    }, FLOOR_MEMORY_BUDGET, FLOOR_LOAD_RADIUS);
 
     // Habilitamos o Z-buffer. Veja slides 104-116 do documento Aula_09_Projecoes.pdf.
+    // O blending é ligado e desligado pelo renderizador, a cada passo do
+    // quadro. Veja Renderer_DrawScene().
     glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
 
-    glm::vec4 FindPoint(float t);
     // Variáveis auxiliares utilizadas para chamada à função
     // TextRendering_ShowModelViewProjection(), armazenando matrizes 4x4.
     glm::mat4 the_projection;
@@ -310,33 +422,42 @@ int main()
     bool show_fail = false;
     bool show_victory = true;
 
+    // Lista de objetos desenhados a cada quadro. Declarada fora do laço para
+    // reaproveitar a memória alocada. Veja Renderer_DrawScene().
+    std::vector<DrawItem> draw_list;
+
+    // Nível de detalhe usado no quadro anterior por cada instância de objeto
+    // com mais de um nível. Veja Lod_Select().
+    std::vector<unsigned int> hazard_lods;
+    unsigned int cat_lod[3] = { 0, 0, 0 };
+
+    // Quadros só são renderizados quando algo muda na tela. Veja "idle.h".
+    // Perigos em movimento mudam a tela (e o jogo) a cada instante.
+    Idle_Init();
+    const std::vector<float>& hazard_speeds = world.hazards().speed;
+    Idle_SetSimulating(std::find_if(hazard_speeds.begin(), hazard_speeds.end(), [](float v) { return v != 0.0f; }) != hazard_speeds.end());
+
     // Ficamos em loop, renderizando, até que o usuário feche a janela
     while (!glfwWindowShouldClose(window))
     {
-        float t=glfwGetTime()-start;
+        // Nada mudou: esperamos por eventos, sem renderizar. O tempo parado
+        // não deve contar como movimento da câmera.
+        if (!Idle_BeginFrame())
+        {
+            Idle_WaitEvents();
+            g_LastTime = glfwGetTime();
+            continue;
+        }
+
+        // Tempo das animações decorativas (gatos), que param no modo ocioso.
+        float t=Idle_DecorationTime()-start;
         float time_since_last_fail = glfwGetTime()-last_fail;
         if (time_since_last_fail > 4) {
             show_fail = false;
         }
 
 
-        // Aqui executamos as operações de renderização
-
-        // Definimos a cor do "fundo" do framebuffer como branco.  Tal cor é
-        // definida como coeficientes RGBA: Red, Green, Blue, Alpha; isto é:
-        // Vermelho, Verde, Azul, Alpha (valor de transparência).
-        // Conversaremos sobre sistemas de cores nas aulas de Modelos de Iluminação.
-        //
-        //           R     G     B     A
-        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-
-        // "Pintamos" todos os pixels do framebuffer com a cor definida acima,
-        // e também resetamos todos os pixels do Z-buffer (depth buffer).
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        // Pedimos para a GPU utilizar o programa de GPU criado acima (contendo
-        // os shaders de vértice e fragmentos).
-        glUseProgram(program_id);
+        draw_list.clear();
 
         glm::vec4 camera_view_vector;
         glm::vec4 camera_up_vector;
@@ -404,231 +525,226 @@ int main()
             projection = Matrix_Orthographic(l, r, b, t, nearplane, farplane);
         }
 
-        // Enviamos as matrizes "view" e "projection" para a placa de vídeo
-        // (GPU). Veja o arquivo "shader_vertex.glsl", onde estas são
-        // efetivamente aplicadas em todos os pontos.
-        glUniformMatrix4fv(view_uniform       , 1 , GL_FALSE , glm::value_ptr(view));
-        glUniformMatrix4fv(projection_uniform , 1 , GL_FALSE , glm::value_ptr(projection));
-
-        // Desenha o cubo do cenário
-        glBindVertexArray(scenery_cube_VAO);
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, SkyTexture);
-        glm::mat4 skybox = Matrix_Scale(100.0f, 100.0f, 100.0f) * Matrix_Translate(-0.5f, -0.5f, -0.5f);
-        glUniformMatrix4fv(model_uniform, 1, GL_FALSE, glm::value_ptr(skybox));
-        glDrawElements(
-            g_VirtualScene["scenery_cube_faces"].rendering_mode, // Veja slides 182-188 do documento Aula_04_Modelagem_Geometrica_3D.pdf
-            g_VirtualScene["scenery_cube_faces"].num_indices,
-            GL_UNSIGNED_INT,
-            (void *)g_VirtualScene["scenery_cube_faces"].first_index
-        );
-
-        // "Ligamos" o VAO. Informamos que queremos utilizar os atributos de
-        // vértices apontados pelo VAO criado pela função BuildTriangles(). Veja
-        // comentários detalhados dentro da definição de BuildTriangles().
-        glBindVertexArray(vertex_array_object_id);
-
-        // Desenho do mapa (chão) feito de cópias do bloco
-        for (int i = 1; i <= 35; ++i)
+        // O céu não faz parte da lista: é desenhado pelo renderizador, após
+        // todos os objetos opacos. Veja Skybox_Draw().
+
+        // Desenho do mapa (chão): uma malha por chunk carregado ao redor do
+        // jogador, mais o bloco de saída, que é transparente. Veja
+        // "chunk_stream.h". As células dinâmicas alteradas desde o último
+        // quadro são repassadas aos chunks antes.
+#ifndef NDEBUG
+        if (g_ToggleBridges)
         {
-            // Colocar as texturas
-            glActiveTexture(GL_TEXTURE0);
-            if (i == 29) {
-                glBindTexture(GL_TEXTURE_2D, ExitTexture);
-            } else {
-                glBindTexture(GL_TEXTURE_2D, FloorTexture);
+            for (size_t word = 0; word < level.dynamic.size(); ++word)
+            {
+                for (unsigned long long bits = level.dynamic[word]; bits != 0; bits &= bits - 1)
+                {
+                    int x = (int)(word % level.stride) * LEVEL_WORD_BITS + __builtin_ctzll(bits);
+                    int z = (int)(word / level.stride);
+                    Level_SetTile(&level, x, z, !Level_IsSolid(&level, x, z));
+                }
             }
+            g_ToggleBridges = false;
+        }
+#endif
+        Level_ConsumeDirty(&level, [&level](int x, int z) {
+            ChunkStream_SetTile(x, z, Level_IsSolid(&level, x, z));
+        });
+        ChunkStream_Update(world.block().x, world.block().z);
+        if (ChunkStream_IsLoading())
+            Idle_Invalidate();
+        ChunkStream_AppendDrawItems(&draw_list, FloorTexture);
+
+        if (ChunkStream_IsSolid(level.exit_x, level.exit_z))
+        {
+            glm::mat4 model = Matrix_Translate((float)level.exit_x, -0.11f, (float)level.exit_z)
+                            * Matrix_Scale(0.95f, 0.2f, 0.95f);
+            DrawItem exit = { &g_VirtualScene["cube_faces"], model, ExitTexture, RENDER_PASS_TRANSPARENT, NULL, NULL, false, true, EXIT_OPACITY };
+            draw_list.push_back(exit);
+        }
 
-            // Cada cópia do cubo possui uma matriz de modelagem independente,
-            // já que cada cópia estará em uma posição (rotação, escala, ...)
-            // diferente em relação ao espaço global (World Coordinates). Veja
-            // slides 2-14 e 184-190 do documento Aula_08_Sistemas_de_Coordenadas.pdf.
-            glm::mat4 model;
-
-            if      (i == 1)    { model = Matrix_Translate(0.0f, -0.11f, 0.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 2)    { model = Matrix_Translate(1.0f, -0.11f, 0.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 3)    { model = Matrix_Translate(2.0f, -0.11f, 0.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-
-            else if (i == 4)    { model = Matrix_Translate(0.0f, -0.11f, 1.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 5)    { model = Matrix_Translate(1.0f, -0.11f, 1.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 6)    { model = Matrix_Translate(2.0f, -0.11f, 1.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-
-            else if (i == 7)    { model = Matrix_Translate(0.0f, -0.11f, 2.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 8)    { model = Matrix_Translate(1.0f, -0.11f, 2.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 9)    { model = Matrix_Translate(2.0f, -0.11f, 2.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-
-            else if (i == 10)   { model = Matrix_Translate(1.0f, -0.11f, 3.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 11)   { model = Matrix_Translate(2.0f, -0.11f, 3.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-
-
-            else if (i == 12)   { model = Matrix_Translate(3.0f, -0.11f, 1.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 13)   { model = Matrix_Translate(4.0f, -0.11f, 1.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 14)   { model = Matrix_Translate(5.0f, -0.11f, 1.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-
-            else if (i == 15)   { model = Matrix_Translate(3.0f, -0.11f, 2.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 16)   { model = Matrix_Translate(4.0f, -0.11f, 2.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 17)   { model = Matrix_Translate(5.0f, -0.11f, 2.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-
-            else if (i == 18)   { model = Matrix_Translate(3.0f, -0.11f, 3.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 19)   { model = Matrix_Translate(4.0f, -0.11f, 3.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 20)   { model = Matrix_Translate(5.0f, -0.11f, 3.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-
-            else if (i == 21)   { model = Matrix_Translate(5.0f, -0.11f, 4.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-
-
-            else if (i == 22)   { model = Matrix_Translate(6.0f, -0.11f, 2.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 23)   { model = Matrix_Translate(7.0f, -0.11f, 2.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 24)   { model = Matrix_Translate(8.0f, -0.11f, 2.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-
-            else if (i == 25)   { model = Matrix_Translate(6.0f, -0.11f, 3.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 26)   { model = Matrix_Translate(7.0f, -0.11f, 3.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 27)   { model = Matrix_Translate(8.0f, -0.11f, 3.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-
-            else if (i == 28)   { model = Matrix_Translate(6.0f, -0.11f, 4.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 29)   { model = Matrix_Translate(7.0f, -0.11f, 4.0f) * Matrix_Scale(0.95f, 0.2f, 0.95f); }
-            else if (i == 30)   { model = Matrix_Translate(8.0f, -0.11f, 4.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-
-            else if (i == 31)   { model = Matrix_Translate(6.0f, -0.11f, 5.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 32)   { model = Matrix_Translate(7.0f, -0.11f, 5.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 33)   { model = Matrix_Translate(8.0f, -0.11f, 5.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-
-
-            else if (i == 34)   { model = Matrix_Translate(9.0f, -0.11f, 3.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-            else if (i == 35)   { model = Matrix_Translate(9.0f, -0.11f, 4.0f) * Matrix_Scale(1.0f, 0.2f, 1.0f); }
-
-
-
-            glUniformMatrix4fv(model_uniform, 1, GL_FALSE, glm::value_ptr(model));
+        //------------------------------------------ regras do jogo ---------------------------------------------------//
+        // O mundo avança até o tempo real, aplicando os movimentos pedidos
+        // desde o último quadro. Veja "world.h".
+        unsigned int events = 0;
+        double world_dt = (glfwGetTime() - start) - world.time();
+        if (g_PendingMoves.empty())
+            events |= world.step(WorldInput{ world_dt, WORLD_NO_MOVE });
+        for (size_t i = 0; i < g_PendingMoves.size(); ++i)
+            events |= world.step(WorldInput{ i == 0 ? world_dt : 0.0, g_PendingMoves[i] });
+        g_PendingMoves.clear();
+
+        if (events & WORLD_EVENT_FAILED)
+        {
+            last_fail = glfwGetTime();
+            show_fail = true;
 
+            // Um quadro para apagar a mensagem de falha (veja acima).
+            Idle_RedrawAt(last_fail + 4.0);
+        }
 
-            if (i == 29) { glBlendFunc(GL_DST_ALPHA, GL_DST_ALPHA); }
+        show_victory = world.victory();
 
-            glDrawElements(
-                g_VirtualScene["cube_faces"].rendering_mode, // Veja slides 182-188 do documento Aula_04_Modelagem_Geometrica_3D.pdf
-                g_VirtualScene["cube_faces"].num_indices,
-                GL_UNSIGNED_INT,
-                (void*)g_VirtualScene["cube_faces"].first_index
-            );
+        //---------------------------------------esfera inimiga--------------------------------------------------------//
+        // Uma esfera por perigo, exceto os que só passam por chunks não
+        // carregados, longe do jogador (veja "chunk_stream.h").
+        const HazardSet& world_hazards = world.hazards();
+        hazard_lods.resize(world_hazards.radius.size(), 0);
+        for (size_t h = 0; h < world_hazards.radius.size(); ++h)
+        {
+            if (!ChunkStream_IsHazardResident((int)h))
+                continue;
 
-            if (i == 29) { glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); }
+            float radius = world_hazards.radius[h];
+            glm::mat4 model = Matrix_Translate(world_hazards.x[h], world_hazards.y[h], world_hazards.z[h]) * Matrix_Scale(radius, radius, radius);
+            DrawItem sphere = { &g_VirtualScene["esfera_vermelha"], model, SphereTexture, RENDER_PASS_OPAQUE, &hazard_lods[h], NULL, false, false, 1.0f };
+            draw_list.push_back(sphere);
         }
 
-        //---------------------------------------esfera inimiga--------------------------------------------------------//
-        t=(1+sin(t))/2;
-        glm::vec4 translator = FindPoint(t);
-        g_sphere_position_x = 4.0f;
-        g_sphere_position_y = 0.7f;
-        g_sphere_position_z = 2 * translator.z - 3.0f;
-
-        glm::mat4 model = Matrix_Translate(g_sphere_position_x,g_sphere_position_y,g_sphere_position_z) * Matrix_Scale(0.38f, 0.38f, 0.38f);
-        glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glBindTexture(GL_TEXTURE_2D, SphereTexture);
-        glBindVertexArray(g_VirtualScene["esfera_vermelha"].vertex_array_object_id);
-        glDrawElements(
-            g_VirtualScene["esfera_vermelha"].rendering_mode, // Veja slides 182-188 do documento Aula_04_Modelagem_Geometrica_3D.pdf
-            g_VirtualScene["esfera_vermelha"].num_indices,
-            GL_UNSIGNED_INT,
-            (void *)g_VirtualScene["cube_faces"].first_index);
-
         //---------------------------------------esfera inimiga--------------------------------------------------------//
 
         //-------------------------------------- cubo jogador --------------------------------------------------//
-        model = Matrix_Translate(0.0f, 1.0f, 0.0f);
-        model = model   * Matrix_Translate(g_PositionX, g_PositionY, g_PositionZ)
-                        * Matrix_Rotate_Z(g_AngleZ)  // TERCEIRO rotação Z de Euler
-                        * Matrix_Rotate_Y(g_AngleY)  // SEGUNDO  rotação Y de Euler
-                        * Matrix_Rotate_X(g_AngleX)
+        glm::mat4 model = Matrix_Translate(0.0f, 1.0f, 0.0f);
+        BlockState block = world.block();
+        float block_x, block_y, block_z;
+        Block_GetCenter(block, &block_x, &block_y, &block_z);
+        model = model   * Matrix_Translate(block_x, block_y, block_z)
+                        * Matrix_Rotate_Z(block.orientation == BLOCK_LYING_X ? 3.141592f / 2 : 0.0f)
+                        * Matrix_Rotate_X(block.orientation == BLOCK_LYING_Z ? 3.141592f / 2 : 0.0f)
                         * Matrix_Scale(1.0f, 2.0f, 1.0f);
 
-        if (plane_collision() || sphere_collision())
-        {
-            g_PositionX = 0.0f;
-            g_PositionY = 0.0f;
-            g_PositionZ = 0.0f;
-            block_position = 1.0f;
-            g_AngleX = 0.0f;
-            g_AngleY = 0.0f;
-            g_AngleZ = 0.0f;
-
-            last_fail = glfwGetTime();
-            show_fail = true;
-        }
-
-        if (victory_cube_collision()) {
-            show_victory = true;
-        } else {
-            show_victory = false;
-        }
-
-        glBlendFunc(GL_DST_ALPHA, GL_DST_ALPHA);
-        glUniformMatrix4fv(model_uniform, 1, GL_FALSE, glm::value_ptr(model));
-        glBindTexture(GL_TEXTURE_2D, PlayerTexture);
-        glBindVertexArray(vertex_array_object_id);
-        glDrawElements(
-            g_VirtualScene["cube_faces"].rendering_mode, // Veja slides 182-188 do documento Aula_04_Modelagem_Geometrica_3D.pdf
-            g_VirtualScene["cube_faces"].num_indices,
-            GL_UNSIGNED_INT,
-            (void*)g_VirtualScene["cube_faces"].first_index
-        );
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        DrawItem player = { &g_VirtualScene["cube_faces"], model, PlayerTexture, RENDER_PASS_TRANSPARENT, NULL, NULL, false, false, PLAYER_OPACITY };
+        draw_list.push_back(player);
         //-------------------------------------- cubo jogador --------------------------------------------------//
 
         //---------------------------------------gatinho-------------------------------------------------------//
+        PathFollowers_Advance(&path, &cat_walk, t - cat_walk_time);
+        cat_walk_time = t;
+
         model =  Matrix_Translate(-5.0f, 3.0f, -5.0f)  * Matrix_Scale(0.1f, 0.1f, 0.1f)  * Matrix_Rotate_Y(6.3f*t);
-        glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glBindVertexArray(g_VirtualScene["cat"].vertex_array_object_id);
-        glBindTexture(GL_TEXTURE_2D, CatTexture);
-        glDrawElements(
-            g_VirtualScene["cat"].rendering_mode,
-            g_VirtualScene["cat"].num_indices,
-            GL_UNSIGNED_INT,
-            (void*)(g_VirtualScene["cat"].first_index * sizeof(GLuint))
-        );
-
-        model =   Matrix_Translate(translator.x * 2.0f, 0.0f, 0.0f)
+        DrawItem cat1 = { &g_VirtualScene["cat"], model, CatTexture, RENDER_PASS_OPAQUE, &cat_lod[0], &CatImpostor, false, false, 1.0f };
+        draw_list.push_back(cat1);
+
+        model =   Matrix_Translate(cat_walk.x[0] * 2.0f, 0.0f, 0.0f)
                 * Matrix_Translate(-1.5f, 3.0f, -5.0f)  * Matrix_Scale(0.1f, 0.1f, 0.1f) * Matrix_Rotate_Y(-6.3f*t);
-        glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glBindTexture(GL_TEXTURE_2D, CatTexture2);
-        glDrawElements(
-            g_VirtualScene["cat"].rendering_mode,
-            g_VirtualScene["cat"].num_indices,
-            GL_UNSIGNED_INT,
-            (void*)(g_VirtualScene["cat"].first_index * sizeof(GLuint))
-        );
+        DrawItem cat2 = { &g_VirtualScene["cat"], model, CatTexture2, RENDER_PASS_OPAQUE, &cat_lod[1], &CatImpostor2, false, false, 1.0f };
+        draw_list.push_back(cat2);
 
         model =  Matrix_Translate(15.0f, 3.0f, -5.0f)  * Matrix_Scale(0.1f, 0.1f, 0.1f) * Matrix_Rotate_Y(6.3f*t);
-        glUniformMatrix4fv(model_uniform, 1 , GL_FALSE , glm::value_ptr(model));
-        glBindTexture(GL_TEXTURE_2D, CatTexture);
-        glDrawElements(
-            g_VirtualScene["cat"].rendering_mode,
-            g_VirtualScene["cat"].num_indices,
-            GL_UNSIGNED_INT,
-            (void*)(g_VirtualScene["cat"].first_index * sizeof(GLuint))
-        );
+        DrawItem cat3 = { &g_VirtualScene["cat"], model, CatTexture, RENDER_PASS_OPAQUE, &cat_lod[2], &CatImpostor, false, false, 1.0f };
+        draw_list.push_back(cat3);
         //---------------------------------------gatinho-------------------------------------------------------//
 
-        // "Desligamos" o VAO, evitando assim que operações posteriores venham a
-        // alterar o mesmo. Isso evita bugs.
-        glBindVertexArray(0);
+        // Aqui executamos as operações de renderização, declaradas como passos
+        // de um grafo de renderização. Veja "render_graph.h".
+        RenderGraph_Begin();
+
+        int backbuffer_width, backbuffer_height;
+        RenderGraph_GetBackbufferSize(&backbuffer_width, &backbuffer_height);
+
+        RenderGraphResource backbuffer  = RenderGraph_ImportBackbuffer();
+        RenderGraphResource scene_color = RenderGraph_CreateTexture("scene_color", RENDER_GRAPH_RGBA8,   backbuffer_width, backbuffer_height);
+        RenderGraphResource scene_depth = RenderGraph_CreateTexture("scene_depth", RENDER_GRAPH_DEPTH24, backbuffer_width, backbuffer_height);
+
+        // A cena 3D é desenhada fora da tela, em resolução reduzida quando a
+        // GPU não dá conta da janela inteira. Veja "dynamic_resolution.h".
+        RenderGraphPass scene_pass = RenderGraph_AddPass("scene", [&]() {
+            DynamicResolution_BeginScene();
+
+            // Definimos a cor do "fundo" do framebuffer como branco.  Tal cor é
+            // definida como coeficientes RGBA: Red, Green, Blue, Alpha; isto é:
+            // Vermelho, Verde, Azul, Alpha (valor de transparência).
+            // Conversaremos sobre sistemas de cores nas aulas de Modelos de Iluminação.
+            //
+            //           R     G     B     A
+            glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+
+            // "Pintamos" todos os pixels do framebuffer com a cor definida acima,
+            // e também resetamos todos os pixels do Z-buffer (depth buffer).
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            // Enviamos a lista de objetos para o renderizador, junto com as
+            // matrizes "view" e "projection". Veja o arquivo "renderer.cpp".
+            Renderer_DrawScene(draw_list, view, projection);
+        });
+        RenderGraph_Write(scene_pass, scene_color);
+        RenderGraph_Write(scene_pass, scene_depth);
+
+        // Objetos transparentes, acumulados em qualquer ordem e então
+        // misturados sobre a cena. Veja "oit.h".
+        RenderGraphResource oit_accum  = RenderGraph_CreateTexture("oit_accum",  RENDER_GRAPH_RGBA16F, backbuffer_width, backbuffer_height);
+        RenderGraphResource oit_weight = RenderGraph_CreateTexture("oit_weight", RENDER_GRAPH_R16F,    backbuffer_width, backbuffer_height);
+
+        RenderGraphPass transparent_pass = RenderGraph_AddPass("transparent", [&]() {
+            DynamicResolution_SetViewport();
+            Oit_BeginAccumulation();
+            Renderer_DrawTransparent(view, projection);
+            Oit_EndAccumulation();
+        });
+        RenderGraph_Write(transparent_pass, oit_accum);
+        RenderGraph_Write(transparent_pass, oit_weight);
+        RenderGraph_Write(transparent_pass, scene_depth); // Somente o teste de profundidade
+
+        RenderGraphPass composite_pass = RenderGraph_AddPass("composite", [&]() {
+            DynamicResolution_SetViewport();
+            Oit_Composite(RenderGraph_GetTexture(oit_accum), RenderGraph_GetTexture(oit_weight));
+            DynamicResolution_EndScene();
+        });
+        RenderGraph_Read(composite_pass, oit_accum);
+        RenderGraph_Read(composite_pass, oit_weight);
+        RenderGraph_Write(composite_pass, scene_color);
+
+        // Ampliamos a cena para a janela.
+        RenderGraphPass upscale_pass = RenderGraph_AddPass("upscale", [&]() {
+            RenderGraph_BindReadFramebuffer(scene_color);
+            DynamicResolution_Upscale();
+        });
+        RenderGraph_Read(upscale_pass, scene_color);
+        RenderGraph_Write(upscale_pass, backbuffer);
+
+        // O texto abaixo é desenhado diretamente na janela, sempre na
+        // resolução nativa.
+        RenderGraphPass text_pass = RenderGraph_AddPass("text", [&]() {
+            // Imprimimos na tela as infos de ajuda.
+            //TextRendering_ShowHelp(window);
+
+            if( show_fail ) {
+                TextRendering_ShowFail(window);
+            }
+
+            if ( show_victory )
+            {
+                TextRendering_ShowVictory(window);
+            }
 
-        // Imprimimos na tela as infos de ajuda.
-        //TextRendering_ShowHelp(window);
+            // Imprimimos na informação sobre a matriz de projeção sendo utilizada.
+            TextRendering_ShowProjection(window);
 
-        if( show_fail ) {
-            TextRendering_ShowFail(window);
-        }
+            // Imprimimos na tela informação sobre o número de quadros renderizados
+            // por segundo (frames per second).
+            TextRendering_ShowFramesPerSecond(window);
 
-        if ( show_victory )
-        {
-            TextRendering_ShowVictory(window);
-        }
+            // Imprimimos na tela quantos objetos foram desenhados e quantos foram
+            // descartados por estarem fora do campo de visão.
+            TextRendering_ShowRendererStats(window);
+
+            // Imprimimos na tela a escala de resolução atual da cena e o tempo de
+            // GPU medido.
+            TextRendering_ShowResolution(window);
+
+            // Imprimimos na tela o tempo de GPU de cada passo do grafo.
+            TextRendering_ShowRenderGraph(window);
+        });
+        RenderGraph_Write(text_pass, backbuffer);
+
+        RenderGraph_Execute();
 
-        // Imprimimos na informação sobre a matriz de projeção sendo utilizada.
-        TextRendering_ShowProjection(window);
+        // Contagem de chamadas OpenGL executadas e descartadas pelo cache de
+        // estado neste quadro, mostrada no próximo. Veja "gl_state.h".
+        GLState_EndFrame();
 
-        // Imprimimos na tela informação sobre o número de quadros renderizados
-        // por segundo (frames per second).
-        TextRendering_ShowFramesPerSecond(window);
+        // Imprimimos os erros e avisos OpenGL recebidos durante o quadro.
+        GLDebug_Flush();
 
         // O framebuffer onde OpenGL executa as operações de renderização não
         // é o mesmo que está sendo mostrado para o usuário, caso contrário
@@ -644,171 +760,21 @@ int main()
         // pela biblioteca GLFW.
         glfwPollEvents();
 
-
+        // Teclas de movimento mantidas pressionadas movem a câmera a cada
+        // quadro, sem gerar novos eventos.
+        if (g_MoveForward || g_MoveLeft || g_MoveBackward || g_MoveRight)
+            Idle_NotifyInput();
     }
 
     // Finalizamos o uso dos recursos do sistema operacional
+    ChunkStream_Terminate();
+    ThreadPool_Terminate();
     glfwTerminate();
 
     // Fim do programa
     return 0;
 }
 
-// Constrói cubo do cenário
-GLuint BuildSceneryCube()
-{
-    // Geometria: conjunto de vértices.
-    GLfloat model_coefficients[] = {
-        //    X      Y      Z     W
-                                      // face 0
-           0.0f,  0.0f,  0.0f,  1.0f, // vértice 0
-           1.0f,  0.0f,  0.0f,  1.0f, // vértice 1
-           0.0f,  1.0f,  0.0f,  1.0f, // vértice 2
-           1.0f,  1.0f,  0.0f,  1.0f, // vértice 3
-
-                                      // face 1
-           0.0f,  0.0f,  1.0f,  1.0f, // vértice 4
-           0.0f,  0.0f,  0.0f,  1.0f, // vértice 5
-           0.0f,  1.0f,  1.0f,  1.0f, // vértice 6
-           0.0f,  1.0f,  0.0f,  1.0f, // vértice 7
-
-                                      // face 2
-           1.0f,  0.0f,  1.0f,  1.0f, // vértice 8
-           0.0f,  0.0f,  1.0f,  1.0f, // vértice 9
-           1.0f,  1.0f,  1.0f,  1.0f, // vértice 10
-           0.0f,  1.0f,  1.0f,  1.0f, // vértice 11
-
-                                      // face 3
-           1.0f,  0.0f,  0.0f,  1.0f, // vértice 12
-           1.0f,  0.0f,  1.0f,  1.0f, // vértice 13
-           1.0f,  1.0f,  0.0f,  1.0f, // vértice 14
-           1.0f,  1.0f,  1.0f,  1.0f, // vértice 15
-
-                                      // face 4
-           0.0f,  0.0f,  1.0f,  1.0f, // vértice 16
-           1.0f,  0.0f,  1.0f,  1.0f, // vértice 17
-           0.0f,  0.0f,  0.0f,  1.0f, // vértice 18
-           1.0f,  0.0f,  0.0f,  1.0f, // vértice 19
-
-                                      // face 5
-           0.0f,  1.0f,  1.0f,  1.0f, // vértice 20
-           1.0f,  1.0f,  1.0f,  1.0f, // vértice 21
-           0.0f,  1.0f,  0.0f,  1.0f, // vértice 22
-           1.0f,  1.0f,  0.0f,  1.0f, // vértice 23
-    };
-
-    GLuint VBO_model_coefficients_id;
-    glGenBuffers(1, &VBO_model_coefficients_id);
-
-    GLuint vertex_array_object_id;
-    glGenVertexArrays(1, &vertex_array_object_id);
-    glBindVertexArray(vertex_array_object_id);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO_model_coefficients_id);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(model_coefficients), NULL, GL_STATIC_DRAW);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(model_coefficients), model_coefficients);
-    GLuint location = 0;            // "(location = 0)" em "shader_vertex.glsl"
-    GLint number_of_dimensions = 4; // vec4 em "shader_vertex.glsl"
-    glVertexAttribPointer(location, number_of_dimensions, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(location);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    // UV coords.: Texturas.
-    GLfloat texture_coordinates[] = {
-        //  U       V
-                          // face 0
-            0.0f,   0.0f, // coordenada UV  0
-            1.0f,   0.0f, // coordenada UV  1
-            0.0f,   1.0f, // coordenada UV  2
-            1.0f,   1.0f, // coordenada UV  3
-
-                          // face 1
-            0.0f,   0.0f, // coordenada UV  4
-            1.0f,   0.0f, // coordenada UV  5
-            0.0f,   1.0f, // coordenada UV  6
-            1.0f,   1.0f, // coordenada UV  7
-
-                          // face 2
-            0.0f,   0.0f, // coordenada UV  8
-            1.0f,   0.0f, // coordenada UV  9
-            0.0f,   1.0f, // coordenada UV  10
-            1.0f,   1.0f, // coordenada UV  11
-
-                          // face 3
-            0.0f,   0.0f, // coordenada UV  12
-            1.0f,   0.0f, // coordenada UV  13
-            0.0f,   1.0f, // coordenada UV  14
-            1.0f,   1.0f, // coordenada UV  15
-
-                          // face 4
-            0.0f,   0.0f, // coordenada UV  16
-            1.0f,   0.0f, // coordenada UV  17
-            0.0f,   1.0f, // coordenada UV  18
-            1.0f,   1.0f, // coordenada UV  19
-
-                          // face 5
-            0.0f,   0.0f, // coordenada UV  20
-            1.0f,   0.0f, // coordenada UV  21
-            0.0f,   1.0f, // coordenada UV  22
-            1.0f,   1.0f, // coordenada UV  23
-    };
-
-    GLuint VBO_texture_coordinates_id;
-    glGenBuffers(1, &VBO_texture_coordinates_id);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO_texture_coordinates_id);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(texture_coordinates), NULL, GL_STATIC_DRAW);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(texture_coordinates), texture_coordinates);
-    location = TEXCOORD_SHADER_LOCATION; // "(location = 1)" em "shader_vertex.glsl"
-    number_of_dimensions = 2;            // vec2 em "shader_vertex.glsl"
-    glVertexAttribPointer(location, number_of_dimensions, GL_FLOAT, GL_FALSE, 0, 0);
-    glEnableVertexAttribArray(location);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    // Triângulos.
-    GLuint indices[] = {
-
-                 // face 0
-        0, 1, 2, // triângulo 0
-        1, 2, 3, // triângulo 1
-
-                 // face 1
-        4, 5, 6, // triângulo 2
-        5, 6, 7, // triângulo 3
-
-                    // face 2
-        8, 9,  10,  // triângulo 4
-        9, 10, 11,  // triângulo 5
-
-                    // face 3
-        12, 13, 14, // triângulo 6
-        13, 14, 15, // triângulo 7
-
-                    // face 4
-        16, 17, 18, // triângulo 8
-        17, 18, 19, // triângulo 9
-
-                    // face 5
-        20, 21, 22, // triângulo 10
-        21, 22, 23, // triângulo 11
-    };
-
-    SceneObject cube_faces;
-    cube_faces.name = "Cubo (faces texturizadas)";
-    cube_faces.first_index = 0;
-    cube_faces.num_indices = sizeof(indices) / sizeof(indices[0]);
-    cube_faces.rendering_mode = GL_TRIANGLES; // Índices correspondem ao tipo de rasterização GL_TRIANGLES.
-    g_VirtualScene["scenery_cube_faces"] = cube_faces;
-
-    GLuint indices_id;
-    glGenBuffers(1, &indices_id);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices_id);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), NULL, GL_STATIC_DRAW);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(indices), indices);
-    glBindVertexArray(0);
-
-    return vertex_array_object_id;
-}
-
 // Constrói triângulos para futura renderização
 GLuint BuildTriangles()
 {
@@ -954,6 +920,23 @@ GLuint BuildTriangles()
     cube_faces.first_index    =  0; // Primeiro índice está em indices[0]
     cube_faces.num_indices    = 36;       // Último índice está em indices[35]; total de 36 índices.
     cube_faces.rendering_mode = GL_TRIANGLES; // Índices correspondem ao tipo de rasterização GL_TRIANGLES.
+    cube_faces.vertex_array_object_id = vertex_array_object_id;
+    SceneObject_ComputeBounds(&cube_faces, model_coefficients, indices, cube_faces.num_indices);
+    cube_faces.num_lods = 1; // Somente a malha original (veja "lod.h")
+    cube_faces.lod_first_index[0] = cube_faces.first_index;
+    cube_faces.lod_num_indices[0] = cube_faces.num_indices;
+    cube_faces.lod_first_meshlet[0] = 0; // Pequeno demais para ser dividido em meshlets
+    cube_faces.lod_num_meshlets[0] = 0;
+    cube_faces.revision = 0;
+    cube_faces.cpu_positions = NULL; // Está em g_SceneGeometry
+    cube_faces.cpu_indices = NULL;
+
+    // Copiamos a geometria também para g_SceneGeometry. Veja "scene.h".
+    SceneGeometry_Append(
+        std::vector<float>(model_coefficients, model_coefficients + sizeof(model_coefficients) / sizeof(GLfloat)),
+        std::vector<float>(texture_coordinates, texture_coordinates + sizeof(texture_coordinates) / sizeof(GLfloat)),
+        std::vector<GLuint>(indices, indices + sizeof(indices) / sizeof(GLuint)),
+        &cube_faces.pool_base_vertex, &cube_faces.pool_first_index);
 
     // Adicionamos o objeto criado acima na nossa cena virtual (g_VirtualScene).
     g_VirtualScene["cube_faces"] = cube_faces;
@@ -1143,6 +1126,11 @@ void FramebufferSizeCallback(GLFWwindow* window, int width, int height)
     // "Screen Mapping" ou "Viewport Mapping" vista em aula ({+ViewportMapping2+}).
     glViewport(0, 0, width, height);
 
+    // O framebuffer fora da tela acompanha o tamanho da janela.
+    DynamicResolution_Resize(width, height);
+    RenderGraph_Resize(width, height);
+    Idle_Invalidate();
+
     // Atualizamos também a razão que define a proporção da janela (largura /
     // altura), a qual será utilizada na definição das matrizes de projeção,
     // tal que não ocorra distorções durante o processo de "Screen Mapping"
@@ -1161,6 +1149,8 @@ double g_LastCursorPosX, g_LastCursorPosY;
 // Função callback chamada sempre que o usuário aperta algum dos botões do mouse
 void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
 {
+    Idle_NotifyInput();
+
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
     {
         // Se o usuário pressionou o botão esquerdo do mouse, guardamos a
@@ -1192,6 +1182,8 @@ void CursorPosCallback(GLFWwindow* window, double xpos, double ypos)
     if (!g_LeftMouseButtonPressed)
         return;
 
+    Idle_NotifyInput();
+
     // Deslocamento do cursor do mouse em x e y de coordenadas de tela!
     float dx = xpos - g_LastCursorPosX;
     float dy = ypos - g_LastCursorPosY;
@@ -1219,6 +1211,8 @@ void CursorPosCallback(GLFWwindow* window, double xpos, double ypos)
 // Função callback chamada sempre que o usuário movimenta a "rodinha" do mouse.
 void ScrollCallback(GLFWwindow* window, double xoffset, double yoffset)
 {
+    Idle_NotifyInput();
+
     // Atualizamos a distância da câmera para a origem utilizando a
     // movimentação da "rodinha", simulando um ZOOM.
     g_CameraDistance -= 0.1f*yoffset;
@@ -1233,6 +1227,14 @@ void ScrollCallback(GLFWwindow* window, double xoffset, double yoffset)
         g_CameraDistance = verysmallnumber;
 }
 
+// Função callback chamada quando o conteúdo da janela precisa ser redesenhado.
+// Fora do modo ocioso o próximo quadro já faria isso; no modo ocioso, pedimos
+// um novo quadro (veja "idle.h").
+void WindowRefreshCallback(GLFWwindow* window)
+{
+    Idle_Invalidate();
+}
+
 // Definição da função que será chamada sempre que o usuário pressionar alguma
 // tecla do teclado. Veja http://www.glfw.org/docs/latest/input_guide.html#input_key
 void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mod)
@@ -1245,20 +1247,13 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mod)
             std::exit(100 + i);
     // ================
 
+    // Toda tecla pode mudar a cena (veja "idle.h").
+    Idle_NotifyInput();
+
     // Se o usuário pressionar a tecla ESC, fechamos a janela.
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
         glfwSetWindowShouldClose(window, GL_TRUE);
 
-    // O código abaixo implementa a seguinte lógica:
-    //   Se apertar tecla X       então g_AngleX += delta;
-    //   Se apertar tecla shift+X então g_AngleX -= delta;
-    //   Se apertar tecla Y       então g_AngleY += delta;
-    //   Se apertar tecla shift+Y então g_AngleY -= delta;
-    //   Se apertar tecla Z       então g_AngleZ += delta;
-    //   Se apertar tecla shift+Z então g_AngleZ -= delta;
-
-    float delta = 3.141592 /2; // 90 graus, em radianos.
-
     // Se o usuário apertar a tecla P, utilizamos projeção perspectiva.
     if (key == GLFW_KEY_P && action == GLFW_PRESS)
     {
@@ -1277,6 +1272,14 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mod)
         g_ShowInfoText = !g_ShowInfoText;
     }
 
+#ifndef NDEBUG
+    // Se o usuário apertar a tecla B, as pontes do nível aparecem ou somem.
+    if (key == GLFW_KEY_B && action == GLFW_PRESS)
+    {
+        g_ToggleBridges = true;
+    }
+#endif
+
     if (key == GLFW_KEY_L && action == GLFW_PRESS)
     {
         if (g_CameraFreelook == false) g_CameraFreelook = true;
@@ -1298,71 +1301,14 @@ void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mod)
 
     //----------------------movimentação bloco----------------------------------------------------;;
 
- if ((key == GLFW_KEY_LEFT || key == GLFW_KEY_RIGHT || key == GLFW_KEY_UP|| key == GLFW_KEY_DOWN )&& action == GLFW_PRESS){
-    switch (block_position){
-    case 1:{
-         if ((key == GLFW_KEY_LEFT || key == GLFW_KEY_RIGHT )&& action == GLFW_PRESS){
-                block_position = 3;
-                g_AngleX = 0;
-                g_AngleY = 0;
-                if (g_AngleZ < 2*delta)   {g_AngleZ += delta;}  else {g_AngleZ += - delta;}
-                if (key == GLFW_KEY_LEFT) {g_PositionX+= -1.5;} else {g_PositionX += +1.5;}
-                g_PositionY = -0.5;
-         }
-
-         if ((key == GLFW_KEY_UP|| key == GLFW_KEY_DOWN ) && action == GLFW_PRESS){
-                block_position = 2;
-                g_AngleY = 0;
-                g_AngleZ = 0;
-                if (g_AngleX < 2*delta)   {g_AngleX += + delta;}  else {g_AngleX += - delta;}
-                if (key == GLFW_KEY_DOWN) {g_PositionZ += +1.5;}  else  {g_PositionZ += -1.5;}
-                g_PositionY = -0.5;
-         }
-         break;
-    }
-
-    case 2:{
-         if ((key == GLFW_KEY_LEFT || key == GLFW_KEY_RIGHT ) && action == GLFW_PRESS){
-                block_position = 2;
-                g_AngleY = 0;
-                if (g_AngleZ < 2*delta)   {g_AngleZ += delta;}  else {g_AngleZ += - delta;}
-                if (key == GLFW_KEY_LEFT) {g_PositionX+= -1.0;} else {g_PositionX += +1.0;}
-                g_PositionY = -0.5;
-         }
-
-         if ((key == GLFW_KEY_UP|| key == GLFW_KEY_DOWN ) && action == GLFW_PRESS){
-                block_position = 1;
-                g_AngleY = 0;
-                g_AngleZ = 0;
-                if (g_AngleX < 2*delta)   {g_AngleX += + delta;}  else {g_AngleX += - delta;}
-                if (key == GLFW_KEY_DOWN) {g_PositionZ += +1.5;}  else  {g_PositionZ += -1.5;}
-                g_PositionY = 0.0;
-         }
-         break;
+    // Cada seta rola o bloco uma vez, no próximo quadro. Veja World::step().
+    if (action == GLFW_PRESS)
+    {
+        if (key == GLFW_KEY_LEFT)  g_PendingMoves.push_back(BLOCK_LEFT);
+        if (key == GLFW_KEY_RIGHT) g_PendingMoves.push_back(BLOCK_RIGHT);
+        if (key == GLFW_KEY_UP)    g_PendingMoves.push_back(BLOCK_UP);
+        if (key == GLFW_KEY_DOWN)  g_PendingMoves.push_back(BLOCK_DOWN);
     }
-    case 3:{
-         if ((key == GLFW_KEY_LEFT || key == GLFW_KEY_RIGHT ) && action == GLFW_PRESS){
-                block_position = 1;
-                g_AngleX = 0;
-                g_AngleY = 0;
-                if (g_AngleZ < 2*delta)   {g_AngleZ += delta;}  else {g_AngleZ += - delta;}
-                if (key == GLFW_KEY_LEFT) {g_PositionX+= -1.5;} else {g_PositionX += +1.5;}
-                g_PositionY = 0.0;
-
-         }
-
-         if ((key == GLFW_KEY_UP|| key == GLFW_KEY_DOWN ) && action == GLFW_PRESS){
-                block_position = 3;
-                g_AngleX = 0;
-                if (g_AngleY < 2*delta)   {g_AngleY += delta;}  else {g_AngleY += - delta;}
-                if (key == GLFW_KEY_DOWN) {g_PositionZ += +1.0;}  else  {g_PositionZ += -1.0;}
-                g_PositionY = -0.5;
-         }
-
-         break;
-    }}
-
-}
 
     //----------------------movimentação bloco----------------------------------------------------;;
 }
@@ -1373,17 +1319,11 @@ void ErrorCallback(int error, const char* description)
     fprintf(stderr, "ERROR: GLFW: %s\n", description);
 }
 
-// Carregamento de imagens (textura) formato BMP
+// Leitura de imagens formato BMP (24 bits, BGR). Retorna um buffer alocado
+// com "new []", que deve ser liberado com "delete []", ou NULL em caso de erro.
 // Inspirado no tutorial https://www.opengl-tutorial.org/beginners-tutorials/tutorial-5-a-textured-cube/
-GLuint Load_Texture_BMP(const char *file_path)
+unsigned char* Load_BMP(const char *file_path, unsigned int *out_width, unsigned int *out_height)
 {
-    // Cria uma textura OpenGL
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-
-    // Faz o bind da textura
-    glBindTexture(GL_TEXTURE_2D, textureID);
-
     // ### Leitura do arquivo ###
     unsigned char header[54];   // Todo arquivo BMP começa com um cabeçalho de 54 bytes
     unsigned int payload_start; // Posição em que começa o payload da imagem
@@ -1394,17 +1334,19 @@ GLuint Load_Texture_BMP(const char *file_path)
     if (!file)
     {
         printf("O arquivo com a textura nao foi localizado!\n");
-        return 0;
+        return NULL;
     }
     if (fread(header, 1, 54, file) != 54)
     { // Se não tiver lido 54 bytes, o arquivo está malformado.
         printf("O arquivo para textura esta errado.\n");
-        return false;
+        fclose(file);
+        return NULL;
     }
     if (header[0] != 'B' || header[1] != 'M')
     { // Checagem dos magic bytes BM de todo arquivo BMP
         printf("O arquivo para textura nao e um BMP.\n");
-        return 0;
+        fclose(file);
+        return NULL;
     }
     // Leitura dos metadados
     payload_start = *(int *)&(header[0x0A]);
@@ -1424,8 +1366,29 @@ GLuint Load_Texture_BMP(const char *file_path)
     fclose(file);
     // ### Fim da leitura do arquivo ###
 
+    *out_width = width;
+    *out_height = height;
+    return data;
+}
+
+// Carregamento de imagens (textura) formato BMP
+GLuint Load_Texture_BMP(const char *file_path)
+{
+    unsigned int width, height;
+    unsigned char *data = Load_BMP(file_path, &width, &height);
+    if (!data)
+        return 0;
+
+    // Cria uma textura OpenGL
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+
+    // Faz o bind da textura
+    glBindTexture(GL_TEXTURE_2D, textureID);
+
     // Passa a imagem para o OpenGL
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_BGR, GL_UNSIGNED_BYTE, data);
+    delete [] data;
 
     // Configurações necessárias
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -1518,8 +1481,75 @@ void TextRendering_ShowFramesPerSecond(GLFWwindow* window)
     TextRendering_PrintString(window, buffer, 1.0f-(numchars + 1)*charwidth, 1.0f-lineheight, 1.0f);
 }
 
-// Escrevemos na tela os ângulos de Euler definidos nas variáveis globais
-// g_AngleX, g_AngleY, e g_AngleZ.
+// Escrevemos na tela os contadores do renderizador (objetos visíveis e
+// descartados) e do cache de estado OpenGL do último quadro.
+void TextRendering_ShowRendererStats(GLFWwindow* window)
+{
+    if ( !g_ShowInfoText )
+        return;
+
+    const RendererStats& stats = Renderer_GetStats();
+
+    float lineheight = TextRendering_LineHeight(window);
+
+    char buffer[80];
+    snprintf(buffer, 80, "%u visible (%u cached), %u culled, %u occluded",
+             stats.visible_objects, stats.cached_objects, stats.culled_objects, stats.occluded_objects);
+    TextRendering_PrintString(window, buffer, -1.0f+lineheight/10, 1.0f-lineheight, 1.0f);
+
+    snprintf(buffer, 80, "%u/%u meshlets, %u tris, %u impostors",
+             stats.visible_meshlets, stats.visible_meshlets + stats.culled_meshlets, stats.triangles,
+             stats.impostors);
+    TextRendering_PrintString(window, buffer, -1.0f+lineheight/10, 1.0f-2*lineheight, 1.0f);
+
+    GLStateStats gl_stats = GLState_GetFrameStats();
+    snprintf(buffer, 80, "%lu state calls, %lu elided", gl_stats.issued, gl_stats.elided);
+    TextRendering_PrintString(window, buffer, -1.0f+lineheight/10, 1.0f-3*lineheight, 1.0f);
+}
+
+// Escrevemos na tela a escala de resolução da cena e o tempo de GPU, usados
+// pela resolução dinâmica.
+void TextRendering_ShowResolution(GLFWwindow* window)
+{
+    if ( !g_ShowInfoText )
+        return;
+
+    char buffer[40];
+    int numchars = snprintf(buffer, 40, "%.0f%% res, %.1f ms GPU",
+                            100.0f * DynamicResolution_GetScale(), DynamicResolution_GetGpuMilliseconds());
+
+    float lineheight = TextRendering_LineHeight(window);
+    float charwidth = TextRendering_CharWidth(window);
+
+    TextRendering_PrintString(window, buffer, 1.0f-(numchars + 1)*charwidth, 1.0f-2*lineheight, 1.0f);
+}
+
+// Escrevemos na tela, abaixo da resolução, o tempo de GPU de cada passo do
+// grafo de renderização e a memória das suas texturas temporárias.
+void TextRendering_ShowRenderGraph(GLFWwindow* window)
+{
+    if ( !g_ShowInfoText )
+        return;
+
+    float lineheight = TextRendering_LineHeight(window);
+    float charwidth = TextRendering_CharWidth(window);
+
+    RenderGraphStats stats = RenderGraph_GetStats();
+
+    char buffer[40];
+    int numchars = snprintf(buffer, 40, "%u passes, %.1f MB",
+                            stats.passes - stats.culled_passes, stats.pool_bytes / (1024.0 * 1024.0));
+    TextRendering_PrintString(window, buffer, 1.0f-(numchars + 1)*charwidth, 1.0f-3*lineheight, 1.0f);
+
+    for (int i = 0; i < RenderGraph_GetTimedPassCount(); ++i)
+    {
+        numchars = snprintf(buffer, 40, "%s %.2f ms",
+                            RenderGraph_GetTimedPassName(i), RenderGraph_GetTimedPassMilliseconds(i));
+        TextRendering_PrintString(window, buffer, 1.0f-(numchars + 1)*charwidth, 1.0f-(4+i)*lineheight, 1.0f);
+    }
+}
+
+// Escrevemos na tela a orientação e a posição do jogador, do mundo g_World.
 void TextRendering_ShowBlockPosition(GLFWwindow *window)
 {
     if (!g_ShowInfoText)
@@ -1528,7 +1558,10 @@ void TextRendering_ShowBlockPosition(GLFWwindow *window)
     float pad = TextRendering_LineHeight(window);
 
     char buffer[80];
-    snprintf(buffer, 80, "Player: Config: (%i) | Pos: (%.2f) X, (%.2f) Y, (%.2f) Z\n", block_position, g_PositionX, g_PositionY, g_PositionZ);
+    BlockState block = g_World->block();
+    float block_x, block_y, block_z;
+    Block_GetCenter(block, &block_x, &block_y, &block_z);
+    snprintf(buffer, 80, "Player: Config: (%i) | Pos: (%.2f) X, (%.2f) Y, (%.2f) Z\n", (int)block.orientation + 1, block_x, block_y, block_z);
 
     TextRendering_PrintString(window, buffer, -1.0f + pad / 10, -1.0f + 2 * pad / 10, 1.0f);
 }
@@ -1544,6 +1577,17 @@ void BuildTrianglesAndAddToVirtualScene(ObjModel* model)
     std::vector<float>  model_coefficients;
     std::vector<float>  texture_coefficients;
 
+    // Posição onde a geometria deste modelo será colocada em g_SceneGeometry.
+    // Veja SceneGeometry_Append() abaixo.
+    GLint  pool_base_vertex = (GLint)(g_SceneGeometry.model_coefficients.size() / 4);
+    GLuint pool_first_index = (GLuint)g_SceneGeometry.indices.size();
+
+    // Vértices já criados, identificados pelo par (índice da posição, índice
+    // da coordenada de textura) do arquivo OBJ. Triângulos vizinhos passam a
+    // compartilhar vértices, o que é necessário para a simplificação da malha
+    // em Lod_BuildLevels() e evita processar o mesmo vértice várias vezes.
+    std::map< std::pair<int, int>, GLuint > vertex_ids;
+
     for (size_t shape = 0; shape < model->shapes.size(); ++shape)
     {
         size_t first_index = indices.size();
@@ -1557,7 +1601,17 @@ void BuildTrianglesAndAddToVirtualScene(ObjModel* model)
             {
                 tinyobj::index_t idx = model->shapes[shape].mesh.indices[3*triangle + vertex];
 
-                indices.push_back(first_index + 3*triangle + vertex);
+                std::pair<int, int> key(idx.vertex_index, idx.texcoord_index);
+                std::map< std::pair<int, int>, GLuint >::iterator found = vertex_ids.find(key);
+                if (found != vertex_ids.end())
+                {
+                    indices.push_back(found->second);
+                    continue;
+                }
+
+                GLuint vertex_id = (GLuint)(model_coefficients.size() / 4);
+                vertex_ids[key] = vertex_id;
+                indices.push_back(vertex_id);
 
                 const float vx = model->attrib.vertices[3*idx.vertex_index + 0];
                 const float vy = model->attrib.vertices[3*idx.vertex_index + 1];
@@ -1586,6 +1640,17 @@ void BuildTrianglesAndAddToVirtualScene(ObjModel* model)
         theobject.num_indices    = last_index - first_index + 1; // Número de indices
         theobject.rendering_mode = GL_TRIANGLES;       // Índices correspondem ao tipo de rasterização GL_TRIANGLES.
         theobject.vertex_array_object_id = vertex_array_object_id;
+        theobject.pool_first_index = pool_first_index + (GLuint)first_index;
+        theobject.pool_base_vertex = pool_base_vertex;
+        theobject.revision = 0;
+        theobject.cpu_positions = NULL;
+        theobject.cpu_indices = NULL;
+        SceneObject_ComputeBounds(&theobject, model_coefficients.data(), &indices[first_index], theobject.num_indices);
+
+        // Versões simplificadas da malha, adicionadas ao final de indices[],
+        // e divisão de cada versão em meshlets.
+        Lod_BuildLevels(&theobject, model_coefficients, indices);
+        Meshlet_Build(&theobject, model_coefficients, indices);
 
         g_VirtualScene[model->shapes[shape].name] = theobject;
     }
@@ -1626,47 +1691,7 @@ void BuildTrianglesAndAddToVirtualScene(ObjModel* model)
     // "Desligamos" o VAO, evitando assim que operações posteriores venham a
     // alterar o mesmo. Isso evita bugs.
     glBindVertexArray(0);
-}
-
-glm::vec4 FindPoint(float t)
-{
- glm::vec4 p1,p2,p3,p4,p5,p6,p7;
-
- p1=glm::vec4(1.0f, 1.0f, 3.0f, 0.0f);
- p2=glm::vec4(2.0f, 1.0f, 2.0f, 0.0f);
- p3=glm::vec4(3.0f, 1.0f, 1.0f, 0.0f);
- p4=glm::vec4(4.0f, 1.0f, 2.0f, 0.0f);
-
- p7=glm::vec4(7.0f, 1.0f, 3.0f, 0.0f);
- p6=glm::vec4(6.0f, 1.0f, 3.0f, 0.0f);
- p5=glm::vec4(5.0f, 1.0f, 3.0f, 0.0f);
-
- glm::vec4 c12, c23,c34, c123, c234, c;
-
- if(t<=TAO)
-   {
-    t=t/TAO;
-
-    c12=p1+t*(p2-p1);
-    c23=p2+t*(p3-p2);
-    c34=p3+t*(p4-p3);
-
-    c123=c12+t*(c23-c12);
-    c234=c23+t*(c34-c23);
-    c=c123+t*(c234-c123);
-   }
- else
-   {
-    t=(t-TAO)*2;
-
-    c12=p4+t*(p5-p4);
-    c23=p5+t*(p6-p5);
-    c34=p6+t*(p7-p6);
-
-    c123=c12+t*(c23-c12);
-    c234=c23+t*(c34-c23);
-    c=c123+t*(c234-c123);
-   }
 
- return(c);
+    // Copiamos a geometria também para g_SceneGeometry. Veja "scene.h".
+    SceneGeometry_Append(model_coefficients, texture_coefficients, indices, &pool_base_vertex, &pool_first_index);
 }
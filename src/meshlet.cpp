@@ -0,0 +1,202 @@
+// Construção de meshlets.
+//
+// Cada meshlet cresce a partir de um triângulo "semente", em largura, pelos
+// triângulos que compartilham vértices com os já incluídos, até atingir
+// MESHLET_MAX_TRIANGLES. Um triângulo só é incluído se a sua normal estiver
+// próxima da normal média do meshlet: assim os cones de normais ficam
+// estreitos e o descarte por cone (Culling_TestCones()) é efetivo. Meshlets
+// compactos também têm esferas envolventes pequenas, o que melhora o descarte
+// por frustum.
+#include <cmath>
+#include <deque>
+#include <algorithm>
+
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+
+#include "meshlet.h"
+
+// Número máximo de triângulos em um meshlet.
+#define MESHLET_MAX_TRIANGLES 128
+
+// Número mínimo de triângulos para que um nível de detalhe seja dividido.
+#define MESHLET_MIN_TRIANGLES 256
+
+// Cosseno do maior ângulo permitido entre a normal de um triângulo e a
+// normal média do meshlet.
+#define MESHLET_NORMAL_COS 0.5f
+
+static glm::vec3 Meshlet_Position(const std::vector<float>& model_coefficients, GLuint vertex)
+{
+    return glm::vec3(model_coefficients[4*vertex + 0], model_coefficients[4*vertex + 1], model_coefficients[4*vertex + 2]);
+}
+
+// Calcula a esfera envolvente e o cone de normais do meshlet formado pelos
+// "num_triangles" triângulos em "triangles", e o adiciona a g_SceneMeshlets.
+static void Meshlet_Add(const std::vector<float>& model_coefficients, const GLuint* triangles, size_t num_triangles,
+                        const std::vector<glm::vec3>& normals, const std::vector<GLuint>& triangle_ids,
+                        GLuint first_index)
+{
+    glm::vec3 bbox_min = Meshlet_Position(model_coefficients, triangles[0]);
+    glm::vec3 bbox_max = bbox_min;
+    for (size_t i = 0; i < 3 * num_triangles; ++i)
+    {
+        glm::vec3 p = Meshlet_Position(model_coefficients, triangles[i]);
+        bbox_min = glm::min(bbox_min, p);
+        bbox_max = glm::max(bbox_max, p);
+    }
+
+    glm::vec3 center = 0.5f * (bbox_min + bbox_max);
+    float radius2 = 0.0f;
+    for (size_t i = 0; i < 3 * num_triangles; ++i)
+    {
+        glm::vec3 d = Meshlet_Position(model_coefficients, triangles[i]) - center;
+        radius2 = std::max(radius2, glm::dot(d, d));
+    }
+
+    // Eixo do cone: média das normais. O semiângulo é dado pela normal mais
+    // afastada do eixo; se alguma normal faz mais de ~84 graus com o eixo, o
+    // cone é degenerado e o meshlet nunca é descartado por ele.
+    glm::vec3 axis(0.0f, 0.0f, 0.0f);
+    for (size_t t = 0; t < num_triangles; ++t)
+        axis += normals[triangle_ids[t]];
+
+    float cutoff = 1.0f;
+    float axis_length = glm::length(axis);
+    if (axis_length > 0.0f)
+    {
+        axis /= axis_length;
+
+        float min_dot = 1.0f;
+        for (size_t t = 0; t < num_triangles; ++t)
+            min_dot = std::min(min_dot, glm::dot(normals[triangle_ids[t]], axis));
+
+        if (min_dot > 0.1f)
+            cutoff = std::sqrt(1.0f - min_dot * min_dot);
+        else
+            axis = glm::vec3(0.0f, 0.0f, 0.0f);
+    }
+
+    SceneMeshlets& m = g_SceneMeshlets;
+    m.first_index.push_back(first_index);
+    m.num_indices.push_back((GLuint)(3 * num_triangles));
+    m.center_x.push_back(center.x);
+    m.center_y.push_back(center.y);
+    m.center_z.push_back(center.z);
+    m.radius.push_back(std::sqrt(radius2));
+    m.axis_x.push_back(axis.x);
+    m.axis_y.push_back(axis.y);
+    m.axis_z.push_back(axis.z);
+    m.cutoff.push_back(cutoff);
+}
+
+// Divide os "num_indices" índices a partir de indices[first_index] em
+// meshlets, reordenando os triângulos no próprio vetor.
+static void Meshlet_BuildRange(const std::vector<float>& model_coefficients, std::vector<GLuint>& indices,
+                               size_t first_index, size_t num_indices)
+{
+    size_t num_vertices  = model_coefficients.size() / 4;
+    size_t num_triangles = num_indices / 3;
+    const GLuint* tri = &indices[first_index];
+
+    // Normais (unitárias) dos triângulos. Triângulos degenerados têm normal
+    // nula e são aceitos em qualquer meshlet.
+    std::vector<glm::vec3> normals(num_triangles);
+    for (size_t t = 0; t < num_triangles; ++t)
+    {
+        glm::vec3 p0 = Meshlet_Position(model_coefficients, tri[3*t + 0]);
+        glm::vec3 p1 = Meshlet_Position(model_coefficients, tri[3*t + 1]);
+        glm::vec3 p2 = Meshlet_Position(model_coefficients, tri[3*t + 2]);
+        glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+        float length = glm::length(n);
+        normals[t] = length > 0.0f ? n / length : glm::vec3(0.0f, 0.0f, 0.0f);
+    }
+
+    // Triângulos de cada vértice, em formato compacto (veja "lod.cpp").
+    std::vector<GLuint> adjacency_offset(num_vertices + 1, 0);
+    for (size_t i = 0; i < num_indices; ++i)
+        adjacency_offset[tri[i] + 1] += 1;
+    for (size_t v = 0; v < num_vertices; ++v)
+        adjacency_offset[v + 1] += adjacency_offset[v];
+    std::vector<GLuint> adjacency(num_indices);
+    {
+        std::vector<GLuint> fill(adjacency_offset.begin(), adjacency_offset.end() - 1);
+        for (size_t i = 0; i < num_indices; ++i)
+            adjacency[fill[tri[i]]++] = (GLuint)(i / 3);
+    }
+
+    std::vector<unsigned char> assigned(num_triangles, 0);
+    std::vector<size_t>        visited(num_triangles, (size_t)-1); // Último meshlet que visitou o triângulo
+    std::vector<GLuint>        reordered;
+    std::vector<GLuint>        meshlet_triangles;
+    std::deque<GLuint>         queue;
+    reordered.reserve(num_indices);
+
+    size_t meshlet = 0;
+    for (size_t seed = 0; seed < num_triangles; ++seed)
+    {
+        if (assigned[seed])
+            continue;
+
+        meshlet_triangles.clear();
+        glm::vec3 normal_sum(0.0f, 0.0f, 0.0f);
+
+        queue.clear();
+        queue.push_back((GLuint)seed);
+        visited[seed] = meshlet;
+
+        while (!queue.empty() && meshlet_triangles.size() < MESHLET_MAX_TRIANGLES)
+        {
+            GLuint t = queue.front();
+            queue.pop_front();
+
+            float sum_length = glm::length(normal_sum);
+            if (sum_length > 0.0f && glm::dot(normals[t], normal_sum / sum_length) < MESHLET_NORMAL_COS && glm::length(normals[t]) > 0.0f)
+                continue;
+
+            assigned[t] = 1;
+            meshlet_triangles.push_back(t);
+            normal_sum += normals[t];
+
+            for (int k = 0; k < 3; ++k)
+            {
+                GLuint v = tri[3*t + k];
+                for (GLuint a = adjacency_offset[v]; a < adjacency_offset[v + 1]; ++a)
+                {
+                    GLuint neighbor = adjacency[a];
+                    if (!assigned[neighbor] && visited[neighbor] != meshlet)
+                    {
+                        visited[neighbor] = meshlet;
+                        queue.push_back(neighbor);
+                    }
+                }
+            }
+        }
+
+        size_t meshlet_first = reordered.size();
+        for (size_t i = 0; i < meshlet_triangles.size(); ++i)
+            for (int k = 0; k < 3; ++k)
+                reordered.push_back(tri[3*meshlet_triangles[i] + k]);
+
+        Meshlet_Add(model_coefficients, &reordered[meshlet_first], meshlet_triangles.size(),
+                    normals, meshlet_triangles, (GLuint)(first_index + meshlet_first));
+        ++meshlet;
+    }
+
+    std::copy(reordered.begin(), reordered.end(), indices.begin() + first_index);
+}
+
+void Meshlet_Build(SceneObject* object, const std::vector<float>& model_coefficients, std::vector<GLuint>& indices)
+{
+    for (unsigned int lod = 0; lod < object->num_lods; ++lod)
+    {
+        object->lod_first_meshlet[lod] = g_SceneMeshlets.first_index.size();
+        object->lod_num_meshlets[lod]  = 0;
+
+        if (object->rendering_mode != GL_TRIANGLES || object->lod_num_indices[lod] / 3 < MESHLET_MIN_TRIANGLES)
+            continue;
+
+        Meshlet_BuildRange(model_coefficients, indices, object->lod_first_index[lod], object->lod_num_indices[lod]);
+        object->lod_num_meshlets[lod] = g_SceneMeshlets.first_index.size() - object->lod_first_meshlet[lod];
+    }
+}
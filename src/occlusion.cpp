@@ -0,0 +1,356 @@
+// Descarte por oclusão em software.
+//
+// Os triângulos dos oclusores são transformados para coordenadas do buffer
+// de profundidade (pixels e profundidade em [0,1]), recortados contra o plano
+// near, e distribuídos ("binning") entre blocos de 32x32 pixels ("tiles")
+// conforme o retângulo que os envolve. Cada tile é então rasterizado por uma
+// thread (veja "thread_pool.h"), sem sincronização, pois nenhum pixel
+// pertence a dois tiles. A rasterização usa funções de aresta e o plano da
+// profundidade do triângulo, ambos lineares em coordenadas de tela, avaliados
+// com SSE para quatro pixels por vez; cada pixel guarda a MENOR profundidade
+// (o oclusor mais próximo).
+//
+// Ao final de cada tile calculamos, para cada bloco de 8x8 pixels, a menor e
+// a maior profundidade. O teste de um objeto projeta a sua caixa envolvente e
+// usa a profundidade do seu ponto mais próximo da câmera:
+//
+//   - se for menor que a menor profundidade do bloco, o objeto está à frente
+//     de tudo no bloco: visível;
+//   - se for maior que a maior profundidade do bloco, o bloco inteiro o
+//     esconde, e os seus pixels não precisam ser olhados;
+//   - senão, comparamos com cada pixel do bloco dentro do retângulo.
+//
+// Os oclusores cobrem somente os pixels cujo centro está dentro do triângulo,
+// e por isso podem cobrir pixels apenas parcialmente nas suas bordas. Para
+// que o teste continue conservador, o retângulo do objeto testado é
+// aumentado em um pixel em cada direção: se parte do objeto aparece por uma
+// borda de um oclusor, algum pixel vizinho não tem o centro coberto.
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OCCLUSION_USE_SSE
+#endif
+
+#include <glm/vec4.hpp>
+
+#include "occlusion.h"
+#include "thread_pool.h"
+
+// Tamanho dos tiles (unidade de trabalho de cada thread) e dos blocos da
+// hierarquia de profundidades. Ambos devem dividir a resolução do buffer, e
+// a largura dos tiles deve ser múltipla de 4 (pixels avaliados juntos com
+// SSE).
+#define OCCLUSION_TILE_SIZE  32
+#define OCCLUSION_BLOCK_SIZE 8
+
+#define OCCLUSION_TILES_X  (OCCLUSION_WIDTH  / OCCLUSION_TILE_SIZE)
+#define OCCLUSION_TILES_Y  (OCCLUSION_HEIGHT / OCCLUSION_TILE_SIZE)
+#define OCCLUSION_BLOCKS_X (OCCLUSION_WIDTH  / OCCLUSION_BLOCK_SIZE)
+#define OCCLUSION_BLOCKS_Y (OCCLUSION_HEIGHT / OCCLUSION_BLOCK_SIZE)
+
+// Tolerância na comparação de profundidades, para que um oclusor não esconda
+// a si mesmo devido a erros de arredondamento.
+#define OCCLUSION_DEPTH_EPSILON 1e-6f
+
+// Triângulo pronto para rasterização. As funções de aresta
+// E(x,y) = a*x + b*y + c são não negativas dentro do triângulo; a
+// profundidade é z(x,y) = z_a*x + z_b*y + z_c. O retângulo (inclusivo) é
+// limitado ao buffer.
+struct OcclusionTriangle
+{
+    float edge_a[3], edge_b[3], edge_c[3];
+    float z_a, z_b, z_c;
+    int   min_x, min_y, max_x, max_y;
+};
+
+static glm::mat4 g_OcclusionProjectionView;
+
+static std::vector<OcclusionTriangle> g_OcclusionTriangles;
+static std::vector<unsigned int>      g_OcclusionBins[OCCLUSION_TILES_X * OCCLUSION_TILES_Y];
+
+// Buffer de profundidade, linha 0 embaixo (como NDC), e hierarquia.
+static float g_OcclusionDepth[OCCLUSION_WIDTH * OCCLUSION_HEIGHT];
+static float g_OcclusionBlockMin[OCCLUSION_BLOCKS_X * OCCLUSION_BLOCKS_Y];
+static float g_OcclusionBlockMax[OCCLUSION_BLOCKS_X * OCCLUSION_BLOCKS_Y];
+
+// Se não há oclusores, o buffer não é rasterizado e tudo é visível.
+static bool g_OcclusionEmpty = true;
+
+void Occlusion_Begin(const glm::mat4& projection_view)
+{
+    g_OcclusionProjectionView = projection_view;
+    g_OcclusionTriangles.clear();
+    for (int i = 0; i < OCCLUSION_TILES_X * OCCLUSION_TILES_Y; ++i)
+        g_OcclusionBins[i].clear();
+    g_OcclusionEmpty = true;
+}
+
+// Converte um vértice recortado (w > 0) para coordenadas do buffer.
+static glm::vec3 Occlusion_ToScreen(const glm::vec4& clip)
+{
+    return glm::vec3((clip.x / clip.w * 0.5f + 0.5f) * OCCLUSION_WIDTH,
+                     (clip.y / clip.w * 0.5f + 0.5f) * OCCLUSION_HEIGHT,
+                      clip.z / clip.w * 0.5f + 0.5f);
+}
+
+// Prepara um triângulo em coordenadas do buffer e o coloca nos tiles que
+// ele cobre.
+static void Occlusion_SetupTriangle(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2)
+{
+    float area = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+    if (area == 0.0f)
+        return;
+
+    // As duas faces dos oclusores são rasterizadas (os modelos não têm uma
+    // orientação garantida); invertemos os triângulos no sentido horário.
+    if (area < 0.0f)
+    {
+        std::swap(p1, p2);
+        area = -area;
+    }
+
+    OcclusionTriangle t;
+    t.min_x = std::max((int)std::floor(std::min(p0.x, std::min(p1.x, p2.x))), 0);
+    t.min_y = std::max((int)std::floor(std::min(p0.y, std::min(p1.y, p2.y))), 0);
+    t.max_x = std::min((int)std::ceil (std::max(p0.x, std::max(p1.x, p2.x))), OCCLUSION_WIDTH  - 1);
+    t.max_y = std::min((int)std::ceil (std::max(p0.y, std::max(p1.y, p2.y))), OCCLUSION_HEIGHT - 1);
+    if (t.min_x > t.max_x || t.min_y > t.max_y)
+        return;
+
+    const glm::vec3* p[3] = { &p0, &p1, &p2 };
+    for (int k = 0; k < 3; ++k)
+    {
+        const glm::vec3& a = *p[k];
+        const glm::vec3& b = *p[(k + 1) % 3];
+        t.edge_a[k] = a.y - b.y;
+        t.edge_b[k] = b.x - a.x;
+        t.edge_c[k] = a.x * b.y - b.x * a.y;
+    }
+
+    t.z_a = ((p1.z - p0.z) * (p2.y - p0.y) - (p2.z - p0.z) * (p1.y - p0.y)) / area;
+    t.z_b = ((p2.z - p0.z) * (p1.x - p0.x) - (p1.z - p0.z) * (p2.x - p0.x)) / area;
+    t.z_c = p0.z - t.z_a * p0.x - t.z_b * p0.y;
+
+    unsigned int index = (unsigned int)g_OcclusionTriangles.size();
+    g_OcclusionTriangles.push_back(t);
+
+    for (int ty = t.min_y / OCCLUSION_TILE_SIZE; ty <= t.max_y / OCCLUSION_TILE_SIZE; ++ty)
+        for (int tx = t.min_x / OCCLUSION_TILE_SIZE; tx <= t.max_x / OCCLUSION_TILE_SIZE; ++tx)
+            g_OcclusionBins[ty * OCCLUSION_TILES_X + tx].push_back(index);
+}
+
+void Occlusion_AddOccluder(const SceneObject& object, const glm::mat4& model)
+{
+    if (object.rendering_mode != GL_TRIANGLES)
+        return;
+
+    if (object.pool_base_vertex >= 0)
+    {
+        const GLuint* indices = &g_SceneGeometry.indices[object.pool_first_index + (object.lod_first_index[0] - object.first_index)];
+        Occlusion_AddTriangles(g_SceneGeometry.model_coefficients.data(), indices, object.lod_num_indices[0], object.pool_base_vertex, model);
+    }
+    else if (object.cpu_positions != NULL)
+    {
+        Occlusion_AddTriangles(object.cpu_positions, object.cpu_indices + object.lod_first_index[0], object.lod_num_indices[0], 0, model);
+    }
+}
+
+void Occlusion_AddTriangles(const float* positions, const GLuint* indices, size_t num_indices, GLint base_vertex, const glm::mat4& model)
+{
+    glm::mat4 M = g_OcclusionProjectionView * model;
+
+    for (size_t i = 0; i + 2 < num_indices; i += 3)
+    {
+        glm::vec4 clip[3];
+        for (int k = 0; k < 3; ++k)
+        {
+            size_t v = 4 * (size_t)(base_vertex + (GLint)indices[i + k]);
+            clip[k] = M * glm::vec4(positions[v + 0], positions[v + 1], positions[v + 2], 1.0f);
+        }
+
+        // Descarte trivial: os três vértices fora do mesmo plano do frustum
+        // (exceto o near, tratado pelo recorte abaixo).
+        bool outside = false;
+        for (int axis = 0; axis < 3 && !outside; ++axis)
+        {
+            outside = outside || (clip[0][axis] >  clip[0].w && clip[1][axis] >  clip[1].w && clip[2][axis] >  clip[2].w);
+            outside = outside || (axis < 2 && clip[0][axis] < -clip[0].w && clip[1][axis] < -clip[1].w && clip[2][axis] < -clip[2].w);
+        }
+        if (outside)
+            continue;
+
+        // Recorte (Sutherland-Hodgman) contra o plano near, z >= -w: um
+        // triângulo vira até dois.
+        glm::vec4 polygon[4];
+        int num_vertices = 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            const glm::vec4& a = clip[k];
+            const glm::vec4& b = clip[(k + 1) % 3];
+            float da = a.z + a.w;
+            float db = b.z + b.w;
+            if (da >= 0.0f)
+                polygon[num_vertices++] = a;
+            if ((da >= 0.0f) != (db >= 0.0f))
+                polygon[num_vertices++] = a + (b - a) * (da / (da - db));
+        }
+        if (num_vertices < 3)
+            continue;
+
+        glm::vec3 p0 = Occlusion_ToScreen(polygon[0]);
+        for (int k = 1; k + 1 < num_vertices; ++k)
+            Occlusion_SetupTriangle(p0, Occlusion_ToScreen(polygon[k]), Occlusion_ToScreen(polygon[k + 1]));
+    }
+
+    g_OcclusionEmpty = g_OcclusionTriangles.empty();
+}
+
+// Rasteriza o tile "tile" e calcula a hierarquia dos seus blocos.
+static void Occlusion_RasterizeTile(size_t tile)
+{
+    int tile_x0 = (int)(tile % OCCLUSION_TILES_X) * OCCLUSION_TILE_SIZE;
+    int tile_y0 = (int)(tile / OCCLUSION_TILES_X) * OCCLUSION_TILE_SIZE;
+
+    for (int y = tile_y0; y < tile_y0 + OCCLUSION_TILE_SIZE; ++y)
+        std::fill(&g_OcclusionDepth[y * OCCLUSION_WIDTH + tile_x0],
+                  &g_OcclusionDepth[y * OCCLUSION_WIDTH + tile_x0 + OCCLUSION_TILE_SIZE], 1.0f);
+
+    const std::vector<unsigned int>& bin = g_OcclusionBins[tile];
+    for (size_t i = 0; i < bin.size(); ++i)
+    {
+        const OcclusionTriangle& t = g_OcclusionTriangles[bin[i]];
+
+        // Retângulo do triângulo dentro do tile, com x alinhado a 4 pixels.
+        int x0 = std::max(t.min_x, tile_x0) & ~3;
+        int x1 = std::min(t.max_x, tile_x0 + OCCLUSION_TILE_SIZE - 1);
+        int y0 = std::max(t.min_y, tile_y0);
+        int y1 = std::min(t.max_y, tile_y0 + OCCLUSION_TILE_SIZE - 1);
+
+        for (int y = y0; y <= y1; ++y)
+        {
+            // Avaliamos tudo nos centros dos pixels.
+            float py = (float)y + 0.5f;
+            float* row = &g_OcclusionDepth[y * OCCLUSION_WIDTH];
+
+#ifdef OCCLUSION_USE_SSE
+            __m128 step = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+            __m128 a0 = _mm_set1_ps(t.edge_a[0]), c0 = _mm_set1_ps(t.edge_b[0] * py + t.edge_c[0]);
+            __m128 a1 = _mm_set1_ps(t.edge_a[1]), c1 = _mm_set1_ps(t.edge_b[1] * py + t.edge_c[1]);
+            __m128 a2 = _mm_set1_ps(t.edge_a[2]), c2 = _mm_set1_ps(t.edge_b[2] * py + t.edge_c[2]);
+            __m128 za = _mm_set1_ps(t.z_a),       zc = _mm_set1_ps(t.z_b * py + t.z_c);
+            __m128 zero = _mm_setzero_ps();
+
+            for (int x = x0; x <= x1; x += 4)
+            {
+                __m128 px = _mm_add_ps(_mm_set1_ps((float)x + 0.5f), step);
+
+                __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), c0), zero);
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), c1), zero));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), c2), zero));
+                if (_mm_movemask_ps(inside) == 0)
+                    continue;
+
+                __m128 z     = _mm_add_ps(_mm_mul_ps(za, px), zc);
+                __m128 depth = _mm_loadu_ps(&row[x]);
+                __m128 nearest = _mm_min_ps(depth, z);
+                _mm_storeu_ps(&row[x], _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, depth)));
+            }
+#else
+            for (int x = x0; x <= x1; ++x)
+            {
+                float px = (float)x + 0.5f;
+                if (t.edge_a[0] * px + t.edge_b[0] * py + t.edge_c[0] < 0.0f ||
+                    t.edge_a[1] * px + t.edge_b[1] * py + t.edge_c[1] < 0.0f ||
+                    t.edge_a[2] * px + t.edge_b[2] * py + t.edge_c[2] < 0.0f)
+                    continue;
+                row[x] = std::min(row[x], t.z_a * px + t.z_b * py + t.z_c);
+            }
+#endif
+        }
+    }
+
+    // Hierarquia: menor e maior profundidade de cada bloco do tile.
+    for (int by = tile_y0 / OCCLUSION_BLOCK_SIZE; by < (tile_y0 + OCCLUSION_TILE_SIZE) / OCCLUSION_BLOCK_SIZE; ++by)
+        for (int bx = tile_x0 / OCCLUSION_BLOCK_SIZE; bx < (tile_x0 + OCCLUSION_TILE_SIZE) / OCCLUSION_BLOCK_SIZE; ++bx)
+        {
+            float min_depth = 1.0f;
+            float max_depth = 0.0f;
+            for (int y = by * OCCLUSION_BLOCK_SIZE; y < (by + 1) * OCCLUSION_BLOCK_SIZE; ++y)
+                for (int x = bx * OCCLUSION_BLOCK_SIZE; x < (bx + 1) * OCCLUSION_BLOCK_SIZE; ++x)
+                {
+                    min_depth = std::min(min_depth, g_OcclusionDepth[y * OCCLUSION_WIDTH + x]);
+                    max_depth = std::max(max_depth, g_OcclusionDepth[y * OCCLUSION_WIDTH + x]);
+                }
+            g_OcclusionBlockMin[by * OCCLUSION_BLOCKS_X + bx] = min_depth;
+            g_OcclusionBlockMax[by * OCCLUSION_BLOCKS_X + bx] = max_depth;
+        }
+}
+
+void Occlusion_Rasterize()
+{
+    if (g_OcclusionEmpty)
+        return;
+
+    ThreadPool_ParallelFor(OCCLUSION_TILES_X * OCCLUSION_TILES_Y, Occlusion_RasterizeTile);
+}
+
+bool Occlusion_TestBox(const glm::vec3& bbox_min, const glm::vec3& bbox_max, const glm::mat4& model)
+{
+    if (g_OcclusionEmpty)
+        return true;
+
+    glm::mat4 M = g_OcclusionProjectionView * model;
+
+    float min_x =  1e30f, min_y =  1e30f, min_z = 1e30f;
+    float max_x = -1e30f, max_y = -1e30f;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        glm::vec4 p((corner & 1) ? bbox_max.x : bbox_min.x,
+                    (corner & 2) ? bbox_max.y : bbox_min.y,
+                    (corner & 4) ? bbox_max.z : bbox_min.z, 1.0f);
+        glm::vec4 clip = M * p;
+
+        // Caixa cruzando o plano near: a câmera pode estar dentro dela.
+        if (clip.w <= 0.0f || clip.z < -clip.w)
+            return true;
+
+        glm::vec3 s = Occlusion_ToScreen(clip);
+        min_x = std::min(min_x, s.x); max_x = std::max(max_x, s.x);
+        min_y = std::min(min_y, s.y); max_y = std::max(max_y, s.y);
+        min_z = std::min(min_z, s.z);
+    }
+
+    // Retângulo aumentado em um pixel (veja o início do arquivo). Fora do
+    // buffer, o objeto foi mantido pelo descarte por frustum: deixamos a GPU
+    // decidir.
+    int x0 = std::max((int)std::floor(min_x) - 1, 0);
+    int y0 = std::max((int)std::floor(min_y) - 1, 0);
+    int x1 = std::min((int)std::floor(max_x) + 1, OCCLUSION_WIDTH  - 1);
+    int y1 = std::min((int)std::floor(max_y) + 1, OCCLUSION_HEIGHT - 1);
+    if (x0 > x1 || y0 > y1)
+        return true;
+
+    float depth = min_z - OCCLUSION_DEPTH_EPSILON;
+
+    for (int by = y0 / OCCLUSION_BLOCK_SIZE; by <= y1 / OCCLUSION_BLOCK_SIZE; ++by)
+        for (int bx = x0 / OCCLUSION_BLOCK_SIZE; bx <= x1 / OCCLUSION_BLOCK_SIZE; ++bx)
+        {
+            int block = by * OCCLUSION_BLOCKS_X + bx;
+            if (depth <= g_OcclusionBlockMin[block])
+                return true;
+            if (depth > g_OcclusionBlockMax[block])
+                continue;
+
+            int px0 = std::max(x0, bx * OCCLUSION_BLOCK_SIZE), px1 = std::min(x1, (bx + 1) * OCCLUSION_BLOCK_SIZE - 1);
+            int py0 = std::max(y0, by * OCCLUSION_BLOCK_SIZE), py1 = std::min(y1, (by + 1) * OCCLUSION_BLOCK_SIZE - 1);
+            for (int y = py0; y <= py1; ++y)
+                for (int x = px0; x <= px1; ++x)
+                    if (depth <= g_OcclusionDepth[y * OCCLUSION_WIDTH + x])
+                        return true;
+        }
+
+    return false;
+}
@@ -0,0 +1,89 @@
+// Transparência independente de ordem.
+//
+// Para as superfícies transparentes de um pixel, com cores C_i, opacidades
+// a_i e pesos w_i (que decrescem com a distância até a câmera), a
+// acumulação calcula
+//
+//     soma = Σ C_i * a_i * w_i,   peso = Σ a_i * w_i,   fundo = Π (1 - a_i)
+//
+// e a composição aproxima a mistura, na ordem correta, por
+//
+//     cor = soma / peso * (1 - fundo) + cor_opaca * fundo
+//
+// "fundo" é exato em qualquer ordem; a média ponderada é a aproximação, e é
+// exata para uma única superfície. As somas usam glBlendFunc(GL_ONE, GL_ONE)
+// e o produto usa glBlendFunc(GL_ZERO, GL_ONE_MINUS_SRC_ALPHA). Como OpenGL
+// 3.3 não permite um blending diferente para cada textura do framebuffer
+// (glBlendFunci() é do OpenGL 4.0), "fundo" fica no canal alfa da textura de
+// soma, e os canais de cor de todas as texturas usam o mesmo blending
+// aditivo: glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA).
+#include <glad/glad.h>
+
+#include "gl_debug.h"
+#include "gl_state.h"
+#include "oit.h"
+
+// Funções definidas em main.cpp
+GLuint LoadShader_Vertex(const char* filename);
+GLuint LoadShader_Fragment(const char* filename);
+GLuint CreateGpuProgram(GLuint vertex_shader_id, GLuint fragment_shader_id);
+
+static GLuint g_OitCompositeProgramId = 0;
+static GLuint g_OitCompositeVAO = 0; // Vazio: o triângulo vem de gl_VertexID
+
+void Oit_Init()
+{
+    GLuint vertex_shader_id   = LoadShader_Vertex("../src/shader_vertex_oit_composite.glsl");
+    GLuint fragment_shader_id = LoadShader_Fragment("../src/shader_fragment_oit_composite.glsl");
+    g_OitCompositeProgramId   = CreateGpuProgram(vertex_shader_id, fragment_shader_id);
+    GLDebug_Label(GL_PROGRAM, g_OitCompositeProgramId, "oit composite");
+
+    glUseProgram(g_OitCompositeProgramId);
+    glUniform1i(glGetUniformLocation(g_OitCompositeProgramId, "gAccumSampler"), 0);
+    glUniform1i(glGetUniformLocation(g_OitCompositeProgramId, "gWeightSampler"), 1);
+    glUseProgram(0);
+
+    glGenVertexArrays(1, &g_OitCompositeVAO);
+}
+
+void Oit_BeginAccumulation()
+{
+    // Soma das cores zero e fundo inteiramente visível; soma dos pesos zero.
+    const GLfloat accum_clear[4]  = { 0.0f, 0.0f, 0.0f, 1.0f };
+    const GLfloat weight_clear[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    glClearBufferfv(GL_COLOR, 0, accum_clear);
+    glClearBufferfv(GL_COLOR, 1, weight_clear);
+
+    glDepthMask(GL_FALSE);
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void Oit_EndAccumulation()
+{
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+}
+
+void Oit_Composite(GLuint accum_texture, GLuint weight_texture)
+{
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, accum_texture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, weight_texture);
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glUseProgram(g_OitCompositeProgramId);
+    glBindVertexArray(g_OitCompositeVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    glEnable(GL_DEPTH_TEST);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
@@ -0,0 +1,362 @@
+// Caminhos.
+//
+// A tabela é montada em duas etapas. Primeiro, cada curva é amostrada em
+// PATH_SAMPLES_PER_SEGMENT intervalos iguais do parâmetro, e o comprimento
+// de arco até cada amostra é aproximado pela soma das cordas. Depois, para
+// cada distância i * step, encontramos o intervalo de amostras que a
+// contém, interpolamos o parâmetro linearmente dentro dele e avaliamos a
+// curva exata nesse parâmetro. Como as amostras são densas, o erro da
+// velocidade fica bem abaixo do que se percebe na tela.
+//
+// As curvas são avaliadas pelo algoritmo de de Casteljau, com as mesmas
+// operações da antiga FindPoint().
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PATH_USE_SSE
+#endif
+
+#include <glm/geometric.hpp>
+
+#include "path.h"
+
+// Caminho do jogo. Veja Path_LoadDefault().
+static const glm::vec3 g_PathDefaultPoints[] =
+{
+    glm::vec3(1.0f, 1.0f, 3.0f), glm::vec3(2.0f, 1.0f, 2.0f), glm::vec3(3.0f, 1.0f, 1.0f),
+    glm::vec3(4.0f, 1.0f, 2.0f),
+    glm::vec3(5.0f, 1.0f, 3.0f), glm::vec3(6.0f, 1.0f, 3.0f), glm::vec3(7.0f, 1.0f, 3.0f),
+};
+static const float g_PathDefaultKnots[] = { 0.0f, 0.7f, 1.2f };
+
+// Ponto da curva "segment" no parâmetro local t, entre 0 e 1.
+static glm::vec3 Path_EvaluateSegment(const Path* path, int segment, float t)
+{
+    const glm::vec3* p = &path->points[3 * segment];
+
+    glm::vec3 c12 = p[0] + t * (p[1] - p[0]);
+    glm::vec3 c23 = p[1] + t * (p[2] - p[1]);
+    glm::vec3 c34 = p[2] + t * (p[3] - p[2]);
+
+    glm::vec3 c123 = c12 + t * (c23 - c12);
+    glm::vec3 c234 = c23 + t * (c34 - c23);
+    return c123 + t * (c234 - c123);
+}
+
+// Mede o caminho e monta a tabela de posições. Veja o início do arquivo.
+static void Path_BuildTable(Path* path)
+{
+    const int samples = path->num_segments * PATH_SAMPLES_PER_SEGMENT;
+
+    std::vector<float>& arc = path->arc;
+    arc.resize(samples + 1);
+    arc[0] = 0.0f;
+    glm::vec3 previous = path->points[0];
+    for (int i = 1; i <= samples; ++i)
+    {
+        glm::vec3 point = Path_EvaluateSegment(path, (i - 1) / PATH_SAMPLES_PER_SEGMENT,
+                                               (float)((i - 1) % PATH_SAMPLES_PER_SEGMENT + 1) / PATH_SAMPLES_PER_SEGMENT);
+        arc[i] = arc[i - 1] + glm::length(point - previous);
+        previous = point;
+    }
+
+    path->length = arc[samples];
+    path->step = path->length / samples;
+    path->inverse_step = path->length > 0.0f ? samples / path->length : 0.0f;
+    path->table_x.resize(samples + 1);
+    path->table_y.resize(samples + 1);
+    path->table_z.resize(samples + 1);
+
+    int k = 0; // Intervalo [arc[k], arc[k + 1]] de amostras que contém a distância
+    for (int i = 0; i <= samples; ++i)
+    {
+        float distance = i * path->step;
+        while (k < samples - 1 && arc[k + 1] < distance)
+            ++k;
+
+        float interval = arc[k + 1] - arc[k];
+        float fraction = interval > 0.0f ? std::min(std::max((distance - arc[k]) / interval, 0.0f), 1.0f) : 0.0f;
+        glm::vec3 point = i == samples ? path->points.back()
+                                       : Path_EvaluateSegment(path, k / PATH_SAMPLES_PER_SEGMENT,
+                                                              (k % PATH_SAMPLES_PER_SEGMENT + fraction) / PATH_SAMPLES_PER_SEGMENT);
+        path->table_x[i] = point.x;
+        path->table_y[i] = point.y;
+        path->table_z[i] = point.z;
+    }
+}
+
+void Path_InitBezier(Path* path, const glm::vec3* points, int num_points, const float* knots)
+{
+    path->num_segments = std::max((num_points - 1) / 3, 1);
+    path->points.assign(points, points + std::min(num_points, 3 * path->num_segments + 1));
+    path->points.resize(3 * path->num_segments + 1, path->points.empty() ? glm::vec3(0.0f) : path->points.back());
+    path->closed = false;
+
+    path->knots.resize(path->num_segments + 1);
+    for (int k = 0; k <= path->num_segments; ++k)
+        path->knots[k] = knots != NULL ? knots[k] : (float)k;
+
+    Path_BuildTable(path);
+}
+
+void Path_InitCatmullRom(Path* path, const glm::vec3* points, int num_points, bool closed)
+{
+    // Com um ponto só (ou nenhum), o caminho fica parado nele.
+    if (num_points < 2)
+    {
+        Path_InitBezier(path, points, num_points, NULL);
+        return;
+    }
+
+    int n = num_points;
+    int num_segments = closed ? n : n - 1;
+
+    // Pontos fora do caminho aberto repetem as pontas.
+    std::vector<glm::vec3> controls;
+    for (int k = 0; k < num_segments; ++k)
+    {
+        const glm::vec3& p0 = points[closed ? (k + n - 1) % n : std::max(k - 1, 0)];
+        const glm::vec3& p1 = points[k];
+        const glm::vec3& p2 = points[closed ? (k + 1) % n : std::min(k + 1, n - 1)];
+        const glm::vec3& p3 = points[closed ? (k + 2) % n : std::min(k + 2, n - 1)];
+
+        if (k == 0)
+            controls.push_back(p1);
+        controls.push_back(p1 + (p2 - p0) / 6.0f);
+        controls.push_back(p2 - (p3 - p1) / 6.0f);
+        controls.push_back(p2);
+    }
+
+    Path_InitBezier(path, controls.data(), (int)controls.size(), NULL);
+    path->closed = closed;
+}
+
+void Path_LoadDefault(Path* path)
+{
+    Path_InitBezier(path, g_PathDefaultPoints, (int)(sizeof(g_PathDefaultPoints) / sizeof(g_PathDefaultPoints[0])), g_PathDefaultKnots);
+}
+
+// Curva que contém o parâmetro "u" e o parâmetro local "t" nela, entre 0 e
+// 1. Retorna o índice da curva.
+static int Path_FindParameter(const Path* path, float u, float* t)
+{
+    // Primeira curva que termina em u ou depois.
+    int segment = (int)(std::lower_bound(path->knots.begin() + 1, path->knots.end() - 1, u) - (path->knots.begin() + 1));
+    float begin = path->knots[segment];
+    float end = path->knots[segment + 1];
+    *t = std::min(std::max((u - begin) / (end - begin), 0.0f), 1.0f);
+    return segment;
+}
+
+glm::vec3 Path_EvaluateParameter(const Path* path, float u)
+{
+    float t;
+    int segment = Path_FindParameter(path, u, &t);
+    return Path_EvaluateSegment(path, segment, t);
+}
+
+float Path_ParameterDistance(const Path* path, float u)
+{
+    float t;
+    int segment = Path_FindParameter(path, u, &t);
+    float f = (segment + t) * PATH_SAMPLES_PER_SEGMENT;
+    int i = std::min((int)f, (int)path->arc.size() - 2);
+    return path->arc[i] + (f - i) * (path->arc[i + 1] - path->arc[i]);
+}
+
+glm::vec3 Path_Evaluate(const Path* path, float distance)
+{
+    int last = (int)path->table_x.size() - 1;
+    float f = std::min(std::max(distance * path->inverse_step, 0.0f), (float)last);
+    int i = std::min((int)f, last - 1);
+    float fraction = f - i;
+
+    return glm::vec3(path->table_x[i] + fraction * (path->table_x[i + 1] - path->table_x[i]),
+                     path->table_y[i] + fraction * (path->table_y[i + 1] - path->table_y[i]),
+                     path->table_z[i] + fraction * (path->table_z[i + 1] - path->table_z[i]));
+}
+
+void Path_EvaluateMany(const Path* paths, const int* path_index, const float* distance, size_t count,
+                       float* x, float* y, float* z)
+{
+    size_t i = 0;
+
+#ifdef PATH_USE_SSE
+    // Quatro pontos por iteração, com as mesmas operações de
+    // Path_Evaluate(). As constantes dos caminhos e as entradas das tabelas
+    // são lidas uma a uma (SSE2 não tem leituras indexadas), mas a parte
+    // aritmética não tem desvios.
+    const __m128 zero4 = _mm_setzero_ps();
+    const __m128 one4 = _mm_set1_ps(1.0f);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const Path* lane[4];
+        float inverse_step[4], last[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            lane[k] = &paths[path_index != NULL ? path_index[i + k] : 0];
+            inverse_step[k] = lane[k]->inverse_step;
+            last[k] = (float)(lane[k]->table_x.size() - 1);
+        }
+        __m128 last4 = _mm_loadu_ps(last);
+
+        __m128 f = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(distance + i), _mm_loadu_ps(inverse_step)), zero4), last4);
+        __m128 whole = _mm_min_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(f)), _mm_sub_ps(last4, one4));
+        __m128 fraction = _mm_sub_ps(f, whole);
+
+        int index[4];
+        _mm_storeu_si128((__m128i*)index, _mm_cvttps_epi32(whole));
+
+        float x0[4], x1[4], y0[4], y1[4], z0[4], z1[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            x0[k] = lane[k]->table_x[index[k]];
+            x1[k] = lane[k]->table_x[index[k] + 1];
+            y0[k] = lane[k]->table_y[index[k]];
+            y1[k] = lane[k]->table_y[index[k] + 1];
+            z0[k] = lane[k]->table_z[index[k]];
+            z1[k] = lane[k]->table_z[index[k] + 1];
+        }
+
+        __m128 a = _mm_loadu_ps(x0);
+        _mm_storeu_ps(x + i, _mm_add_ps(a, _mm_mul_ps(fraction, _mm_sub_ps(_mm_loadu_ps(x1), a))));
+        a = _mm_loadu_ps(y0);
+        _mm_storeu_ps(y + i, _mm_add_ps(a, _mm_mul_ps(fraction, _mm_sub_ps(_mm_loadu_ps(y1), a))));
+        a = _mm_loadu_ps(z0);
+        _mm_storeu_ps(z + i, _mm_add_ps(a, _mm_mul_ps(fraction, _mm_sub_ps(_mm_loadu_ps(z1), a))));
+    }
+#endif
+
+    // Pontos restantes (ou todos, sem SSE).
+    for (; i < count; ++i)
+    {
+        glm::vec3 point = Path_Evaluate(&paths[path_index != NULL ? path_index[i] : 0], distance[i]);
+        x[i] = point.x;
+        y[i] = point.y;
+        z[i] = point.z;
+    }
+}
+
+// Path_Wrap(), e em "*reflected" se a distância foi refletida (está na
+// volta de um caminho aberto).
+static float Path_WrapReflect(const Path* path, float distance, bool* reflected)
+{
+    float period = path->closed ? path->length : 2.0f * path->length;
+    float inverse_period = period > 0.0f ? 1.0f / period : 0.0f;
+    float d = distance - period * std::floor(distance * inverse_period);
+    *reflected = !path->closed && d > path->length;
+    return *reflected ? period - d : d;
+}
+
+#ifdef PATH_USE_SSE
+// Path_WrapReflect() de quatro distâncias, com as mesmas operações, dados o
+// período, o seu inverso e o comprimento de cada caminho. "open" tem todos
+// os bits ligados nos caminhos abertos, e "*reflected", nas distâncias
+// refletidas.
+static __m128 Path_Wrap4(__m128 d, __m128 period, __m128 inverse_period, __m128 length, __m128 open, __m128* reflected)
+{
+    // d - period * floor(d / period). A conversão trunca em direção ao
+    // zero: para negativos, subtraímos 1.
+    __m128 q = _mm_mul_ps(d, inverse_period);
+    __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(q));
+    __m128 floor = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, q), _mm_set1_ps(1.0f)));
+    d = _mm_sub_ps(d, _mm_mul_ps(period, floor));
+
+    *reflected = _mm_and_ps(open, _mm_cmpgt_ps(d, length));
+    return _mm_or_ps(_mm_and_ps(*reflected, _mm_sub_ps(period, d)), _mm_andnot_ps(*reflected, d));
+}
+#endif
+
+float Path_Wrap(const Path* path, float distance)
+{
+    bool reflected;
+    return Path_WrapReflect(path, distance, &reflected);
+}
+
+void Path_WrapMany(const Path* paths, const int* path_index, float* distance, size_t count)
+{
+    size_t i = 0;
+
+#ifdef PATH_USE_SSE
+    // Quatro distâncias por iteração, com as constantes de cada caminho
+    // lidas uma a uma, como em Path_EvaluateMany().
+    for (; i + 4 <= count; i += 4)
+    {
+        float period[4], inverse_period[4], length[4];
+        int open[4];
+        for (int k = 0; k < 4; ++k)
+        {
+            const Path* path = &paths[path_index != NULL ? path_index[i + k] : 0];
+            period[k] = path->closed ? path->length : 2.0f * path->length;
+            inverse_period[k] = period[k] > 0.0f ? 1.0f / period[k] : 0.0f;
+            length[k] = path->length;
+            open[k] = path->closed ? 0 : -1;
+        }
+
+        __m128 reflected;
+        __m128 d = Path_Wrap4(_mm_loadu_ps(distance + i), _mm_loadu_ps(period), _mm_loadu_ps(inverse_period),
+                              _mm_loadu_ps(length), _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)open)), &reflected);
+        _mm_storeu_ps(distance + i, d);
+    }
+#endif
+
+    // Distâncias restantes (ou todas, sem SSE).
+    for (; i < count; ++i)
+        distance[i] = Path_Wrap(&paths[path_index != NULL ? path_index[i] : 0], distance[i]);
+}
+
+size_t PathFollowers_Add(PathFollowers* followers, float distance, float speed)
+{
+    followers->distance.push_back(distance);
+    followers->speed.push_back(speed);
+    followers->x.push_back(0.0f);
+    followers->y.push_back(0.0f);
+    followers->z.push_back(0.0f);
+    return followers->distance.size() - 1;
+}
+
+void PathFollowers_Advance(const Path* path, PathFollowers* followers, float dt)
+{
+    size_t count = followers->distance.size();
+    float* distance = followers->distance.data();
+    float* speed = followers->speed.data();
+    size_t i = 0;
+
+    // A distância andada é levada para dentro do caminho por Path_Wrap();
+    // quem cai na volta de um caminho aberto anda para o outro lado. Assim,
+    // passos de qualquer tamanho dão o mesmo que passos pequenos.
+#ifdef PATH_USE_SSE
+    // Quatro seguidores por iteração, sem desvios nas pontas.
+    const float period = path->closed ? path->length : 2.0f * path->length;
+    const __m128 dt4 = _mm_set1_ps(dt);
+    const __m128 period4 = _mm_set1_ps(period);
+    const __m128 inverse_period4 = _mm_set1_ps(period > 0.0f ? 1.0f / period : 0.0f);
+    const __m128 length4 = _mm_set1_ps(path->length);
+    const __m128 open4 = path->closed ? _mm_setzero_ps() : _mm_castsi128_ps(_mm_set1_epi32(-1));
+    const __m128 sign4 = _mm_set1_ps(-0.0f);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v = _mm_loadu_ps(speed + i);
+        __m128 reflected;
+        __m128 d = Path_Wrap4(_mm_add_ps(_mm_loadu_ps(distance + i), _mm_mul_ps(v, dt4)),
+                              period4, inverse_period4, length4, open4, &reflected);
+        _mm_storeu_ps(distance + i, d);
+        _mm_storeu_ps(speed + i, _mm_xor_ps(v, _mm_and_ps(reflected, sign4)));
+    }
+#endif
+
+    // Seguidores restantes (ou todos, sem SSE).
+    for (; i < count; ++i)
+    {
+        bool reflected;
+        distance[i] = Path_WrapReflect(path, distance[i] + speed[i] * dt, &reflected);
+        if (reflected)
+            speed[i] = -speed[i];
+    }
+
+    Path_EvaluateMany(path, NULL, distance, count, followers->x.data(), followers->y.data(), followers->z.data());
+}
@@ -0,0 +1,669 @@
+// Grafo de renderização.
+//
+// RenderGraph_Execute() trabalha em quatro etapas:
+//
+// 1. Descarte: um passo é necessário se escreve a janela, ou se escreve um
+//    recurso lido por um passo necessário. Os demais não são executados, e as
+//    texturas que só eles usam nem chegam a ser alocadas.
+//
+// 2. Ordem: um passo que lê um recurso vem depois dos passos declarados
+//    antes dele que o escrevem (ou, se não há nenhum, de todos os que o
+//    escrevem), e antes dos declarados depois dele que o escrevem, para que
+//    a versão lida não seja sobrescrita antes da leitura. Passos que
+//    escrevem o mesmo recurso mantêm a ordem de declaração. Entre os passos
+//    prontos, o declarado primeiro é executado primeiro, logo um grafo já
+//    declarado em ordem não é reordenado.
+//
+// 3. Tempo de vida: cada textura temporária vive do primeiro ao último passo
+//    (na ordem de execução) que a usa. Antes do primeiro, uma textura livre
+//    do conjunto, com o mesmo formato e tamanho, é atribuída a ela; depois do
+//    último, a textura volta a ficar livre e pode ser atribuída a outro
+//    recurso no mesmo quadro. OpenGL não permite que duas texturas
+//    compartilhem memória diretamente, então é assim que o grafo reaproveita
+//    (faz "aliasing" da) memória de vídeo. Texturas do conjunto que ficam
+//    RENDER_GRAPH_MAX_IDLE_FRAMES quadros sem uso (por exemplo, as do tamanho
+//    antigo após redimensionar a janela) são liberadas, de forma que a
+//    memória usada é limitada pelo maior conjunto de texturas vivas ao mesmo
+//    tempo.
+//
+// 4. Execução: os framebuffers de cada combinação de texturas escritas são
+//    criados uma única vez e reutilizados. O tempo de GPU de cada passo é
+//    medido com marcas de tempo (glQueryCounter(), OpenGL 3.3), que, ao
+//    contrário de consultas GL_TIME_ELAPSED, podem ser usadas dentro de
+//    outras medições (veja "dynamic_resolution.cpp"). Como lá, um anel de
+//    consultas evita esperar pela GPU.
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "gl_debug.h"
+#include "gl_state.h"
+#include "render_graph.h"
+
+// Maior número de passos por quadro medidos.
+#define RENDER_GRAPH_MAX_PASSES 32
+
+// Número de quadros com medições em voo.
+#define RENDER_GRAPH_QUERY_FRAMES 4
+
+// Quadros sem uso até uma textura do conjunto ser liberada.
+#define RENDER_GRAPH_MAX_IDLE_FRAMES 8
+
+// Texturas de cor por passo.
+#define RENDER_GRAPH_MAX_COLOR 4
+
+struct RenderGraphResourceData
+{
+    const char*       name;
+    bool              backbuffer;
+    RenderGraphFormat format;
+    int               width;
+    int               height;
+    int               first; // Primeiro e último passo (na ordem de execução) que o usam
+    int               last;
+    int               pool_index; // Textura do conjunto atribuída, ou -1
+};
+
+struct RenderGraphPassData
+{
+    const char*              name;
+    std::function<void()>    execute;
+    std::vector<RenderGraphResource> reads;
+    std::vector<RenderGraphResource> writes;
+    bool                     needed;
+    bool                     done; // Já ordenado
+};
+
+struct RenderGraphPoolTexture
+{
+    GLuint            texture;
+    RenderGraphFormat format;
+    int               width;
+    int               height;
+    bool              in_use;
+    unsigned long     last_frame; // Último quadro em que foi usada
+};
+
+struct RenderGraphFramebuffer
+{
+    GLuint framebuffer;
+    GLuint color[RENDER_GRAPH_MAX_COLOR];
+    int    num_color;
+    GLuint depth;
+};
+
+// Medições de um quadro.
+struct RenderGraphQueryFrame
+{
+    GLuint      queries[2 * RENDER_GRAPH_MAX_PASSES]; // Início e fim de cada passo
+    const char* names[RENDER_GRAPH_MAX_PASSES];
+    int         count;
+};
+
+static int g_RenderGraphBackbufferWidth  = 0;
+static int g_RenderGraphBackbufferHeight = 0;
+
+// Quadro atual.
+static std::vector<RenderGraphResourceData> g_RenderGraphResources;
+static std::vector<RenderGraphPassData>     g_RenderGraphPasses;
+static std::vector<int>                     g_RenderGraphOrder;
+static unsigned long                        g_RenderGraphFrame = 0;
+static RenderGraphStats                     g_RenderGraphStats;
+
+// Recursos que persistem entre quadros.
+static std::vector<RenderGraphPoolTexture> g_RenderGraphPool;
+static std::vector<RenderGraphFramebuffer> g_RenderGraphFramebuffers;
+static GLuint                              g_RenderGraphReadFramebuffer = 0;
+
+// Anel de medições: os quadros de g_RenderGraphQueryFirst em diante
+// (g_RenderGraphQueryCount deles) aguardam resultado.
+static RenderGraphQueryFrame g_RenderGraphQueryFrames[RENDER_GRAPH_QUERY_FRAMES];
+static bool                  g_RenderGraphQueriesCreated = false;
+static unsigned              g_RenderGraphQueryFirst = 0;
+static unsigned              g_RenderGraphQueryCount = 0;
+
+// Resultado do último quadro medido.
+static int         g_RenderGraphTimedCount = 0;
+static const char* g_RenderGraphTimedNames[RENDER_GRAPH_MAX_PASSES];
+static float       g_RenderGraphTimedMilliseconds[RENDER_GRAPH_MAX_PASSES];
+
+void RenderGraph_Resize(int width, int height)
+{
+    g_RenderGraphBackbufferWidth  = width;
+    g_RenderGraphBackbufferHeight = height;
+}
+
+void RenderGraph_GetBackbufferSize(int* width, int* height)
+{
+    *width  = g_RenderGraphBackbufferWidth;
+    *height = g_RenderGraphBackbufferHeight;
+}
+
+void RenderGraph_Begin()
+{
+    g_RenderGraphResources.clear();
+    g_RenderGraphPasses.clear();
+}
+
+RenderGraphResource RenderGraph_ImportBackbuffer()
+{
+    RenderGraphResourceData resource = { "backbuffer", true, RENDER_GRAPH_RGBA8,
+                                         g_RenderGraphBackbufferWidth, g_RenderGraphBackbufferHeight, -1, -1, -1 };
+    g_RenderGraphResources.push_back(resource);
+    return (RenderGraphResource)g_RenderGraphResources.size() - 1;
+}
+
+RenderGraphResource RenderGraph_CreateTexture(const char* name, RenderGraphFormat format, int width, int height)
+{
+    RenderGraphResourceData resource = { name, false, format, width, height, -1, -1, -1 };
+    g_RenderGraphResources.push_back(resource);
+    return (RenderGraphResource)g_RenderGraphResources.size() - 1;
+}
+
+RenderGraphPass RenderGraph_AddPass(const char* name, const std::function<void()>& execute)
+{
+    RenderGraphPassData pass;
+    pass.name = name;
+    pass.execute = execute;
+    pass.needed = false;
+    pass.done = false;
+    g_RenderGraphPasses.push_back(pass);
+    return (RenderGraphPass)g_RenderGraphPasses.size() - 1;
+}
+
+void RenderGraph_Read(RenderGraphPass pass, RenderGraphResource resource)
+{
+    g_RenderGraphPasses[pass].reads.push_back(resource);
+}
+
+void RenderGraph_Write(RenderGraphPass pass, RenderGraphResource resource)
+{
+    g_RenderGraphPasses[pass].writes.push_back(resource);
+}
+
+static bool RenderGraph_Contains(const std::vector<RenderGraphResource>& list, RenderGraphResource resource)
+{
+    for (size_t i = 0; i < list.size(); ++i)
+        if (list[i] == resource)
+            return true;
+    return false;
+}
+
+// Etapa 1: marca os passos necessários.
+static void RenderGraph_Cull()
+{
+    std::vector<bool> read(g_RenderGraphResources.size(), false);
+
+    // Cada iteração marca pelo menos um passo a mais, ou termina.
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t p = 0; p < g_RenderGraphPasses.size(); ++p)
+        {
+            RenderGraphPassData& pass = g_RenderGraphPasses[p];
+            if (pass.needed)
+                continue;
+
+            for (size_t w = 0; w < pass.writes.size() && !pass.needed; ++w)
+            {
+                RenderGraphResource r = pass.writes[w];
+                pass.needed = g_RenderGraphResources[r].backbuffer || read[r];
+            }
+
+            if (pass.needed)
+            {
+                for (size_t i = 0; i < pass.reads.size(); ++i)
+                    read[pass.reads[i]] = true;
+                changed = true;
+            }
+        }
+    }
+}
+
+// Retorna true se algum passo declarado antes de "pass" escreve "resource".
+static bool RenderGraph_HasEarlierWriter(int pass, RenderGraphResource resource)
+{
+    for (int p = 0; p < pass; ++p)
+        if (RenderGraph_Contains(g_RenderGraphPasses[p].writes, resource))
+            return true;
+    return false;
+}
+
+// Retorna true se o passo "b" deve ser executado depois do passo "a".
+static bool RenderGraph_DependsOn(int b, int a)
+{
+    if (a == b)
+        return false;
+
+    const RenderGraphPassData& pa = g_RenderGraphPasses[a];
+    const RenderGraphPassData& pb = g_RenderGraphPasses[b];
+
+    for (size_t w = 0; w < pa.writes.size(); ++w)
+    {
+        RenderGraphResource r = pa.writes[w];
+
+        // "b" lê o que "a" escreveu: "a" foi declarado antes, ou ninguém
+        // escreve "r" antes de "b" (que então espera todos os escritores).
+        if (RenderGraph_Contains(pb.reads, r) && (a < b || !RenderGraph_HasEarlierWriter(b, r)))
+            return true;
+
+        // Escritas do mesmo recurso na ordem de declaração.
+        if (a < b && RenderGraph_Contains(pb.writes, r))
+            return true;
+    }
+
+    // "b" sobrescreve o que "a" lê: "a" lê a versão de um escritor anterior,
+    // que não pode ser destruída antes da leitura.
+    if (a < b)
+    {
+        for (size_t i = 0; i < pa.reads.size(); ++i)
+        {
+            RenderGraphResource r = pa.reads[i];
+            if (RenderGraph_Contains(pb.writes, r) && RenderGraph_HasEarlierWriter(a, r))
+                return true;
+        }
+    }
+    return false;
+}
+
+// Etapa 2: ordena os passos necessários em g_RenderGraphOrder.
+static void RenderGraph_Sort()
+{
+    g_RenderGraphOrder.clear();
+
+    int pending = 0;
+    for (size_t p = 0; p < g_RenderGraphPasses.size(); ++p)
+        if (g_RenderGraphPasses[p].needed)
+            pending += 1;
+
+    int num_passes = (int)g_RenderGraphPasses.size();
+    while (pending > 0)
+    {
+        // O primeiro passo declarado cujas dependências já foram ordenadas.
+        int next = -1;
+        for (int b = 0; b < num_passes && next < 0; ++b)
+        {
+            if (!g_RenderGraphPasses[b].needed || g_RenderGraphPasses[b].done)
+                continue;
+
+            bool ready = true;
+            for (int a = 0; a < num_passes && ready; ++a)
+                if (g_RenderGraphPasses[a].needed && !g_RenderGraphPasses[a].done && RenderGraph_DependsOn(b, a))
+                    ready = false;
+
+            if (ready)
+                next = b;
+        }
+
+        if (next < 0)
+        {
+            fprintf(stderr, "ERROR: render graph has a dependency cycle.\n");
+            std::exit(EXIT_FAILURE);
+        }
+
+        g_RenderGraphPasses[next].done = true;
+        g_RenderGraphOrder.push_back(next);
+        pending -= 1;
+    }
+}
+
+// Etapa 3: primeiro e último uso de cada recurso, na ordem de execução.
+static void RenderGraph_ComputeLifetimes()
+{
+    for (size_t i = 0; i < g_RenderGraphOrder.size(); ++i)
+    {
+        const RenderGraphPassData& pass = g_RenderGraphPasses[g_RenderGraphOrder[i]];
+        for (int k = 0; k < 2; ++k)
+        {
+            const std::vector<RenderGraphResource>& list = k == 0 ? pass.reads : pass.writes;
+            for (size_t j = 0; j < list.size(); ++j)
+            {
+                RenderGraphResourceData& resource = g_RenderGraphResources[list[j]];
+                if (resource.first < 0)
+                    resource.first = (int)i;
+                resource.last = (int)i;
+            }
+        }
+    }
+}
+
+static unsigned long long RenderGraph_BytesPerPixel(RenderGraphFormat format)
+{
+    switch (format)
+    {
+        case RENDER_GRAPH_RGBA16F: return 8;
+        case RENDER_GRAPH_R16F:    return 2;
+        case RENDER_GRAPH_DEPTH24: return 4; // Normalmente alinhado a 32 bits
+        default:                   return 4;
+    }
+}
+
+// Atribui ao recurso uma textura livre do conjunto, criando uma se preciso.
+static void RenderGraph_Acquire(RenderGraphResourceData& resource)
+{
+    for (size_t i = 0; i < g_RenderGraphPool.size(); ++i)
+    {
+        RenderGraphPoolTexture& t = g_RenderGraphPool[i];
+        if (!t.in_use && t.format == resource.format && t.width == resource.width && t.height == resource.height)
+        {
+            t.in_use = true;
+            t.last_frame = g_RenderGraphFrame;
+            resource.pool_index = (int)i;
+            return;
+        }
+    }
+
+    RenderGraphPoolTexture t;
+    t.format = resource.format;
+    t.width  = resource.width;
+    t.height = resource.height;
+    t.in_use = true;
+    t.last_frame = g_RenderGraphFrame;
+
+    glGenTextures(1, &t.texture);
+    glBindTexture(GL_TEXTURE_2D, t.texture);
+    switch (resource.format)
+    {
+        case RENDER_GRAPH_RGBA16F:
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, t.width, t.height, 0, GL_RGBA, GL_HALF_FLOAT, NULL);
+            break;
+        case RENDER_GRAPH_R16F:
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, t.width, t.height, 0, GL_RED, GL_HALF_FLOAT, NULL);
+            break;
+        case RENDER_GRAPH_DEPTH24:
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, t.width, t.height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+            break;
+        default:
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, t.width, t.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+            break;
+    }
+    GLint filter = resource.format == RENDER_GRAPH_DEPTH24 ? GL_NEAREST : GL_LINEAR;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    g_RenderGraphPool.push_back(t);
+    resource.pool_index = (int)g_RenderGraphPool.size() - 1;
+}
+
+// Libera as texturas sem uso há muito tempo, junto com os framebuffers que
+// as usam.
+static void RenderGraph_Evict()
+{
+    for (size_t i = 0; i < g_RenderGraphPool.size(); )
+    {
+        RenderGraphPoolTexture& t = g_RenderGraphPool[i];
+        if (t.in_use || g_RenderGraphFrame - t.last_frame < RENDER_GRAPH_MAX_IDLE_FRAMES)
+        {
+            ++i;
+            continue;
+        }
+
+        for (size_t f = 0; f < g_RenderGraphFramebuffers.size(); )
+        {
+            RenderGraphFramebuffer& fb = g_RenderGraphFramebuffers[f];
+            bool uses = fb.depth == t.texture;
+            for (int c = 0; c < fb.num_color; ++c)
+                uses = uses || fb.color[c] == t.texture;
+
+            if (uses)
+            {
+                glDeleteFramebuffers(1, &fb.framebuffer);
+                g_RenderGraphFramebuffers[f] = g_RenderGraphFramebuffers.back();
+                g_RenderGraphFramebuffers.pop_back();
+            }
+            else
+                ++f;
+        }
+
+        glDeleteTextures(1, &t.texture);
+        g_RenderGraphPool[i] = g_RenderGraphPool.back();
+        g_RenderGraphPool.pop_back();
+    }
+}
+
+// Liga o framebuffer com as texturas escritas pelo passo, ou a janela, e
+// ajusta o viewport.
+static void RenderGraph_BindPassFramebuffer(const RenderGraphPassData& pass)
+{
+    GLuint color[RENDER_GRAPH_MAX_COLOR];
+    int    num_color = 0;
+    GLuint depth = 0;
+    int    width  = g_RenderGraphBackbufferWidth;
+    int    height = g_RenderGraphBackbufferHeight;
+    bool   backbuffer = false;
+
+    for (size_t w = 0; w < pass.writes.size(); ++w)
+    {
+        const RenderGraphResourceData& resource = g_RenderGraphResources[pass.writes[w]];
+        if (resource.backbuffer)
+        {
+            backbuffer = true;
+            continue;
+        }
+
+        GLuint texture = g_RenderGraphPool[resource.pool_index].texture;
+        if (resource.format == RENDER_GRAPH_DEPTH24)
+            depth = texture;
+        else if (num_color < RENDER_GRAPH_MAX_COLOR)
+            color[num_color++] = texture;
+        width  = resource.width;
+        height = resource.height;
+    }
+
+    if (backbuffer || (num_color == 0 && depth == 0))
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, g_RenderGraphBackbufferWidth, g_RenderGraphBackbufferHeight);
+        return;
+    }
+
+    for (size_t f = 0; f < g_RenderGraphFramebuffers.size(); ++f)
+    {
+        const RenderGraphFramebuffer& fb = g_RenderGraphFramebuffers[f];
+        bool same = fb.num_color == num_color && fb.depth == depth;
+        for (int c = 0; c < num_color && same; ++c)
+            same = fb.color[c] == color[c];
+
+        if (same)
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, fb.framebuffer);
+            glViewport(0, 0, width, height);
+            return;
+        }
+    }
+
+    RenderGraphFramebuffer fb;
+    fb.num_color = num_color;
+    fb.depth = depth;
+    glGenFramebuffers(1, &fb.framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, fb.framebuffer);
+    GLDebug_Label(GL_FRAMEBUFFER, fb.framebuffer, pass.name);
+
+    GLenum draw_buffers[RENDER_GRAPH_MAX_COLOR];
+    for (int c = 0; c < num_color; ++c)
+    {
+        fb.color[c] = color[c];
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + c, GL_TEXTURE_2D, color[c], 0);
+        draw_buffers[c] = GL_COLOR_ATTACHMENT0 + c;
+    }
+    if (depth != 0)
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth, 0);
+
+    if (num_color > 0)
+        glDrawBuffers(num_color, draw_buffers);
+    else
+        glDrawBuffer(GL_NONE);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        fprintf(stderr, "WARNING: render graph framebuffer of pass \"%s\" incomplete.\n", pass.name);
+
+    g_RenderGraphFramebuffers.push_back(fb);
+    glViewport(0, 0, width, height);
+}
+
+// Lê os resultados das medições já prontas.
+static void RenderGraph_ReadQueries()
+{
+    while (g_RenderGraphQueryCount > 0)
+    {
+        RenderGraphQueryFrame& frame = g_RenderGraphQueryFrames[g_RenderGraphQueryFirst];
+        if (frame.count > 0)
+        {
+            GLint available = 0;
+            glGetQueryObjectiv(frame.queries[2 * frame.count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                break;
+
+            for (int i = 0; i < frame.count; ++i)
+            {
+                GLuint64 begin = 0, end = 0;
+                glGetQueryObjectui64v(frame.queries[2 * i],     GL_QUERY_RESULT, &begin);
+                glGetQueryObjectui64v(frame.queries[2 * i + 1], GL_QUERY_RESULT, &end);
+                g_RenderGraphTimedNames[i] = frame.names[i];
+                g_RenderGraphTimedMilliseconds[i] = (float)((end - begin) * 1e-6);
+            }
+            g_RenderGraphTimedCount = frame.count;
+        }
+
+        g_RenderGraphQueryFirst = (g_RenderGraphQueryFirst + 1) % RENDER_GRAPH_QUERY_FRAMES;
+        g_RenderGraphQueryCount -= 1;
+    }
+}
+
+void RenderGraph_Execute()
+{
+    // Janela minimizada (ou ainda sem tamanho): não há onde desenhar.
+    if (g_RenderGraphBackbufferWidth <= 0 || g_RenderGraphBackbufferHeight <= 0)
+        return;
+
+    g_RenderGraphFrame += 1;
+
+    RenderGraph_Cull();
+    RenderGraph_Sort();
+    RenderGraph_ComputeLifetimes();
+
+    if (!g_RenderGraphQueriesCreated)
+    {
+        for (int i = 0; i < RENDER_GRAPH_QUERY_FRAMES; ++i)
+            glGenQueries(2 * RENDER_GRAPH_MAX_PASSES, g_RenderGraphQueryFrames[i].queries);
+        g_RenderGraphQueriesCreated = true;
+    }
+    RenderGraph_ReadQueries();
+
+    // Se todos os quadros do anel ainda aguardam resultado, este quadro não
+    // é medido.
+    RenderGraphQueryFrame* timing = NULL;
+    if (g_RenderGraphQueryCount < RENDER_GRAPH_QUERY_FRAMES)
+    {
+        timing = &g_RenderGraphQueryFrames[(g_RenderGraphQueryFirst + g_RenderGraphQueryCount) % RENDER_GRAPH_QUERY_FRAMES];
+        timing->count = 0;
+    }
+
+    for (size_t i = 0; i < g_RenderGraphOrder.size(); ++i)
+    {
+        RenderGraphPassData& pass = g_RenderGraphPasses[g_RenderGraphOrder[i]];
+
+        for (size_t r = 0; r < g_RenderGraphResources.size(); ++r)
+        {
+            RenderGraphResourceData& resource = g_RenderGraphResources[r];
+            if (!resource.backbuffer && resource.first == (int)i)
+            {
+                RenderGraph_Acquire(resource);
+
+                // Texturas do conjunto mudam de recurso entre quadros (e
+                // dentro de um quadro), então o nome é dado a cada uso.
+                GLDebug_Label(GL_TEXTURE, g_RenderGraphPool[resource.pool_index].texture, resource.name);
+            }
+        }
+
+        GLDebug_PushGroup(pass.name);
+        RenderGraph_BindPassFramebuffer(pass);
+
+        bool timed = timing != NULL && timing->count < RENDER_GRAPH_MAX_PASSES;
+        if (timed)
+            glQueryCounter(timing->queries[2 * timing->count], GL_TIMESTAMP);
+
+        pass.execute();
+
+        if (timed)
+        {
+            glQueryCounter(timing->queries[2 * timing->count + 1], GL_TIMESTAMP);
+            timing->names[timing->count] = pass.name;
+            timing->count += 1;
+        }
+        GLDebug_PopGroup();
+
+        // Texturas que não são mais usadas neste quadro ficam livres para os
+        // próximos passos.
+        for (size_t r = 0; r < g_RenderGraphResources.size(); ++r)
+        {
+            RenderGraphResourceData& resource = g_RenderGraphResources[r];
+            if (!resource.backbuffer && resource.last == (int)i)
+                g_RenderGraphPool[resource.pool_index].in_use = false;
+        }
+    }
+
+    if (timing != NULL)
+        g_RenderGraphQueryCount += 1;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, g_RenderGraphBackbufferWidth, g_RenderGraphBackbufferHeight);
+
+    // Estatísticas, antes de liberar as texturas antigas.
+    g_RenderGraphStats.passes = (unsigned int)g_RenderGraphPasses.size();
+    g_RenderGraphStats.culled_passes = (unsigned int)(g_RenderGraphPasses.size() - g_RenderGraphOrder.size());
+    g_RenderGraphStats.textures = 0;
+    for (size_t r = 0; r < g_RenderGraphResources.size(); ++r)
+        if (!g_RenderGraphResources[r].backbuffer && g_RenderGraphResources[r].pool_index >= 0)
+            g_RenderGraphStats.textures += 1;
+
+    RenderGraph_Evict();
+
+    g_RenderGraphStats.pool_textures = (unsigned int)g_RenderGraphPool.size();
+    g_RenderGraphStats.pool_bytes = 0;
+    for (size_t i = 0; i < g_RenderGraphPool.size(); ++i)
+    {
+        const RenderGraphPoolTexture& t = g_RenderGraphPool[i];
+        g_RenderGraphStats.pool_bytes += (unsigned long long)t.width * t.height * RenderGraph_BytesPerPixel(t.format);
+    }
+}
+
+GLuint RenderGraph_GetTexture(RenderGraphResource resource)
+{
+    int pool_index = g_RenderGraphResources[resource].pool_index;
+    return pool_index >= 0 ? g_RenderGraphPool[pool_index].texture : 0;
+}
+
+void RenderGraph_BindReadFramebuffer(RenderGraphResource resource)
+{
+    if (g_RenderGraphReadFramebuffer == 0)
+        glGenFramebuffers(1, &g_RenderGraphReadFramebuffer);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, g_RenderGraphReadFramebuffer);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, RenderGraph_GetTexture(resource), 0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+}
+
+int RenderGraph_GetTimedPassCount()
+{
+    return g_RenderGraphTimedCount;
+}
+
+const char* RenderGraph_GetTimedPassName(int index)
+{
+    return g_RenderGraphTimedNames[index];
+}
+
+float RenderGraph_GetTimedPassMilliseconds(int index)
+{
+    return g_RenderGraphTimedMilliseconds[index];
+}
+
+RenderGraphStats RenderGraph_GetStats()
+{
+    return g_RenderGraphStats;
+}
@@ -0,0 +1,792 @@
+// Submissão da cena virtual para a GPU.
+//
+// Existem dois caminhos de renderização:
+//
+//   1. OpenGL 3.3: para cada DrawItem, ligamos o VAO e a textura do objeto,
+//      enviamos a matriz "model" e chamamos glDrawElements(). É o caminho
+//      original do programa, sempre disponível.
+//
+//   2. Multi-draw indirect (OpenGL 4.3 / GL_ARB_multi_draw_indirect): toda a
+//      geometria da cena fica em um único VAO (g_SceneGeometry). Os comandos
+//      de desenho e as matrizes de modelagem de cada objeto são escritos em
+//      buffers da GPU, e todos os objetos opacos são desenhados com uma única
+//      chamada glMultiDrawElementsIndirect(). O custo de CPU deixa de crescer
+//      com o número de objetos da cena.
+//
+// Em ambos os caminhos, os objetos fora do frustum da câmera são descartados
+// antes de qualquer submissão (veja "culling.h"), assim como os objetos
+// escondidos atrás dos oclusores (veja "occlusion.h"). Os demais são
+// desenhados no nível de detalhe escolhido a partir do seu tamanho na tela
+// (veja "lod.h"), e o quadro é dividido nos passos descritos em "renderer.h"
+// (enum RenderPass). Dos objetos divididos em meshlets (veja "meshlet.h"),
+// somente os meshlets visíveis são submetidos: cada objeto é desenhado como
+// uma lista compacta de trechos de índices, com glMultiDrawElements() no
+// caminho 1 e um comando indireto por trecho no caminho 2. Objetos com impostor são
+// substituídos por este quando estão longe da câmera (veja "impostor.h").
+// Objetos estáticos e o céu são copiados de uma camada em cache enquanto a
+// câmera está parada (veja "layer_cache.h").
+//
+// Note que, apesar de pedirmos um contexto OpenGL 3.3 em main(), a maioria dos
+// drivers (inclusive os drivers em software do Mesa) retorna um contexto com a
+// maior versão "core" disponível, e portanto o caminho 2 é escolhido
+// automaticamente sempre que possível.
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/mat4x4.hpp>
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "culling.h"
+#include "gl_debug.h"
+#include "gl_extensions.h"
+#include "gl_state.h"
+#include "impostor.h"
+#include "layer_cache.h"
+#include "lod.h"
+#include "occlusion.h"
+#include "renderer.h"
+#include "skybox.h"
+
+// Funções definidas em main.cpp
+GLuint LoadShader_Vertex(const char* filename);
+GLuint LoadShader_Fragment(const char* filename);
+GLuint CreateGpuProgram(GLuint vertex_shader_id, GLuint fragment_shader_id);
+
+// Número máximo de texturas distintas em uma mesma chamada
+// glMultiDrawElementsIndirect(). Deve ser igual a MAX_TEXTURE_SLOTS em
+// "shader_fragment_mdi.glsl".
+#define MAX_TEXTURE_SLOTS 16
+
+// Formato de um comando de desenho lido pela GPU do GL_DRAW_INDIRECT_BUFFER.
+// Definido pela especificação de OpenGL; não pode ser alterado.
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint  baseVertex;
+    GLuint baseInstance;
+};
+
+// Dados de cada objeto lidos pelo "shader_vertex_mdi.glsl" através de um
+// shader storage buffer. Layout std430: mat4 seguido de quatro valores de 32
+// bits.
+struct ObjectData
+{
+    glm::mat4 model;
+    GLuint    texture_slot;
+    GLfloat   impostor_fade;
+    GLuint    padding[2];
+};
+
+// Programa de GPU do caminho OpenGL 3.3, e as posições das suas variáveis
+// "uniform" (-1 se o programa não a usa).
+struct RendererProgram
+{
+    GLuint id;
+    GLint  model_uniform;
+    GLint  view_uniform;
+    GLint  projection_uniform;
+    GLint  impostor_fade_uniform;
+    GLint  opacity_uniform;
+};
+
+// Caminho OpenGL 3.3
+RendererProgram g_RendererProgram;
+
+// Acumulação dos objetos transparentes (veja "oit.h"), sempre pelo caminho
+// OpenGL 3.3.
+RendererProgram g_RendererOitProgram;
+
+// Caminho multi-draw indirect
+bool   g_RendererMultiDrawIndirect = false;
+GLuint g_RendererMdiProgramId;
+GLint  g_RendererMdiViewUniform;
+GLint  g_RendererMdiProjectionUniform;
+GLuint g_RendererMdiVAO;
+GLuint g_RendererMdiDrawIdBuffer;
+GLuint g_RendererMdiIndirectBuffer;
+GLuint g_RendererMdiObjectBuffer;
+size_t g_RendererMdiDrawIdCapacity = 0;
+
+RendererStats g_RendererStats;
+
+// Trecho do vetor de índices de um modelo a ser desenhado. Os trechos de
+// todos os itens de um quadro são guardados em g_RendererRanges.
+struct IndexRange
+{
+    GLuint first_index; // Relativo ao vetor indices[] do modelo, como SceneObject::first_index
+    GLuint num_indices;
+};
+
+std::vector<IndexRange> g_RendererRanges;
+
+// Cria o VAO único contendo toda a geometria de g_SceneGeometry, mais um
+// atributo "draw_id" por instância. Como cada comando de desenho usa
+// baseInstance igual à sua posição no buffer de comandos, o atributo
+// "draw_id" recebe, no vertex shader, o índice do objeto sendo desenhado.
+static void Renderer_BuildMultiDrawVAO()
+{
+    glGenVertexArrays(1, &g_RendererMdiVAO);
+    glBindVertexArray(g_RendererMdiVAO);
+
+    GLuint VBO_model_coefficients_id;
+    glGenBuffers(1, &VBO_model_coefficients_id);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO_model_coefficients_id);
+    glBufferData(GL_ARRAY_BUFFER, g_SceneGeometry.model_coefficients.size() * sizeof(float), g_SceneGeometry.model_coefficients.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0); // "(location = 0)" em "shader_vertex_mdi.glsl"
+    glEnableVertexAttribArray(0);
+
+    GLuint VBO_texture_coefficients_id;
+    glGenBuffers(1, &VBO_texture_coefficients_id);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO_texture_coefficients_id);
+    glBufferData(GL_ARRAY_BUFFER, g_SceneGeometry.texture_coefficients.size() * sizeof(float), g_SceneGeometry.texture_coefficients.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, 0); // "(location = 1)" em "shader_vertex_mdi.glsl"
+    glEnableVertexAttribArray(1);
+
+    glGenBuffers(1, &g_RendererMdiDrawIdBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, g_RendererMdiDrawIdBuffer);
+    glVertexAttribIPointer(2, 1, GL_UNSIGNED_INT, 0, 0); // "(location = 2)" em "shader_vertex_mdi.glsl"
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(2);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    GLuint indices_id;
+    glGenBuffers(1, &indices_id);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices_id);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, g_SceneGeometry.indices.size() * sizeof(GLuint), g_SceneGeometry.indices.data(), GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+
+    glGenBuffers(1, &g_RendererMdiIndirectBuffer);
+    glGenBuffers(1, &g_RendererMdiObjectBuffer);
+}
+
+// Garante que o buffer de "draw_id" contém os valores 0, 1, ..., count-1.
+static void Renderer_ReserveDrawIds(size_t count)
+{
+    if (count <= g_RendererMdiDrawIdCapacity)
+        return;
+
+    size_t capacity = g_RendererMdiDrawIdCapacity > 0 ? g_RendererMdiDrawIdCapacity : 64;
+    while (capacity < count)
+        capacity *= 2;
+
+    std::vector<GLuint> draw_ids(capacity);
+    for (size_t i = 0; i < capacity; ++i)
+        draw_ids[i] = (GLuint)i;
+
+    glBindBuffer(GL_ARRAY_BUFFER, g_RendererMdiDrawIdBuffer);
+    glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(GLuint), draw_ids.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    g_RendererMdiDrawIdCapacity = capacity;
+}
+
+static RendererProgram Renderer_MakeProgram(GLuint program_id)
+{
+    RendererProgram program;
+    program.id                    = program_id;
+    program.model_uniform         = glGetUniformLocation(program_id, "model");
+    program.view_uniform          = glGetUniformLocation(program_id, "view");
+    program.projection_uniform    = glGetUniformLocation(program_id, "projection");
+    program.impostor_fade_uniform = glGetUniformLocation(program_id, "impostor_fade");
+    program.opacity_uniform       = glGetUniformLocation(program_id, "opacity");
+    return program;
+}
+
+void Renderer_Init(GLuint program_id)
+{
+    g_RendererProgram = Renderer_MakeProgram(program_id);
+
+    GLuint oit_vertex_shader_id   = LoadShader_Vertex("../src/shader_vertex.glsl");
+    GLuint oit_fragment_shader_id = LoadShader_Fragment("../src/shader_fragment_oit.glsl");
+    g_RendererOitProgram = Renderer_MakeProgram(CreateGpuProgram(oit_vertex_shader_id, oit_fragment_shader_id));
+    GLDebug_Label(GL_PROGRAM, g_RendererProgram.id, "renderer");
+    GLDebug_Label(GL_PROGRAM, g_RendererOitProgram.id, "renderer oit");
+
+    bool supported = GLExtensions_VersionAtLeast(4, 3)
+                  && GLExtensions_IsSupported("GL_ARB_multi_draw_indirect")
+                  && glMultiDrawElementsIndirect != NULL;
+
+    if (!supported)
+    {
+        printf("Renderizador: OpenGL 3.3 (um glDrawElements() por objeto).\n");
+        return;
+    }
+
+    GLuint vertex_shader_id   = LoadShader_Vertex("../src/shader_vertex_mdi.glsl");
+    GLuint fragment_shader_id = LoadShader_Fragment("../src/shader_fragment_mdi.glsl");
+    g_RendererMdiProgramId    = CreateGpuProgram(vertex_shader_id, fragment_shader_id);
+    GLDebug_Label(GL_PROGRAM, g_RendererMdiProgramId, "renderer mdi");
+
+    GLint linked_ok = GL_FALSE;
+    glGetProgramiv(g_RendererMdiProgramId, GL_LINK_STATUS, &linked_ok);
+    if (linked_ok == GL_FALSE)
+    {
+        fprintf(stderr, "WARNING: multi-draw indirect shaders failed; falling back to OpenGL 3.3 path.\n");
+        printf("Renderizador: OpenGL 3.3 (um glDrawElements() por objeto).\n");
+        return;
+    }
+
+    g_RendererMdiViewUniform       = glGetUniformLocation(g_RendererMdiProgramId, "view");
+    g_RendererMdiProjectionUniform = glGetUniformLocation(g_RendererMdiProgramId, "projection");
+
+    // Cada posição do array "gSamplers" do fragment shader lê de uma unidade
+    // de textura diferente.
+    GLint units[MAX_TEXTURE_SLOTS];
+    for (int i = 0; i < MAX_TEXTURE_SLOTS; ++i)
+        units[i] = i;
+    glUseProgram(g_RendererMdiProgramId);
+    glUniform1iv(glGetUniformLocation(g_RendererMdiProgramId, "gSamplers"), MAX_TEXTURE_SLOTS, units);
+    glUseProgram(0);
+
+    Renderer_BuildMultiDrawVAO();
+    Renderer_ReserveDrawIds(256);
+
+    g_RendererMultiDrawIndirect = true;
+    printf("Renderizador: multi-draw indirect (um glMultiDrawElementsIndirect() por quadro).\n");
+}
+
+bool Renderer_UsingMultiDrawIndirect()
+{
+    return g_RendererMultiDrawIndirect;
+}
+
+const RendererStats& Renderer_GetStats()
+{
+    return g_RendererStats;
+}
+
+// Calcula a esfera envolvente do item em coordenadas globais. Retorna o raio;
+// o centro é escrito em "center".
+static float Renderer_WorldBoundingSphere(const DrawItem& item, glm::vec4* center)
+{
+    const glm::mat4& model = item.model;
+
+    *center = model * glm::vec4(item.object->bsphere_center, 1.0f);
+
+    // O raio é multiplicado pelo maior fator de escala da matriz de
+    // modelagem (comprimento das três primeiras colunas).
+    float scale2 = std::max(glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+                   std::max(glm::dot(glm::vec3(model[1]), glm::vec3(model[1])),
+                            glm::dot(glm::vec3(model[2]), glm::vec3(model[2]))));
+
+    return item.object->bsphere_radius * std::sqrt(scale2);
+}
+
+// Raio da esfera envolvente do item projetado na tela, em NDC. A coordenada
+// w de recorte do centro é a distância até a câmera na projeção perspectiva,
+// e 1 na ortográfica; em ambos os casos o raio em NDC é
+// raio * projection[1][1] / w. Retorna -1 se a câmera está dentro da esfera.
+static float Renderer_ProjectedRadius(const DrawItem& item, const glm::mat4& view_projection, const glm::mat4& projection)
+{
+    glm::vec4 center;
+    float radius = Renderer_WorldBoundingSphere(item, &center);
+    float w = (view_projection * center).w;
+
+    if (w <= radius)
+        return -1.0f;
+    return radius * projection[1][1] / w;
+}
+
+// Escolhe o nível de detalhe do item a partir do raio projetado da sua esfera
+// envolvente (veja Renderer_ProjectedRadius()).
+static unsigned int Renderer_SelectLod(const DrawItem& item, float projected_radius)
+{
+    if (item.object->num_lods <= 1)
+        return 0;
+
+    // Câmera dentro da esfera: nível mais detalhado.
+    unsigned int lod = 0;
+    if (projected_radius >= 0.0f)
+        lod = Lod_Select(*item.object, projected_radius, item.lod_state ? *item.lod_state : 0);
+
+    if (item.lod_state)
+        *item.lod_state = lod;
+    return lod;
+}
+
+// Descarta os itens cujas esferas envolventes estão fora do frustum. As
+// esferas de todos os itens são transformadas para coordenadas globais e
+// testadas em lote por Culling_TestSpheres(). Escreve visible[i] para cada
+// item.
+static void Renderer_CullItems(const std::vector<DrawItem>& items, const Frustum& frustum, std::vector<unsigned char>& visible)
+{
+    // Vetores estáticos: mantém a memória alocada entre quadros.
+    static std::vector<float> x, y, z, radius;
+    size_t count = items.size();
+    x.resize(count);
+    y.resize(count);
+    z.resize(count);
+    radius.resize(count);
+    visible.resize(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        glm::vec4 center;
+        radius[i] = Renderer_WorldBoundingSphere(items[i], &center);
+        x[i] = center.x;
+        y[i] = center.y;
+        z[i] = center.z;
+    }
+
+    size_t num_visible = count > 0 ? Culling_TestSpheres(frustum, x.data(), y.data(), z.data(), radius.data(), count, visible.data()) : 0;
+
+    g_RendererStats.visible_objects = (unsigned int)num_visible;
+    g_RendererStats.culled_objects  = (unsigned int)(count - num_visible);
+}
+
+// Item da lista de desenho acompanhado da sua distância até a câmera, usada
+// para ordenação, e dos trechos de índices a desenhar:
+// g_RendererRanges[first_range ... first_range + num_ranges - 1].
+struct SortedDrawItem
+{
+    float           depth;
+    const DrawItem* item;
+    size_t          first_range;
+    size_t          num_ranges;
+    float           impostor_fade; // Fração dos pixels desenhada pelo impostor
+};
+
+// Objetos transparentes visíveis do último Renderer_DrawScene(), desenhados
+// depois por Renderer_DrawTransparent().
+static std::vector<SortedDrawItem> g_RendererTransparent;
+
+// Calcula os trechos de índices a desenhar para o item, no nível de detalhe
+// "lod", e os adiciona a g_RendererRanges. Se o objeto foi dividido em
+// meshlets, os meshlets fora do frustum e, se "camera_position" não for NULL,
+// os de costas para a câmera são descartados; meshlets visíveis consecutivos
+// formam um único trecho. Os testes são feitos em coordenadas locais do
+// objeto, evitando transformar cada meshlet.
+static void Renderer_CullMeshlets(const DrawItem& item, unsigned int lod, const Frustum& frustum, const glm::vec3* camera_position, SortedDrawItem* sorted)
+{
+    const SceneObject& object = *item.object;
+
+    sorted->first_range = g_RendererRanges.size();
+
+    size_t count = object.lod_num_meshlets[lod];
+    if (count == 0)
+    {
+        IndexRange range = { (GLuint)object.lod_first_index[lod], (GLuint)object.lod_num_indices[lod] };
+        g_RendererRanges.push_back(range);
+        sorted->num_ranges = 1;
+        return;
+    }
+
+    // Vetor estático: mantém a memória alocada entre quadros.
+    static std::vector<unsigned char> visible;
+    visible.resize(count);
+
+    const SceneMeshlets& m = g_SceneMeshlets;
+    size_t first = object.lod_first_meshlet[lod];
+
+    Frustum local_frustum = Culling_TransformFrustum(frustum, item.model);
+    size_t num_visible = Culling_TestSpheres(local_frustum, &m.center_x[first], &m.center_y[first], &m.center_z[first], &m.radius[first],
+                                             count, visible.data());
+
+    if (camera_position && num_visible > 0)
+    {
+        glm::vec3 local_camera = glm::vec3(glm::inverse(item.model) * glm::vec4(*camera_position, 1.0f));
+        num_visible = Culling_TestCones(local_camera, &m.center_x[first], &m.center_y[first], &m.center_z[first], &m.radius[first],
+                                        &m.axis_x[first], &m.axis_y[first], &m.axis_z[first], &m.cutoff[first],
+                                        count, visible.data());
+    }
+
+    g_RendererStats.visible_meshlets += (unsigned int)num_visible;
+    g_RendererStats.culled_meshlets  += (unsigned int)(count - num_visible);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!visible[i])
+            continue;
+
+        GLuint first_index = m.first_index[first + i];
+        GLuint num_indices = m.num_indices[first + i];
+
+        IndexRange* last = g_RendererRanges.size() > sorted->first_range ? &g_RendererRanges.back() : NULL;
+        if (last && last->first_index + last->num_indices == first_index)
+        {
+            last->num_indices += num_indices;
+        }
+        else
+        {
+            IndexRange range = { first_index, num_indices };
+            g_RendererRanges.push_back(range);
+        }
+    }
+
+    sorted->num_ranges = g_RendererRanges.size() - sorted->first_range;
+}
+
+static bool Renderer_FrontToBack(const SortedDrawItem& a, const SortedDrawItem& b) { return a.depth < b.depth; }
+
+// Caminho OpenGL 3.3: um glDrawElements() por item (ou glMultiDrawElements(),
+// se o item tiver mais de um trecho de índices), com o programa "program".
+static void Renderer_DrawItemsIndividually(const RendererProgram& program, const std::vector<const SortedDrawItem*>& items, const glm::mat4& view, const glm::mat4& projection)
+{
+    if (items.empty())
+        return;
+
+    glUseProgram(program.id);
+    glUniformMatrix4fv(program.view_uniform       , 1 , GL_FALSE , glm::value_ptr(view));
+    glUniformMatrix4fv(program.projection_uniform , 1 , GL_FALSE , glm::value_ptr(projection));
+    glActiveTexture(GL_TEXTURE0);
+
+    // Vetores estáticos: mantém a memória alocada entre quadros.
+    static std::vector<GLsizei> counts;
+    static std::vector<const void*> offsets;
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        const DrawItem& item = *items[i]->item;
+        const IndexRange* ranges = &g_RendererRanges[items[i]->first_range];
+        size_t num_ranges = items[i]->num_ranges;
+
+        glBindVertexArray(item.object->vertex_array_object_id);
+        glBindTexture(GL_TEXTURE_2D, item.texture);
+        glUniformMatrix4fv(program.model_uniform, 1, GL_FALSE, glm::value_ptr(item.model));
+        glUniform1f(program.impostor_fade_uniform, items[i]->impostor_fade);
+        glUniform1f(program.opacity_uniform, item.opacity);
+
+        if (num_ranges == 1)
+        {
+            glDrawElements(
+                item.object->rendering_mode, // Veja slides 182-188 do documento Aula_04_Modelagem_Geometrica_3D.pdf
+                ranges[0].num_indices,
+                GL_UNSIGNED_INT,
+                (void*)(ranges[0].first_index * sizeof(GLuint))
+            );
+        }
+        else
+        {
+            counts.resize(num_ranges);
+            offsets.resize(num_ranges);
+            for (size_t r = 0; r < num_ranges; ++r)
+            {
+                counts[r]  = (GLsizei)ranges[r].num_indices;
+                offsets[r] = (const void*)(ranges[r].first_index * sizeof(GLuint));
+            }
+            glMultiDrawElements(item.object->rendering_mode, counts.data(), GL_UNSIGNED_INT, offsets.data(), (GLsizei)num_ranges);
+        }
+
+        if (item.object->rendering_mode == GL_TRIANGLES)
+            for (size_t r = 0; r < num_ranges; ++r)
+                g_RendererStats.triangles += ranges[r].num_indices / 3;
+    }
+
+    glBindVertexArray(0);
+}
+
+// Caminho multi-draw indirect: desenha, com uma única chamada, todos os itens
+// possíveis, na ordem em que aparecem em "items", com um comando por trecho
+// de índices de cada item. Os itens que não puderam ser incluídos (outro
+// tipo de primitiva, fora de g_SceneGeometry, ou mais de MAX_TEXTURE_SLOTS
+// texturas distintas) são colocados em "leftover".
+static void Renderer_DrawItemsMultiDraw(const std::vector<const SortedDrawItem*>& items, const glm::mat4& view, const glm::mat4& projection, std::vector<const SortedDrawItem*>& leftover)
+{
+    // Vetores estáticos: mantém a memória alocada entre quadros.
+    static std::vector<DrawElementsIndirectCommand> commands;
+    static std::vector<ObjectData> objects;
+    commands.clear();
+    objects.clear();
+
+    GLuint textures[MAX_TEXTURE_SLOTS];
+    GLuint num_textures = 0;
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        const DrawItem& item = *items[i]->item;
+
+        if (item.object->rendering_mode != GL_TRIANGLES || item.object->pool_base_vertex < 0)
+        {
+            leftover.push_back(items[i]);
+            continue;
+        }
+
+        GLuint slot = 0;
+        while (slot < num_textures && textures[slot] != item.texture)
+            ++slot;
+        if (slot == num_textures)
+        {
+            if (num_textures == MAX_TEXTURE_SLOTS)
+            {
+                leftover.push_back(items[i]);
+                continue;
+            }
+            textures[num_textures++] = item.texture;
+        }
+
+        // Todos os comandos do item leem os dados da mesma posição do
+        // buffer de objetos.
+        for (size_t r = 0; r < items[i]->num_ranges; ++r)
+        {
+            const IndexRange& range = g_RendererRanges[items[i]->first_range + r];
+
+            // Os trechos são relativos ao vetor de índices do modelo, que foi
+            // copiado inteiro para g_SceneGeometry: a mesma diferença em
+            // relação a first_index vale nos dois vetores.
+            DrawElementsIndirectCommand command;
+            command.count         = range.num_indices;
+            command.instanceCount = 1;
+            command.firstIndex    = item.object->pool_first_index + (range.first_index - (GLuint)item.object->first_index);
+            command.baseVertex    = item.object->pool_base_vertex;
+            command.baseInstance  = (GLuint)objects.size();
+            commands.push_back(command);
+            g_RendererStats.triangles += command.count / 3;
+        }
+
+        ObjectData object;
+        object.model        = item.model;
+        object.texture_slot  = slot;
+        object.impostor_fade = items[i]->impostor_fade;
+        objects.push_back(object);
+    }
+
+    if (commands.empty())
+        return;
+
+    Renderer_ReserveDrawIds(objects.size());
+
+    glUseProgram(g_RendererMdiProgramId);
+    glUniformMatrix4fv(g_RendererMdiViewUniform       , 1 , GL_FALSE , glm::value_ptr(view));
+    glUniformMatrix4fv(g_RendererMdiProjectionUniform , 1 , GL_FALSE , glm::value_ptr(projection));
+
+    for (GLuint slot = 0; slot < num_textures; ++slot)
+    {
+        glActiveTexture(GL_TEXTURE0 + slot);
+        glBindTexture(GL_TEXTURE_2D, textures[slot]);
+    }
+
+    // Os buffers são realocados a cada quadro ("orphaning"), de forma que
+    // o driver não precise esperar a GPU terminar o quadro anterior.
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, g_RendererMdiObjectBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, objects.size() * sizeof(ObjectData), objects.data(), GL_STREAM_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, g_RendererMdiObjectBuffer); // "binding = 0" em "shader_vertex_mdi.glsl"
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, g_RendererMdiIndirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_STREAM_DRAW);
+
+    glBindVertexArray(g_RendererMdiVAO);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, 0, (GLsizei)commands.size(), 0);
+    glBindVertexArray(0);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+// Objetos que fazem parte da camada estática (veja "layer_cache.h"). Objetos
+// com impostor ficam de fora: a transição depende do quadro.
+static bool Renderer_IsCacheable(const DrawItem& item)
+{
+    return item.is_static && item.pass == RENDER_PASS_OPAQUE && item.impostor == NULL;
+}
+
+// Acumula "size" bytes em um hash FNV-1a de 64 bits.
+static unsigned long long Renderer_Hash(unsigned long long hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
+// Chave do conteúdo da camada estática: câmera e objetos estáticos.
+static unsigned long long Renderer_StaticLayerKey(const std::vector<DrawItem>& items, const glm::mat4& view, const glm::mat4& projection)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    hash = Renderer_Hash(hash, glm::value_ptr(view), sizeof(glm::mat4));
+    hash = Renderer_Hash(hash, glm::value_ptr(projection), sizeof(glm::mat4));
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        if (!Renderer_IsCacheable(items[i]))
+            continue;
+        hash = Renderer_Hash(hash, &items[i].object, sizeof(items[i].object));
+        hash = Renderer_Hash(hash, &items[i].object->revision, sizeof(items[i].object->revision));
+        hash = Renderer_Hash(hash, glm::value_ptr(items[i].model), sizeof(glm::mat4));
+        hash = Renderer_Hash(hash, &items[i].texture, sizeof(items[i].texture));
+    }
+
+    return hash;
+}
+
+// Passo opaco: sem blending, na ordem de "items" (de frente para trás). No
+// caminho multi-draw indirect a ordem é mantida, já que os comandos são
+// executados pela GPU na ordem em que aparecem no buffer.
+static void Renderer_DrawOpaque(const std::vector<SortedDrawItem>& items, const glm::mat4& view, const glm::mat4& projection)
+{
+    // Vetores estáticos: mantém a memória alocada entre quadros.
+    static std::vector<const SortedDrawItem*> ordered;
+    static std::vector<const SortedDrawItem*> leftover;
+    ordered.clear();
+    leftover.clear();
+
+    for (size_t i = 0; i < items.size(); ++i)
+        ordered.push_back(&items[i]);
+
+    if (g_RendererMultiDrawIndirect)
+    {
+        Renderer_DrawItemsMultiDraw(ordered, view, projection, leftover);
+        Renderer_DrawItemsIndividually(g_RendererProgram, leftover, view, projection);
+    }
+    else
+    {
+        Renderer_DrawItemsIndividually(g_RendererProgram, ordered, view, projection);
+    }
+}
+
+void Renderer_DrawScene(const std::vector<DrawItem>& items, const glm::mat4& view, const glm::mat4& projection)
+{
+    // Vetores estáticos: mantém a memória alocada entre quadros.
+    static std::vector<SortedDrawItem> opaque;
+    static std::vector<SortedDrawItem> static_opaque;
+    static std::vector<unsigned char> visible;
+    static std::vector<ImpostorInstance> impostors;
+    impostors.clear();
+    opaque.clear();
+    static_opaque.clear();
+    g_RendererTransparent.clear();
+
+    glm::mat4 view_projection = projection * view;
+    Frustum frustum = Culling_ExtractFrustum(view_projection);
+
+    g_RendererStats.visible_meshlets = 0;
+    g_RendererStats.culled_meshlets  = 0;
+    g_RendererStats.triangles        = 0;
+    g_RendererStats.impostors        = 0;
+    g_RendererRanges.clear();
+
+    Renderer_CullItems(items, frustum, visible);
+
+    // Descarte por oclusão: os oclusores visíveis são rasterizados no buffer
+    // de profundidade da CPU, e cada objeto é testado contra ele abaixo.
+    Occlusion_Begin(view_projection);
+    for (size_t i = 0; i < items.size(); ++i)
+        if (visible[i] && items[i].occluder && items[i].pass == RENDER_PASS_OPAQUE)
+            Occlusion_AddOccluder(*items[i].object, items[i].model);
+    Occlusion_Rasterize();
+    g_RendererStats.occluded_objects = 0;
+
+    // Camada estática: enquanto a câmera e os objetos estáticos não mudam,
+    // estes (e o céu) são copiados de um cache em vez de desenhados.
+    LayerCacheState layer = LayerCache_Begin(Renderer_StaticLayerKey(items, view, projection));
+    g_RendererStats.cached_objects = 0;
+
+    // Posição da câmera em coordenadas globais, para o descarte de meshlets
+    // de costas para a câmera. Na projeção ortográfica não há um centro de
+    // projeção, e este descarte não é feito.
+    glm::vec3 camera_position = glm::vec3(glm::inverse(view)[3]);
+    bool perspective = projection[2][3] != 0.0f;
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        if (!visible[i])
+            continue;
+
+        bool cached = layer != LAYER_CACHE_DISABLED && Renderer_IsCacheable(items[i]);
+        if (cached && layer == LAYER_CACHE_REUSE)
+        {
+            g_RendererStats.cached_objects += 1;
+            continue;
+        }
+
+        // Os objetos da camada estática não são testados contra os
+        // oclusores: um oclusor dinâmico poderia sair da frente deles
+        // enquanto o cache é reutilizado.
+        if (!cached && !Occlusion_TestBox(items[i].object->bbox_min, items[i].object->bbox_max, items[i].model))
+        {
+            g_RendererStats.visible_objects  -= 1;
+            g_RendererStats.occluded_objects += 1;
+            continue;
+        }
+
+        // Distância, ao longo do eixo de visão, da origem do sistema de
+        // coordenadas local do objeto até a câmera. Lembre-se que a câmera
+        // olha no sentido -z do seu sistema de coordenadas.
+        glm::vec4 origin_camera = view * items[i].model[3];
+        SortedDrawItem sorted = { -origin_camera.z, &items[i], 0, 0, 0.0f };
+
+        float projected_radius = Renderer_ProjectedRadius(items[i], view_projection, projection);
+
+        // Objetos opacos distantes: impostor no lugar do objeto, ou os dois
+        // durante a transição.
+        if (items[i].impostor && items[i].pass == RENDER_PASS_OPAQUE && projected_radius >= 0.0f)
+        {
+            sorted.impostor_fade = Impostor_Fade(projected_radius);
+            if (sorted.impostor_fade > 0.0f)
+            {
+                ImpostorInstance instance = { items[i].impostor, items[i].model, sorted.impostor_fade };
+                impostors.push_back(instance);
+                g_RendererStats.impostors += 1;
+            }
+            if (sorted.impostor_fade >= 1.0f)
+                continue;
+        }
+
+        // Objetos transparentes mostram as faces de trás: nelas só é feito o
+        // descarte por frustum.
+        bool cone_culling = perspective && items[i].pass == RENDER_PASS_OPAQUE;
+        unsigned int lod = Renderer_SelectLod(items[i], projected_radius);
+        Renderer_CullMeshlets(items[i], lod, frustum, cone_culling ? &camera_position : NULL, &sorted);
+        if (sorted.num_ranges == 0)
+            continue;
+
+        if (cached)
+        {
+            static_opaque.push_back(sorted);
+            g_RendererStats.cached_objects += 1;
+            continue;
+        }
+
+        switch (items[i].pass)
+        {
+            case RENDER_PASS_OPAQUE:      opaque.push_back(sorted); break;
+            case RENDER_PASS_TRANSPARENT: g_RendererTransparent.push_back(sorted); break;
+        }
+    }
+
+    std::sort(opaque.begin(), opaque.end(), Renderer_FrontToBack);
+    std::sort(static_opaque.begin(), static_opaque.end(), Renderer_FrontToBack);
+
+    glDisable(GL_BLEND);
+
+    // Camada estática: objetos estáticos e céu, desenhados no cache quando
+    // este precisa ser reconstruído, e copiados para o destino.
+    if (layer == LAYER_CACHE_REBUILD)
+    {
+        LayerCache_BeginRebuild();
+        Renderer_DrawOpaque(static_opaque, view, projection);
+        Skybox_Draw(view, projection);
+    }
+    if (layer != LAYER_CACHE_DISABLED)
+        LayerCache_Blit();
+
+    // Objetos opacos dinâmicos (ou todos, sem o cache), sobre a profundidade
+    // da camada estática.
+    Renderer_DrawOpaque(opaque, view, projection);
+    Impostor_Draw(impostors, view, projection);
+
+    // Céu: após todos os objetos opacos, ainda sem blending. Com o cache,
+    // já faz parte da camada estática.
+    if (layer == LAYER_CACHE_DISABLED)
+        Skybox_Draw(view, projection);
+}
+
+void Renderer_DrawTransparent(const glm::mat4& view, const glm::mat4& projection)
+{
+    // Vetor estático: mantém a memória alocada entre quadros.
+    static std::vector<const SortedDrawItem*> unordered;
+    unordered.clear();
+
+    for (size_t i = 0; i < g_RendererTransparent.size(); ++i)
+        unordered.push_back(&g_RendererTransparent[i]);
+
+    Renderer_DrawItemsIndividually(g_RendererOitProgram, unordered, view, projection);
+}
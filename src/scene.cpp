@@ -0,0 +1,65 @@
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+#include "scene.h"
+
+SceneGeometry g_SceneGeometry;
+SceneMeshlets g_SceneMeshlets;
+
+void SceneGeometry_Append(const std::vector<float>& model_coefficients,
+                          const std::vector<float>& texture_coefficients,
+                          const std::vector<GLuint>& indices,
+                          GLint* base_vertex, GLuint* first_index)
+{
+    size_t num_vertices = model_coefficients.size() / 4;
+
+    *base_vertex = (GLint)(g_SceneGeometry.model_coefficients.size() / 4);
+    *first_index = (GLuint)g_SceneGeometry.indices.size();
+
+    g_SceneGeometry.model_coefficients.insert(g_SceneGeometry.model_coefficients.end(),
+                                              model_coefficients.begin(), model_coefficients.end());
+
+    // Todos os vértices do VAO unificado precisam de coordenadas de textura,
+    // mesmo que o modelo original não as possua.
+    if (texture_coefficients.size() == 2 * num_vertices)
+        g_SceneGeometry.texture_coefficients.insert(g_SceneGeometry.texture_coefficients.end(),
+                                                    texture_coefficients.begin(), texture_coefficients.end());
+    else
+        g_SceneGeometry.texture_coefficients.resize(g_SceneGeometry.texture_coefficients.size() + 2 * num_vertices, 0.0f);
+
+    g_SceneGeometry.indices.insert(g_SceneGeometry.indices.end(), indices.begin(), indices.end());
+}
+
+void SceneObject_ComputeBounds(SceneObject* object, const float* model_coefficients,
+                               const GLuint* indices, size_t num_indices)
+{
+    glm::vec3 bbox_min( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    glm::vec3 bbox_max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+    for (size_t i = 0; i < num_indices; ++i)
+    {
+        const float* v = &model_coefficients[4 * indices[i]];
+        bbox_min = glm::vec3(std::min(bbox_min.x, v[0]), std::min(bbox_min.y, v[1]), std::min(bbox_min.z, v[2]));
+        bbox_max = glm::vec3(std::max(bbox_max.x, v[0]), std::max(bbox_max.y, v[1]), std::max(bbox_max.z, v[2]));
+    }
+
+    if (num_indices == 0)
+        bbox_min = bbox_max = glm::vec3(0.0f, 0.0f, 0.0f);
+
+    // Esfera centrada na AABB, com raio igual à distância até o vértice mais
+    // afastado do centro.
+    glm::vec3 center = 0.5f * (bbox_min + bbox_max);
+    float radius2 = 0.0f;
+    for (size_t i = 0; i < num_indices; ++i)
+    {
+        const float* v = &model_coefficients[4 * indices[i]];
+        glm::vec3 d(v[0] - center.x, v[1] - center.y, v[2] - center.z);
+        radius2 = std::max(radius2, d.x*d.x + d.y*d.y + d.z*d.z);
+    }
+
+    object->bbox_min       = bbox_min;
+    object->bbox_max       = bbox_max;
+    object->bsphere_center = center;
+    object->bsphere_radius = std::sqrt(radius2);
+}
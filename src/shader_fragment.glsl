@@ -12,8 +12,30 @@ out vec4 color;
 // Textura
 uniform sampler2D gSampler;
 
+// Frao dos pixels deste objeto desenhada pelo seu impostor, durante a
+// transio entre os dois (veja "impostor.cpp"). 0.0: objeto inteiro.
+uniform float impostor_fade;
+
+// Limiar de "dithering" ordenado do pixel, em (0, 1): matriz de Bayer 4x4.
+// Deve ser igual a DitherThreshold() em "shader_fragment_impostor.glsl" e
+// "shader_fragment_mdi.glsl".
+float DitherThreshold()
+{
+    const float bayer[16] = float[16]( 0.0,  8.0,  2.0, 10.0,
+                                      12.0,  4.0, 14.0,  6.0,
+                                       3.0, 11.0,  1.0,  9.0,
+                                      15.0,  7.0, 13.0,  5.0);
+    ivec2 p = ivec2(gl_FragCoord.xy) & 3;
+    return (bayer[4 * p.y + p.x] + 0.5) / 16.0;
+}
+
 void main()
 {
+    // Pixels desenhados pelo impostor (complemento dos descartados em
+    // "shader_fragment_impostor.glsl").
+    if (DitherThreshold() < impostor_fade)
+        discard;
+
     // Definimos a cor final de cada fragmento utilizando a cor interpolada
     // pelo rasterizador.
     color = texture2D(gSampler, TexCoord0);
@@ -0,0 +1,43 @@
+#version 330 core
+
+// Fragment shader dos impostores. Veja "impostor.cpp".
+
+in vec2 TexCoord0;
+
+// O valor de saída ("out") de um Fragment Shader é a cor final do fragmento.
+out vec4 color;
+
+// Atlas com as imagens do objeto
+uniform sampler2D gAtlas;
+
+// Fração dos pixels desenhada pelo impostor. Os demais são desenhados pelo
+// objeto original (veja "shader_fragment.glsl").
+uniform float impostor_fade;
+
+// Limiar de "dithering" ordenado do pixel, em (0, 1): matriz de Bayer 4x4.
+// Deve ser igual a DitherThreshold() em "shader_fragment.glsl".
+float DitherThreshold()
+{
+    const float bayer[16] = float[16]( 0.0,  8.0,  2.0, 10.0,
+                                      12.0,  4.0, 14.0,  6.0,
+                                       3.0, 11.0,  1.0,  9.0,
+                                      15.0,  7.0, 13.0,  5.0);
+    ivec2 p = ivec2(gl_FragCoord.xy) & 3;
+    return (bayer[4 * p.y + p.x] + 0.5) / 16.0;
+}
+
+void main()
+{
+    if (DitherThreshold() >= impostor_fade)
+        discard;
+
+    color = texture(gAtlas, TexCoord0);
+
+    // Fora do objeto o atlas é transparente.
+    if (color.a < 0.5)
+        discard;
+
+    // A filtragem mistura as bordas do objeto com o fundo (0, 0, 0, 0),
+    // escurecendo a cor; dividindo pelo alfa recuperamos a cor original.
+    color = vec4(color.rgb / color.a, 1.0);
+}
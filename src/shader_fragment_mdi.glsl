@@ -0,0 +1,48 @@
+#version 430 core
+
+// Fragment shader do caminho de renderização com multi-draw indirect. Veja
+// "renderer.cpp" e "shader_vertex_mdi.glsl".
+
+#define MAX_TEXTURE_SLOTS 16
+
+in vec2 TexCoord0;
+flat in uint TextureSlot;
+flat in float ImpostorFade;
+
+// O valor de saída ("out") de um Fragment Shader é a cor final do fragmento.
+out vec4 color;
+
+// Texturas de todos os objetos desenhados na mesma chamada, uma por unidade
+// de textura.
+uniform sampler2D gSamplers[MAX_TEXTURE_SLOTS];
+
+// Limiar de "dithering" ordenado do pixel. Igual a DitherThreshold() em
+// "shader_fragment.glsl".
+float DitherThreshold()
+{
+    const float bayer[16] = float[16]( 0.0,  8.0,  2.0, 10.0,
+                                      12.0,  4.0, 14.0,  6.0,
+                                       3.0, 11.0,  1.0,  9.0,
+                                      15.0,  7.0, 13.0,  5.0);
+    ivec2 p = ivec2(gl_FragCoord.xy) & 3;
+    return (bayer[4 * p.y + p.x] + 0.5) / 16.0;
+}
+
+void main()
+{
+    // Transição para o impostor (veja "shader_fragment.glsl").
+    if (DitherThreshold() < ImpostorFade)
+        discard;
+
+    // Um array de samplers só pode ser indexado por expressões uniformes. O
+    // índice do laço abaixo é uniforme, e TextureSlot é comparado com ele.
+    // As derivadas são calculadas fora do "if" para que a escolha do nível
+    // de mipmap continue correta.
+    vec2 dx = dFdx(TexCoord0);
+    vec2 dy = dFdy(TexCoord0);
+
+    color = vec4(0.0, 0.0, 0.0, 1.0);
+    for (int i = 0; i < MAX_TEXTURE_SLOTS; ++i)
+        if (uint(i) == TextureSlot)
+            color = textureGrad(gSamplers[i], TexCoord0, dx, dy);
+}
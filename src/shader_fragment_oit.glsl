@@ -0,0 +1,36 @@
+#version 330 core
+
+// Fragment shader dos objetos transparentes: acumulação da transparência
+// independente de ordem ("weighted blended order-independent transparency").
+// Usado com "shader_vertex.glsl". Veja "oit.cpp".
+
+in vec2 TexCoord0;
+
+// Saídas, uma para cada textura do framebuffer de acumulação. Com o blending
+// definido por Oit_BeginAccumulation():
+//   accum.rgb  soma Σ cor * alfa * peso
+//   accum.a    multiplica Π (1 - alfa), a fração do fundo que continua visível
+//   weight.r   soma Σ alfa * peso
+layout (location = 0) out vec4 accum;
+layout (location = 1) out vec4 weight;
+
+// Textura
+uniform sampler2D gSampler;
+
+// Opacidade do objeto, em [0, 1].
+uniform float opacity;
+
+void main()
+{
+    vec4 color = texture(gSampler, TexCoord0);
+    float alpha = color.a * opacity;
+
+    // Peso pela profundidade (McGuire e Bavoil, 2013, equação 10, com a
+    // profundidade do Z-buffer): superfícies mais próximas da câmera dominam
+    // a média das cores. Os limites evitam estouro na textura de 16 bits.
+    float z = gl_FragCoord.z;
+    float w = alpha * clamp(3e3 * pow(1.0 - z, 3.0), 1e-2, 3e3);
+
+    accum  = vec4(color.rgb * alpha * w, alpha);
+    weight = vec4(alpha * w, 0.0, 0.0, 0.0);
+}
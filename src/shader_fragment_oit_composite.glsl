@@ -0,0 +1,30 @@
+#version 330 core
+
+// Fragment shader da composição da transparência independente de ordem:
+// combina as texturas de acumulação sobre a cena opaca. Veja "oit.cpp".
+
+// O valor de saída ("out") de um Fragment Shader é a cor final do fragmento,
+// misturada à cena com glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA).
+out vec4 color;
+
+// Texturas de acumulação. Veja "shader_fragment_oit.glsl".
+uniform sampler2D gAccumSampler;
+uniform sampler2D gWeightSampler;
+
+void main()
+{
+    // O viewport da cena começa na origem das texturas: o pixel da tela é o
+    // mesmo texel.
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    vec4 accum = texelFetch(gAccumSampler, texel, 0);
+    float revealage = accum.a;
+
+    // Nenhuma superfície transparente neste pixel.
+    if (revealage >= 1.0)
+        discard;
+
+    float weight = texelFetch(gWeightSampler, texel, 0).r;
+    vec3 average = accum.rgb / max(weight, 1e-5);
+
+    color = vec4(average, 1.0 - revealage);
+}
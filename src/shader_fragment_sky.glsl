@@ -0,0 +1,16 @@
+#version 330 core
+
+// Fragment shader do céu. Veja "skybox.cpp".
+
+in vec3 direction;
+
+// O valor de saída ("out") de um Fragment Shader é a cor final do fragmento.
+out vec4 color;
+
+// Textura do céu
+uniform samplerCube gSkySampler;
+
+void main()
+{
+    color = texture(gSkySampler, direction);
+}
@@ -0,0 +1,32 @@
+#version 330 core
+
+// Vertex shader dos impostores. Veja "impostor.cpp".
+
+// Vértice do retângulo, entre (-1,-1) e (1,1).
+layout (location = 0) in vec2 corner;
+
+// Texturas
+out vec2 TexCoord0;
+
+// Matrizes computadas no código C++ e enviadas para a GPU
+uniform mat4 view;
+uniform mat4 projection;
+
+// Retângulo voltado para a câmera: centro e raio da esfera envolvente do
+// objeto, e eixos do retângulo, em coordenadas globais.
+uniform vec3  center;
+uniform float radius;
+uniform vec3  right;
+uniform vec3  up;
+
+// Célula do atlas com a imagem do objeto: canto inferior esquerdo (xy) e
+// tamanho (zw), em coordenadas de textura.
+uniform vec4 cell;
+
+void main()
+{
+    vec3 position = center + radius * (corner.x * right + corner.y * up);
+    gl_Position = projection * view * vec4(position, 1.0);
+
+    TexCoord0 = cell.xy + (0.5 * corner + 0.5) * cell.zw;
+}
@@ -0,0 +1,46 @@
+#version 430 core
+
+// Vertex shader do caminho de renderização com multi-draw indirect. Veja
+// "renderer.cpp". Equivalente a "shader_vertex.glsl", porém a matriz "model"
+// de cada objeto é lida de um buffer na GPU, e não de uma variável uniform.
+
+// Atributos de vértice do VAO unificado (g_SceneGeometry).
+layout (location = 0) in vec4 model_coefficients;
+layout (location = 1) in vec2 TexCoord;
+
+// Índice do objeto sendo desenhado. Atributo por instância, cujo valor é o
+// "baseInstance" do comando de desenho.
+layout (location = 2) in uint draw_id;
+
+// Dados de cada objeto, escritos por Renderer_DrawScene().
+struct ObjectData
+{
+    mat4  model;
+    uint  texture_slot;  // Posição da textura do objeto em gSamplers[]
+    float impostor_fade; // Veja "shader_fragment.glsl"
+    uint  padding0;
+    uint  padding1;
+};
+
+layout (std430, binding = 0) readonly buffer Objects
+{
+    ObjectData objects[];
+};
+
+// Texturas
+out vec2 TexCoord0;
+flat out uint TextureSlot;
+flat out float ImpostorFade;
+
+// Matrizes computadas no código C++ e enviadas para a GPU
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    gl_Position = projection * view * objects[draw_id].model * model_coefficients;
+
+    TexCoord0 = TexCoord;
+    TextureSlot = objects[draw_id].texture_slot;
+    ImpostorFade = objects[draw_id].impostor_fade;
+}
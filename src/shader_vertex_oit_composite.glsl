@@ -0,0 +1,13 @@
+#version 330 core
+
+// Vertex shader da composição da transparência independente de ordem. Veja
+// "oit.cpp".
+//
+// Não há atributos de vértice: os três vértices de um triângulo que cobre o
+// viewport inteiro são calculados a partir de gl_VertexID.
+
+void main()
+{
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
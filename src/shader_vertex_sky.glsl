@@ -0,0 +1,25 @@
+#version 330 core
+
+// Vertex shader do céu. Veja "skybox.cpp".
+
+// Atributos de vértice recebidos como entrada ("in") pelo Vertex Shader.
+layout (location = 0) in vec4 model_coefficients;
+
+// Direção, a partir da câmera, usada para buscar a cor no cubemap.
+out vec3 direction;
+
+// Matrizes computadas no código C++ e enviadas para a GPU. A matriz "view"
+// não possui translação.
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    direction = model_coefficients.xyz;
+
+    vec4 position = projection * view * vec4(model_coefficients.xyz, 1.0);
+
+    // Após a divisão por w, z/w = w/w = 1.0: o vértice fica sobre o far
+    // plane, atrás de toda a cena.
+    gl_Position = position.xyww;
+}
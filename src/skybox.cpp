@@ -0,0 +1,168 @@
+// Céu da cena (skybox).
+//
+// O céu é um cubo centrado na câmera: removemos a translação da matriz
+// "view", de forma que somente a orientação da câmera importa, e o vertex
+// shader força a profundidade de todos os vértices para o far plane
+// (gl_Position.z = gl_Position.w). Assim, desenhando o céu DEPOIS dos objetos
+// opacos, com glDepthFunc(GL_LEQUAL), o teste de profundidade descarta todos
+// os pixels já cobertos pela cena, e só os pixels de céu visíveis executam o
+// fragment shader. O céu também deixa de depender da distância do far plane.
+#include <cstdio>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/mat3x3.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "gl_debug.h"
+#include "gl_state.h"
+#include "skybox.h"
+
+// Funções definidas em main.cpp
+GLuint LoadShader_Vertex(const char* filename);
+GLuint LoadShader_Fragment(const char* filename);
+GLuint CreateGpuProgram(GLuint vertex_shader_id, GLuint fragment_shader_id);
+unsigned char* Load_BMP(const char* file_path, unsigned int* width, unsigned int* height);
+
+GLuint g_SkyboxProgramId = 0;
+GLint  g_SkyboxViewUniform;
+GLint  g_SkyboxProjectionUniform;
+GLuint g_SkyboxVAO;
+GLuint g_SkyboxTexture;
+
+// Constrói o cubo do céu: 8 vértices e 12 triângulos. As coordenadas de cada
+// vértice são também a direção usada para buscar a cor no cubemap.
+static void Skybox_BuildCube()
+{
+    GLfloat model_coefficients[] = {
+        //    X      Y      Z     W
+           -1.0f, -1.0f, -1.0f,  1.0f, // vértice 0
+            1.0f, -1.0f, -1.0f,  1.0f, // vértice 1
+           -1.0f,  1.0f, -1.0f,  1.0f, // vértice 2
+            1.0f,  1.0f, -1.0f,  1.0f, // vértice 3
+           -1.0f, -1.0f,  1.0f,  1.0f, // vértice 4
+            1.0f, -1.0f,  1.0f,  1.0f, // vértice 5
+           -1.0f,  1.0f,  1.0f,  1.0f, // vértice 6
+            1.0f,  1.0f,  1.0f,  1.0f, // vértice 7
+    };
+
+    GLuint indices[] = {
+        0, 1, 2,   1, 3, 2, // face -Z
+        4, 6, 5,   5, 6, 7, // face +Z
+        0, 2, 4,   4, 2, 6, // face -X
+        1, 5, 3,   5, 7, 3, // face +X
+        0, 4, 1,   1, 4, 5, // face -Y
+        2, 3, 6,   3, 7, 6, // face +Y
+    };
+
+    glGenVertexArrays(1, &g_SkyboxVAO);
+    glBindVertexArray(g_SkyboxVAO);
+
+    GLuint VBO_model_coefficients_id;
+    glGenBuffers(1, &VBO_model_coefficients_id);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO_model_coefficients_id);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(model_coefficients), model_coefficients, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 0, 0); // "(location = 0)" em "shader_vertex_sky.glsl"
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    GLuint indices_id;
+    glGenBuffers(1, &indices_id);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices_id);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+}
+
+// Carrega as seis faces do cubemap a partir de arquivos BMP.
+static GLuint Skybox_LoadCubemap(const char* const face_paths[6])
+{
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+
+    for (int face = 0; face < 6; ++face)
+    {
+        unsigned int width, height;
+        unsigned char* data = Load_BMP(face_paths[face], &width, &height);
+        if (!data)
+            continue;
+
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_RGB, width, height, 0, GL_BGR, GL_UNSIGNED_BYTE, data);
+        delete [] data;
+    }
+
+    // A densidade de texels do céu é próxima de um texel por pixel, então
+    // não é necessário mipmapping.
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+    return textureID;
+}
+
+void Skybox_Init(const char* const face_paths[6])
+{
+    GLuint vertex_shader_id   = LoadShader_Vertex("../src/shader_vertex_sky.glsl");
+    GLuint fragment_shader_id = LoadShader_Fragment("../src/shader_fragment_sky.glsl");
+    g_SkyboxProgramId         = CreateGpuProgram(vertex_shader_id, fragment_shader_id);
+    GLDebug_Label(GL_PROGRAM, g_SkyboxProgramId, "skybox");
+
+    g_SkyboxViewUniform       = glGetUniformLocation(g_SkyboxProgramId, "view");
+    g_SkyboxProjectionUniform = glGetUniformLocation(g_SkyboxProgramId, "projection");
+
+    glUseProgram(g_SkyboxProgramId);
+    glUniform1i(glGetUniformLocation(g_SkyboxProgramId, "gSkySampler"), 0);
+    glUseProgram(0);
+
+    Skybox_BuildCube();
+    g_SkyboxTexture = Skybox_LoadCubemap(face_paths);
+}
+
+void Skybox_Draw(const glm::mat4& view, const glm::mat4& projection)
+{
+    if (g_SkyboxProgramId == 0)
+        return;
+
+    // Removemos a translação da matriz "view": o céu acompanha a câmera.
+    glm::mat4 sky_view = glm::mat4(glm::mat3(view));
+
+    // Em projeção ortográfica todas as direções de visão são paralelas, e o
+    // céu seria uma única cor. Usamos então uma projeção perspectiva com a
+    // mesma razão de aspecto somente para o céu. Na matriz perspectiva a
+    // última linha é (0, 0, -1, 0); na ortográfica, (0, 0, 0, 1).
+    glm::mat4 sky_projection = projection;
+    if (projection[2][3] == 0.0f)
+    {
+        float aspect = projection[1][1] / projection[0][0];
+        sky_projection = glm::perspective(3.141592f / 3.0f, aspect, 0.1f, 10.0f);
+    }
+
+    glUseProgram(g_SkyboxProgramId);
+    glUniformMatrix4fv(g_SkyboxViewUniform       , 1 , GL_FALSE , glm::value_ptr(sky_view));
+    glUniformMatrix4fv(g_SkyboxProjectionUniform , 1 , GL_FALSE , glm::value_ptr(sky_projection));
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, g_SkyboxTexture);
+
+    // O céu tem profundidade igual à do far plane (1.0), a mesma com que o
+    // Z-buffer é limpo; por isso GL_LEQUAL. Não há necessidade de escrever no
+    // Z-buffer.
+    glDepthFunc(GL_LEQUAL);
+    glDepthMask(GL_FALSE);
+
+    glBindVertexArray(g_SkyboxVAO);
+    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+
+    glDepthMask(GL_TRUE);
+    glDepthFunc(GL_LESS);
+
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+}
@@ -0,0 +1,392 @@
+// Resolvedor de níveis.
+//
+// Estados: o bloco na célula (x, z) com a orientação o tem o índice
+// (z * largura + x) * 3 + o. Índices de estados inválidos (bloco fora do
+// chão) existem, mas nunca são visitados.
+//
+// Cada movimento tem um inverso (esquerda e direita, cima e baixo), então o
+// grafo de estados não é orientado e a busca a partir da saída usa os mesmos
+// movimentos que a busca a partir do início. As duas buscas guardam, por
+// estado, um bit de "visitado" e os 2 bits da direção pela qual o estado foi
+// alcançado, em palavras de 64 bits atualizadas com fetch_or() atômico: um
+// nível de 4096 x 4096 células precisa de cerca de 19 MB por busca.
+//
+// A cada rodada, a busca com a menor fronteira expande uma camada inteira.
+// Cada estado novo é comparado com os visitados pela outra busca; na
+// primeira camada com um encontro, todo encontro dá um caminho mínimo: se o
+// menor caminho tivesse comprimento menor que df + 1 + db (as profundidades
+// das duas buscas), algum estado dele já teria sido visitado pelas duas, e o
+// encontro teria acontecido antes.
+//
+// Camadas grandes são divididas em blocos de SOLVER_CHUNK_SIZE estados,
+// expandidos em paralelo; cada bloco escreve a sua parte da próxima camada,
+// e as partes são concatenadas ao final.
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+#include "solver.h"
+#include "thread_pool.h"
+
+// Estados da fronteira expandidos por tarefa.
+#define SOLVER_CHUNK_SIZE 4096
+
+// Índice do estado ainda não encontrado.
+#define SOLVER_NONE 0xFFFFFFFFu
+
+// Movimento inverso de cada direção.
+static const int g_SolverInverse[BLOCK_NUM_DIRECTIONS] = { BLOCK_RIGHT, BLOCK_LEFT, BLOCK_DOWN, BLOCK_UP };
+
+// Conjunto de estados visitados por uma busca, e a direção que levou a cada
+// um (a partir do estado anterior da mesma busca).
+struct SolverSearch
+{
+    size_t num_words_visited;
+    std::unique_ptr<std::atomic<uint64_t>[]> visited;   // 1 bit por estado
+    std::unique_ptr<std::atomic<uint64_t>[]> direction; // 2 bits por estado
+    std::vector<uint32_t> frontier;
+
+    explicit SolverSearch(size_t num_states)
+        : num_words_visited((num_states + 63) / 64),
+          visited(new std::atomic<uint64_t>[(num_states + 63) / 64]),
+          direction(new std::atomic<uint64_t>[(num_states + 31) / 32])
+    {
+        for (size_t i = 0; i < num_words_visited; ++i)
+            visited[i].store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < (num_states + 31) / 32; ++i)
+            direction[i].store(0, std::memory_order_relaxed);
+    }
+
+    bool is_visited(uint32_t s) const
+    {
+        return (visited[s / 64].load(std::memory_order_relaxed) >> (s % 64)) & 1;
+    }
+
+    // Marca o estado como visitado. Retorna false se já estava (possivelmente
+    // marcado por outra thread ao mesmo tempo).
+    bool visit(uint32_t s, int dir)
+    {
+        uint64_t bit = 1ull << (s % 64);
+        if (visited[s / 64].fetch_or(bit, std::memory_order_relaxed) & bit)
+            return false;
+        direction[s / 32].fetch_or((uint64_t)dir << (2 * (s % 32)), std::memory_order_relaxed);
+        return true;
+    }
+
+    int get_direction(uint32_t s) const
+    {
+        return (int)((direction[s / 32].load(std::memory_order_relaxed) >> (2 * (s % 32))) & 3);
+    }
+};
+
+static inline bool Solver_IsValid(const Level* level, BlockState state)
+{
+    int cells_x[2], cells_z[2];
+    int count = Block_GetCells(state, cells_x, cells_z);
+    for (int i = 0; i < count; ++i)
+        if (!Level_IsSolid(level, cells_x[i], cells_z[i]))
+            return false;
+    return true;
+}
+
+static inline uint32_t Solver_Index(const Level* level, BlockState state)
+{
+    return ((uint32_t)state.z * (uint32_t)level->width + (uint32_t)state.x) * BLOCK_NUM_ORIENTATIONS + (uint32_t)state.orientation;
+}
+
+static inline BlockState Solver_State(const Level* level, uint32_t index)
+{
+    uint32_t cell = index / BLOCK_NUM_ORIENTATIONS;
+    return BlockState{ (int)(cell % (uint32_t)level->width), (int)(cell / (uint32_t)level->width),
+                       (BlockOrientation)(index % BLOCK_NUM_ORIENTATIONS) };
+}
+
+// Expande os estados [first, last) da fronteira de "search" para "next".
+// Guarda em "*meeting" um estado também visitado por "other", se houver.
+static void Solver_Expand(const Level* level, SolverSearch& search, const SolverSearch& other,
+                          size_t first, size_t last, std::vector<uint32_t>& next, std::atomic<uint32_t>* meeting)
+{
+    for (size_t i = first; i < last; ++i)
+    {
+        BlockState state = Solver_State(level, search.frontier[i]);
+        for (int dir = 0; dir < BLOCK_NUM_DIRECTIONS; ++dir)
+        {
+            BlockState neighbor = Block_Move(state, (BlockDirection)dir);
+            if (!Solver_IsValid(level, neighbor))
+                continue;
+
+            uint32_t index = Solver_Index(level, neighbor);
+            if (!search.visit(index, dir))
+                continue;
+
+            next.push_back(index);
+            if (other.is_visited(index))
+                meeting->store(index, std::memory_order_relaxed);
+        }
+    }
+}
+
+// Substitui "frontier" pela próxima camada, escrita por
+// expand(first, last, next) a partir dos estados [first, last) da atual. Com
+// "parallel", camadas grandes são divididas em blocos expandidos pelas
+// threads do conjunto.
+static void Solver_NextLayer(std::vector<uint32_t>& frontier, bool parallel,
+                             const std::function<void(size_t first, size_t last, std::vector<uint32_t>& next)>& expand)
+{
+    size_t count = frontier.size();
+    size_t num_chunks = (count + SOLVER_CHUNK_SIZE - 1) / SOLVER_CHUNK_SIZE;
+
+    std::vector<uint32_t> next;
+    if (!parallel || num_chunks <= 1)
+    {
+        expand(0, count, next);
+    }
+    else
+    {
+        std::vector< std::vector<uint32_t> > parts(num_chunks);
+        ThreadPool_ParallelFor(num_chunks, [&](size_t c) {
+            size_t first = c * SOLVER_CHUNK_SIZE;
+            expand(first, std::min(first + SOLVER_CHUNK_SIZE, count), parts[c]);
+        });
+
+        size_t total = 0;
+        for (size_t c = 0; c < num_chunks; ++c)
+            total += parts[c].size();
+        next.reserve(total);
+        for (size_t c = 0; c < num_chunks; ++c)
+            next.insert(next.end(), parts[c].begin(), parts[c].end());
+    }
+
+    frontier.swap(next);
+}
+
+// Expande uma camada inteira de "search". Retorna um estado de encontro com
+// "other", ou SOLVER_NONE.
+static uint32_t Solver_ExpandLayer(const Level* level, SolverSearch& search, const SolverSearch& other, bool parallel)
+{
+    std::atomic<uint32_t> meeting(SOLVER_NONE);
+    Solver_NextLayer(search.frontier, parallel, [&](size_t first, size_t last, std::vector<uint32_t>& next) {
+        Solver_Expand(level, search, other, first, last, next, &meeting);
+    });
+    return meeting.load(std::memory_order_relaxed);
+}
+
+// Direções que levam da origem de "search" até "index", na ordem em que são
+// aplicadas.
+static void Solver_Trace(const Level* level, const SolverSearch& search, uint32_t origin, uint32_t index, std::vector<int>* moves)
+{
+    moves->clear();
+    while (index != origin)
+    {
+        int dir = search.get_direction(index);
+        moves->push_back(dir);
+        index = Solver_Index(level, Block_Move(Solver_State(level, index), (BlockDirection)g_SolverInverse[dir]));
+    }
+    std::reverse(moves->begin(), moves->end());
+}
+
+bool Solver_Solve(const Level* level, BlockState start, bool parallel, SolverResult* result)
+{
+    result->solvable = false;
+    result->moves.clear();
+    result->visited_states = 0;
+
+    BlockState goal = BlockState{ level->exit_x, level->exit_z, BLOCK_STANDING };
+    if (level->exit_x < 0 || !Solver_IsValid(level, start))
+        return false;
+
+    size_t num_states = (size_t)level->width * level->depth * BLOCK_NUM_ORIENTATIONS;
+    SolverSearch forward(num_states);
+    SolverSearch backward(num_states);
+
+    uint32_t start_index = Solver_Index(level, start);
+    uint32_t goal_index  = Solver_Index(level, goal);
+    forward.visit(start_index, 0);
+    forward.frontier.push_back(start_index);
+    backward.visit(goal_index, 0);
+    backward.frontier.push_back(goal_index);
+
+    uint32_t meeting = start_index == goal_index ? start_index : SOLVER_NONE;
+    size_t visited = 2;
+    while (meeting == SOLVER_NONE && !forward.frontier.empty() && !backward.frontier.empty())
+    {
+        // Expandimos a menor fronteira: o custo total fica perto de
+        // 2 * b^(d/2) estados em vez de b^d.
+        if (forward.frontier.size() <= backward.frontier.size())
+        {
+            meeting = Solver_ExpandLayer(level, forward, backward, parallel);
+            visited += forward.frontier.size();
+        }
+        else
+        {
+            meeting = Solver_ExpandLayer(level, backward, forward, parallel);
+            visited += backward.frontier.size();
+        }
+    }
+
+    result->visited_states = visited;
+    if (meeting == SOLVER_NONE)
+        return false;
+
+    // Do início até o encontro, e depois do encontro até a saída, desfazendo
+    // os movimentos da busca a partir da saída.
+    std::vector<int> backward_moves;
+    Solver_Trace(level, forward, start_index, meeting, &result->moves);
+    Solver_Trace(level, backward, goal_index, meeting, &backward_moves);
+    for (size_t i = backward_moves.size(); i-- > 0; )
+        result->moves.push_back(g_SolverInverse[backward_moves[i]]);
+
+    result->solvable = true;
+    return true;
+}
+
+int Solver_Hint(const Level* level, BlockState state)
+{
+    SolverResult result;
+    if (!Solver_Solve(level, state, false, &result) || result.moves.empty())
+        return -1;
+    return result.moves[0];
+}
+
+// Modo com tempo.
+//
+// Um nó é o par (estado, tick), com índice estado * num_ticks + tick. Cada
+// nó guarda 4 bits na palavra de 64 bits índice / 16: zero se não foi
+// visitado, ou 1 + a ação (BlockDirection ou SOLVER_WAIT) que levou a ele, ou
+// SOLVER_TIMED_START para o nó inicial. A saída pode ser alcançada em
+// qualquer tick, então a busca parte só do início, camada por camada, até a
+// primeira camada que chega à saída.
+
+// Marca do nó inicial.
+#define SOLVER_TIMED_START 0xF
+
+struct SolverTimedSearch
+{
+    const Level*       level;
+    const HazardTable* hazards;
+    std::unique_ptr<std::atomic<uint64_t>[]> nodes;
+    std::vector<uint32_t> frontier;
+
+    // Marca o nó como visitado pela ação "code". Retorna false se já estava.
+    bool visit(uint32_t node, uint64_t code)
+    {
+        std::atomic<uint64_t>& word = nodes[node / 16];
+        int shift = 4 * (node % 16);
+        uint64_t current = word.load(std::memory_order_relaxed);
+        do
+        {
+            if ((current >> shift) & 0xF)
+                return false;
+        } while (!word.compare_exchange_weak(current, current | (code << shift), std::memory_order_relaxed));
+        return true;
+    }
+
+    int get_code(uint32_t node) const
+    {
+        return (int)((nodes[node / 16].load(std::memory_order_relaxed) >> (4 * (node % 16))) & 0xF);
+    }
+};
+
+// Expande os nós [first, last) da fronteira para "next". Guarda em "*goal" um
+// nó na saída, se houver.
+static void Solver_ExpandTimed(SolverTimedSearch& search, size_t first, size_t last,
+                               std::vector<uint32_t>& next, std::atomic<uint32_t>* goal)
+{
+    const Level* level = search.level;
+    uint32_t num_ticks = (uint32_t)search.hazards->num_ticks;
+    for (size_t i = first; i < last; ++i)
+    {
+        uint32_t node = search.frontier[i];
+        BlockState state = Solver_State(level, node / num_ticks);
+        uint32_t tick = (node % num_ticks + 1) % num_ticks;
+
+        for (int action = 0; action <= SOLVER_WAIT; ++action)
+        {
+            BlockState neighbor = action == SOLVER_WAIT ? state : Block_Move(state, (BlockDirection)action);
+            if (!Solver_IsValid(level, neighbor) || HazardTable_Hits(search.hazards, (int)tick, neighbor))
+                continue;
+
+            uint32_t index = Solver_Index(level, neighbor) * num_ticks + tick;
+            if (!search.visit(index, (uint64_t)action + 1))
+                continue;
+
+            next.push_back(index);
+            if (neighbor.x == level->exit_x && neighbor.z == level->exit_z && neighbor.orientation == BLOCK_STANDING)
+                goal->store(index, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool Solver_SolveTimed(const Level* level, const HazardTable* hazards, BlockState start, int start_tick,
+                       bool parallel, SolverResult* result)
+{
+    result->solvable = false;
+    result->moves.clear();
+    result->visited_states = 0;
+
+    if (level->exit_x < 0 || !Solver_IsValid(level, start) || HazardTable_Hits(hazards, start_tick, start))
+        return false;
+
+    uint32_t num_ticks = (uint32_t)hazards->num_ticks;
+    size_t num_nodes = (size_t)level->width * level->depth * BLOCK_NUM_ORIENTATIONS * num_ticks;
+    if (num_nodes >= SOLVER_NONE)
+    {
+        fprintf(stderr, "WARNING: timed solver needs %zu nodes, more than %u.\n", num_nodes, SOLVER_NONE - 1);
+        return false;
+    }
+
+    SolverTimedSearch search;
+    search.level = level;
+    search.hazards = hazards;
+    search.nodes.reset(new std::atomic<uint64_t>[(num_nodes + 15) / 16]);
+    for (size_t i = 0; i < (num_nodes + 15) / 16; ++i)
+        search.nodes[i].store(0, std::memory_order_relaxed);
+
+    uint32_t start_node = Solver_Index(level, start) * num_ticks + (uint32_t)start_tick;
+    search.visit(start_node, SOLVER_TIMED_START);
+    search.frontier.push_back(start_node);
+
+    bool at_goal = start.x == level->exit_x && start.z == level->exit_z && start.orientation == BLOCK_STANDING;
+    uint32_t goal = at_goal ? start_node : SOLVER_NONE;
+    size_t visited = 1;
+    while (goal == SOLVER_NONE && !search.frontier.empty())
+    {
+        std::atomic<uint32_t> found(SOLVER_NONE);
+        Solver_NextLayer(search.frontier, parallel, [&](size_t first, size_t last, std::vector<uint32_t>& next) {
+            Solver_ExpandTimed(search, first, last, next, &found);
+        });
+        goal = found.load(std::memory_order_relaxed);
+        visited += search.frontier.size();
+    }
+
+    result->visited_states = visited;
+    if (goal == SOLVER_NONE)
+        return false;
+
+    // Voltamos da saída até o início, desfazendo uma ação por tick.
+    for (uint32_t node = goal; node != start_node; )
+    {
+        int action = search.get_code(node) - 1;
+        result->moves.push_back(action);
+
+        BlockState state = Solver_State(level, node / num_ticks);
+        if (action != SOLVER_WAIT)
+            state = Block_Move(state, (BlockDirection)g_SolverInverse[action]);
+        node = Solver_Index(level, state) * num_ticks + (node % num_ticks + num_ticks - 1) % num_ticks;
+    }
+    std::reverse(result->moves.begin(), result->moves.end());
+
+    result->solvable = true;
+    return true;
+}
+
+int Solver_HintTimed(const Level* level, const HazardTable* hazards, BlockState state, double time)
+{
+    SolverResult result;
+    if (!Solver_SolveTimed(level, hazards, state, HazardTable_Tick(hazards, time), false, &result) || result.moves.empty())
+        return -1;
+    return result.moves[0];
+}
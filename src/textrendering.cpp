@@ -10,6 +10,8 @@
 
 #include "utils.h"
 #include "dejavufont.h"
+#include "gl_state.h"
+#include "gl_debug.h"
 
 GLuint CreateGpuProgram(GLuint vertex_shader_id, GLuint fragment_shader_id); // Função definida em main.cpp
 
@@ -112,6 +114,7 @@ void TextRendering_Init()
     textprogram_id = CreateGpuProgram(textvertexshader_id, textfragmentshader_id);
     glLinkProgram(textprogram_id);
     glCheckError();
+    GLDebug_Label(GL_PROGRAM, textprogram_id, "text");
 
     GLuint texttex_uniform;
     texttex_uniform = glGetUniformLocation(textprogram_id, "tex");
@@ -154,6 +157,15 @@ void TextRendering_PrintString(GLFWwindow* window, const std::string &str, float
     float sx = scale / width;
     float sy = scale / height;
 
+    // Estado comum a todos os caracteres, definido uma única vez por cadeia.
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glDepthFunc(GL_ALWAYS);
+    glUseProgram(textprogram_id);
+    glBindVertexArray(textVAO);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texttexture_id);
+    glBindBuffer(GL_ARRAY_BUFFER, textVBO);
+
     for (size_t i = 0; i < str.size(); i++)
     {
         // Find the glyph for the character we are looking for
@@ -189,25 +201,17 @@ void TextRendering_PrintString(GLFWwindow* window, const std::string &str, float
             { x1, y0, s1, t0 }
         };
 
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glDepthFunc(GL_ALWAYS);
-        glBindBuffer(GL_ARRAY_BUFFER, textVBO);
         glBufferSubData(GL_ARRAY_BUFFER, 0, 24 * sizeof(float), data);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-        glUseProgram(textprogram_id);
-        glBindVertexArray(textVAO);
-        glBindTexture(GL_TEXTURE_2D, texttexture_id);
-
         glDrawArrays(GL_TRIANGLES, 0, 6);
 
-        glBindVertexArray(0);
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glUseProgram(0);
-        glDepthFunc(GL_LESS);
-
         x += (glyph->advance_x * sx);
     }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+    glDepthFunc(GL_LESS);
 }
 
 float TextRendering_LineHeight(GLFWwindow* window)
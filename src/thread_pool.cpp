@@ -0,0 +1,139 @@
+// Conjunto de threads de trabalho.
+//
+// As threads ficam bloqueadas em uma variável de condição até que
+// ThreadPool_ParallelFor() publique um novo trabalho (incrementando
+// g_ThreadPoolGeneration). Os índices do trabalho são então distribuídos por
+// um contador atômico: cada thread, incluindo a que chamou
+// ThreadPool_ParallelFor(), pega o próximo índice livre até que acabem, o
+// que equilibra a carga mesmo quando as tarefas têm custos diferentes.
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "thread_pool.h"
+
+// Alocado dinamicamente e nunca destruído por destrutores estáticos: se o
+// programa terminar com exit() sem chamar ThreadPool_Terminate(), as threads
+// não são destruídas ainda "joinable" (o que chamaria std::terminate()).
+static std::vector<std::thread>* g_ThreadPoolThreads = NULL;
+
+static std::mutex              g_ThreadPoolMutex;
+static std::condition_variable g_ThreadPoolWake;     // Sinaliza novo trabalho ou término
+static std::condition_variable g_ThreadPoolFinished; // Sinaliza fim do trabalho atual
+static unsigned long           g_ThreadPoolGeneration = 0;
+static bool                    g_ThreadPoolQuit = false;
+
+// Trabalho atual. Protegido por g_ThreadPoolMutex, exceto o contador de
+// índices.
+static const std::function<void(size_t)>* g_ThreadPoolTask = NULL;
+static size_t                             g_ThreadPoolCount = 0;
+static std::atomic<size_t>                g_ThreadPoolNextIndex(0);
+static unsigned int                       g_ThreadPoolBusy = 0; // Threads de trabalho ainda executando
+
+// Executa índices do trabalho atual até que acabem.
+static void ThreadPool_RunTasks(const std::function<void(size_t)>& task, size_t count)
+{
+    for (size_t i = g_ThreadPoolNextIndex++; i < count; i = g_ThreadPoolNextIndex++)
+        task(i);
+}
+
+static void ThreadPool_Worker()
+{
+    unsigned long generation = 0;
+
+    for (;;)
+    {
+        const std::function<void(size_t)>* task;
+        size_t count;
+        {
+            std::unique_lock<std::mutex> lock(g_ThreadPoolMutex);
+            g_ThreadPoolWake.wait(lock, [&] { return g_ThreadPoolQuit || g_ThreadPoolGeneration != generation; });
+            if (g_ThreadPoolQuit)
+                return;
+            generation = g_ThreadPoolGeneration;
+            task  = g_ThreadPoolTask;
+            count = g_ThreadPoolCount;
+        }
+
+        ThreadPool_RunTasks(*task, count);
+
+        {
+            std::lock_guard<std::mutex> lock(g_ThreadPoolMutex);
+            if (--g_ThreadPoolBusy == 0)
+                g_ThreadPoolFinished.notify_one();
+        }
+    }
+}
+
+void ThreadPool_Init(unsigned int num_threads)
+{
+    if (g_ThreadPoolThreads)
+        return;
+
+    if (num_threads == 0)
+    {
+        unsigned int cores = std::thread::hardware_concurrency();
+        num_threads = cores > 1 ? cores - 1 : 0;
+    }
+
+    g_ThreadPoolThreads = new std::vector<std::thread>();
+    for (unsigned int i = 0; i < num_threads; ++i)
+        g_ThreadPoolThreads->push_back(std::thread(ThreadPool_Worker));
+}
+
+void ThreadPool_Terminate()
+{
+    if (!g_ThreadPoolThreads)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(g_ThreadPoolMutex);
+        g_ThreadPoolQuit = true;
+    }
+    g_ThreadPoolWake.notify_all();
+
+    for (size_t i = 0; i < g_ThreadPoolThreads->size(); ++i)
+        (*g_ThreadPoolThreads)[i].join();
+
+    delete g_ThreadPoolThreads;
+    g_ThreadPoolThreads = NULL;
+    g_ThreadPoolQuit = false;
+}
+
+unsigned int ThreadPool_NumThreads()
+{
+    return 1 + (g_ThreadPoolThreads ? (unsigned int)g_ThreadPoolThreads->size() : 0);
+}
+
+void ThreadPool_ParallelFor(size_t count, const std::function<void(size_t)>& task)
+{
+    if (count == 0)
+        return;
+
+    // Poucas tarefas ou nenhuma thread: não compensa acordar ninguém.
+    if (!g_ThreadPoolThreads || g_ThreadPoolThreads->empty() || count == 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+            task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(g_ThreadPoolMutex);
+        g_ThreadPoolTask  = &task;
+        g_ThreadPoolCount = count;
+        g_ThreadPoolNextIndex = 0;
+        g_ThreadPoolBusy  = (unsigned int)g_ThreadPoolThreads->size();
+        g_ThreadPoolGeneration += 1;
+    }
+    g_ThreadPoolWake.notify_all();
+
+    ThreadPool_RunTasks(task, count);
+
+    // "task" pertence ao chamador: só retornamos depois que nenhuma thread a
+    // está usando.
+    std::unique_lock<std::mutex> lock(g_ThreadPoolMutex);
+    g_ThreadPoolFinished.wait(lock, [] { return g_ThreadPoolBusy == 0; });
+}
@@ -0,0 +1,56 @@
+// Mundo do jogo.
+//
+// Nada aqui depende de OpenGL, da GLFW ou de estado global: cada World
+// guarda todo o seu estado, e o nível é somente lido. Assim vários mundos
+// podem ser simulados ao mesmo tempo, um por thread.
+#include "collisions.h"
+#include "hazard.h"
+#include "world.h"
+
+World::World(const Level* level, const HazardSet* hazards)
+    : m_Level(level)
+{
+    if (hazards != NULL)
+        m_Hazards = *hazards;
+    else
+        HazardSet_LoadDefault(&m_Hazards);
+    reset();
+}
+
+void World::reset()
+{
+    m_Block = BlockState{ m_Level->start_x, m_Level->start_z, BLOCK_STANDING };
+    m_Time = 0.0;
+    m_Victory = false;
+    m_Failures = 0;
+    m_Moves = 0;
+    HazardSet_Update(&m_Hazards, m_Time);
+}
+
+unsigned int World::step(const WorldInput& input)
+{
+    unsigned int events = 0;
+
+    m_Time += input.dt;
+    HazardSet_Update(&m_Hazards, m_Time);
+
+    if (input.move != WORLD_NO_MOVE)
+    {
+        m_Block = Block_Move(m_Block, (BlockDirection)input.move);
+        m_Moves += 1;
+    }
+
+    if (plane_collision(m_Level, m_Block) || HazardSet_Hits(&m_Hazards, m_Block))
+    {
+        m_Block = BlockState{ m_Level->start_x, m_Level->start_z, BLOCK_STANDING };
+        m_Failures += 1;
+        events |= WORLD_EVENT_FAILED;
+    }
+
+    bool victory = victory_cube_collision(m_Level, m_Block);
+    if (victory && !m_Victory)
+        events |= WORLD_EVENT_WON;
+    m_Victory = victory;
+
+    return events;
+}